@@ -0,0 +1,31 @@
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////
+// Just enough of Arduino.h to build the queue and latency headers on a PC
+// .. Used by the PC tools in Tools/. Not part of the firmware build
+///////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+typedef uint8_t byte;
+
+using std::max;
+using std::min;
+
+///////////////////////////////////////////////////////////////////////////////
+// Time since the program started
+inline unsigned long micros()
+{
+	static const auto start = std::chrono::steady_clock::now();
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+inline unsigned long millis()
+{
+	static const auto start = std::chrono::steady_clock::now();
+	return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////
+// Minimal checks for the PC builds of the firmware headers
+// .. Each *Check.cpp in Tools/ counts failures with CHECK and returns
+// .. CheckResult() from main. Run them all with Tools/HostChecks.sh
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstdio>
+#include <vector>
+
+#include "QueueData.h"
+
+// MSM epochs of one moment in each GNSS time base. GPS and Galileo use time
+// of week, BeiDou is 14s behind and GLONASS is Moscow time of day with the day
+#define GPS_EPOCH (2 * 86400000 + 3600000)
+#define BEIDOU_EPOCH (GPS_EPOCH - 14000)
+#define GLONASS_EPOCH ((2u << 27) | (3600000 + 3 * 3600000 - 18000))
+
+static int _checks = 0;
+static int _checkFailures = 0;
+
+// Count the check and print where it failed
+#define CHECK(condition)                                                     \
+	do                                                                       \
+	{                                                                        \
+		_checks++;                                                           \
+		if (!(condition))                                                    \
+		{                                                                    \
+			_checkFailures++;                                                \
+			printf("FAIL %s:%d %s\n", __FILE__, __LINE__, #condition);       \
+		}                                                                    \
+	} while (0)
+
+///////////////////////////////////////////////////////////////////////////////
+// Print the totals and give the exit status
+inline int CheckResult(const char *name)
+{
+	printf("%s %s: %d checks, %d failed\n", _checkFailures == 0 ? "PASS" : "FAIL", name, _checks, _checkFailures);
+	return _checkFailures == 0 ? 0 : 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// RTCM frame of the type with the MSM epoch filled in (The CRC is not)
+inline QueueData *MakeRtcm(int type, uint32_t epoch = 0, int length = 40)
+{
+	std::vector<uint8_t> frame(length, 0);
+	int payload = length - 6;
+	frame[0] = 0xD3;
+	frame[1] = (payload >> 8) & 0x03;
+	frame[2] = payload & 0xFF;
+	frame[3] = type >> 4;
+	frame[4] = (type & 0x0F) << 4;
+	frame[6] = epoch >> 22; // Epoch is the 30 bits from bit 48
+	frame[7] = epoch >> 14;
+	frame[8] = epoch >> 6;
+	frame[9] = (epoch << 2) & 0xFC;
+	return new QueueData(frame.data(), frame.size());
+}
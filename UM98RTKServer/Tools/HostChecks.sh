@@ -0,0 +1,19 @@
+#!/bin/sh
+###############################################################################
+# Build and run the checks of the firmware headers on a PC
+# .. Run from the project folder. Exits 0 when every check passes.
+# .. Tools/UploadCheck.sh checks the upload against the stand-in caster
+###############################################################################
+
+OUT=${OUT:-/tmp/ntrip-check}
+mkdir -p "$OUT"
+
+FAILED=0
+for CHECK in QueueDataCheck SendQueueCheck LatencyHistogramCheck LogHistoryCheck LogRecordCheck; do
+	# LogRecord.cpp formats the log records
+	g++ -std=c++17 -O2 -Wall -ITools/Host -Iinclude -o "$OUT/$CHECK" "Tools/$CHECK.cpp" src/LogRecord.cpp || { FAILED=1; continue; }
+	"$OUT/$CHECK" || FAILED=1
+done
+
+[ $FAILED -eq 0 ] && echo "All host checks passed"
+exit $FAILED
@@ -0,0 +1,111 @@
+///////////////////////////////////////////////////////////////////////////////
+// Check the latency histogram's window rotation and percentiles on a PC
+//
+// Build (Linux or macOS, from the project folder)
+//		g++ -std=c++17 -O2 -ITools/Host -Iinclude -o LatencyHistogramCheck Tools/LatencyHistogramCheck.cpp
+//		./LatencyHistogramCheck
+///////////////////////////////////////////////////////////////////////////////
+
+#include <memory>
+
+#include "Check.h"
+#include "LatencyHistogram.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// Summary of the last complete window or the lifetime
+static LatencySummary Summary(const LatencyHistogram &histogram, bool window)
+{
+	LatencySummary summary;
+	histogram.Summarise(summary, window);
+	return summary;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// The window shows only what was recorded between the last two rotations.
+// The lifetime keeps everything
+static void CheckRotation()
+{
+	auto pHistogram = std::make_unique<LatencyHistogram>();
+	LatencyHistogram &h = *pHistogram;
+
+	// First window
+	for (int n = 0; n < 10; n++)
+		h.Record(1000);
+	h.RecordExpired(600000);
+	h.RecordDropped(2000);
+	CHECK(Summary(h, true).Count == 0);
+	CHECK(Summary(h, false).Count == 12);
+
+	// Too soon to rotate
+	h.Rotate(LATENCY_WINDOW_MS - 1);
+	CHECK(Summary(h, true).Count == 0);
+
+	// The first window is now the complete one
+	h.Rotate(LATENCY_WINDOW_MS);
+	auto first = Summary(h, true);
+	CHECK(first.Count == 12 && first.Expired == 1 && first.Dropped == 1);
+	CHECK(first.Max == 600000);
+
+	// Second window. Not shown until it is complete
+	for (int n = 0; n < 5; n++)
+		h.Record(50);
+	CHECK(Summary(h, true).Count == 12);
+	h.Rotate(2 * LATENCY_WINDOW_MS - 1);
+	CHECK(Summary(h, true).Count == 12);
+
+	// Only the second window. The first was cleared, not added to
+	h.Rotate(2 * LATENCY_WINDOW_MS);
+	auto second = Summary(h, true);
+	CHECK(second.Count == 5 && second.Expired == 0 && second.Dropped == 0);
+	CHECK(second.Max == 50 && second.P99 == 50);
+
+	// A window with nothing recorded
+	h.Rotate(3 * LATENCY_WINDOW_MS);
+	auto empty = Summary(h, true);
+	CHECK(empty.Count == 0 && empty.Max == 0 && empty.P50 == 0);
+
+	// A long gap rotates once and the next window starts from then
+	h.Record(70);
+	h.Rotate(10 * LATENCY_WINDOW_MS);
+	CHECK(Summary(h, true).Count == 1);
+	h.Rotate(11 * LATENCY_WINDOW_MS - 1);
+	CHECK(Summary(h, true).Count == 1);
+
+	auto lifetime = Summary(h, false);
+	CHECK(lifetime.Count == 18 && lifetime.Expired == 1 && lifetime.Dropped == 1);
+	CHECK(lifetime.Max == 600000);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Percentiles are the top of the bucket (Within 12.5%) and never above the max
+static void CheckPercentiles()
+{
+	auto pHistogram = std::make_unique<LatencyHistogram>();
+	LatencyHistogram &h = *pHistogram;
+	for (uint32_t n = 1; n <= 1000; n++)
+		h.Record(n * 100);
+	auto summary = Summary(h, false);
+	CHECK(summary.Count == 1000 && summary.Max == 100000);
+	CHECK(summary.P50 >= 50000 && summary.P50 <= 50000 * 9 / 8);
+	CHECK(summary.P90 >= 90000 && summary.P90 <= 90000 * 9 / 8);
+	CHECK(summary.P99 >= 99000 && summary.P99 <= 100000);
+
+	// Small values have a bucket each
+	auto pSmall = std::make_unique<LatencyHistogram>();
+	for (uint32_t n = 0; n < 10; n++)
+		pSmall->Record(n);
+	auto small = Summary(*pSmall, false);
+	CHECK(small.P50 == 4 && small.P90 == 8 && small.Max == 9);
+
+	// Past the last bucket the max is given
+	auto pHuge = std::make_unique<LatencyHistogram>();
+	pHuge->Record(0xFFFFFFFF);
+	CHECK(Summary(*pHuge, false).P50 == 0xFFFFFFFF);
+}
+
+int main()
+{
+	CheckRotation();
+	CheckPercentiles();
+	return CheckResult("LatencyHistogram");
+}
@@ -0,0 +1,163 @@
+///////////////////////////////////////////////////////////////////////////////
+// Check the log arena of LogHistory wraps around on a PC
+//
+// Small line limits so the index and the arena both lap many times
+//
+// Build (Linux or macOS, from the project folder)
+//		g++ -std=c++17 -O2 -ITools/Host -Iinclude -o LogHistoryCheck Tools/LogHistoryCheck.cpp src/LogRecord.cpp
+//		./LogHistoryCheck
+///////////////////////////////////////////////////////////////////////////////
+
+#define MAX_LOG_LENGTH 64
+#define MAX_LOG_ROW_LENGTH 40
+
+#include <string>
+
+#include "Check.h"
+#include "LogHistory.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// Text of line n. Lengths vary so records end at every offset in the arena
+static std::string Line(int n)
+{
+	return "Line " + std::to_string(n) + std::string(n % 23, '.');
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Lines in order, each one intact, ending with the last added
+static bool IsTail(const LogHistory &log, int added)
+{
+	auto lines = log.Copy();
+	if (lines.empty())
+		return false;
+	int first = added - (int)lines.size();
+	for (size_t n = 0; n < lines.size(); n++)
+		if (lines[n] != Line(first + (int)n))
+			return false;
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Nothing is kept until the arena is allocated
+static void CheckUnallocated()
+{
+	LogHistory log;
+	log.Add("Dropped");
+	uint32_t first, next;
+	log.GetRange(first, next);
+	CHECK(log.GetArenaSize() == 0);
+	CHECK(log.Copy().empty());
+	CHECK(first == 0 && next == 0);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Sizes round down to a power of 2 and never go below the minimum
+static void CheckAllocate()
+{
+	LogHistory odd;
+	CHECK(odd.Allocate(3000) && odd.GetArenaSize() == 2048);
+
+	LogHistory tiny;
+	CHECK(tiny.Allocate(100) && tiny.GetArenaSize() == LOG_ARENA_MIN);
+
+	// A second call keeps the first arena
+	CHECK(odd.Allocate(8192) && odd.GetArenaSize() == 2048);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// The arena is smaller than the index so it laps first. Records cut across
+// .. the end of the arena must read back whole
+static void CheckArenaWrap()
+{
+	LogHistory log;
+	log.Allocate(LOG_ARENA_MIN);
+	int added = 0;
+	for (; added < 1000; added++)
+	{
+		log.Add(Line(added));
+		if (!IsTail(log, added + 1))
+			break;
+	}
+	CHECK(added == 1000);
+
+	// Fewer lines than the index holds as the arena is full
+	auto count = log.Copy().size();
+	CHECK(count > 10 && count < MAX_LOG_LENGTH);
+
+	// The range matches what Copy gave
+	uint32_t first, next;
+	log.GetRange(first, next);
+	CHECK(next == 1000 && next - first == count);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// A large arena laps the index first. The index slot the next line will
+// .. take counts as written over, so MAX_LOG_LENGTH - 1 lines are kept
+static void CheckIndexWrap()
+{
+	LogHistory log;
+	log.Allocate(64 * 1024);
+	for (int n = 0; n < 500; n++)
+		log.Add(Line(n));
+	CHECK(IsTail(log, 500));
+	CHECK(log.Copy().size() == MAX_LOG_LENGTH - 1);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// A reader carries on from its sequence number. Lines it missed that were
+// .. written over are skipped, not repeated
+static void CheckVisitSince()
+{
+	LogHistory log;
+	log.Allocate(64 * 1024);
+	for (int n = 0; n < 10; n++)
+		log.Add(Line(n));
+
+	std::vector<std::string> seen;
+	uint32_t next = log.Visit(0, [&](uint32_t, const char *line)
+							  {
+								  seen.push_back(line);
+								  return true; });
+	CHECK(next == 10 && seen.size() == 10);
+
+	// Fall behind by more than the index holds
+	for (int n = 10; n < 10 + MAX_LOG_LENGTH * 2; n++)
+		log.Add(Line(n));
+	uint32_t firstSeq = 0;
+	int count = 0;
+	next = log.Visit(next, [&](uint32_t seq, const char *line)
+					 {
+						 if (count++ == 0)
+							 firstSeq = seq;
+						 return line == Line(seq); });
+	CHECK(next == 10 + MAX_LOG_LENGTH * 2);
+	CHECK(firstSeq == next - (MAX_LOG_LENGTH - 1) && count == MAX_LOG_LENGTH - 1);
+
+	// Stopping early gives the sequence to start from next time
+	next = log.Visit(firstSeq, [](uint32_t, const char *)
+					 { return false; });
+	CHECK(next == firstSeq);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Long lines are cut and marked
+static void CheckLongLine()
+{
+	LogHistory log;
+	log.Allocate(LOG_ARENA_MIN);
+	log.Add(std::string(100, 'x'));
+	auto lines = log.Copy();
+	CHECK(lines.size() == 1);
+	CHECK(lines.size() == 1 && lines[0] == std::string(MAX_LOG_ROW_LENGTH, 'x') + "...");
+}
+
+int main()
+{
+	CheckUnallocated();
+	CheckAllocate();
+	CheckArenaWrap();
+	CheckIndexWrap();
+	CheckVisitSince();
+	CheckLongLine();
+	return CheckResult("LogHistory");
+}
@@ -0,0 +1,164 @@
+///////////////////////////////////////////////////////////////////////////////
+// Check deferred log records decode to the text printf would give on a PC
+//
+// Build (Linux or macOS, from the project folder)
+//		g++ -std=c++17 -O2 -ITools/Host -Iinclude -o LogRecordCheck Tools/LogRecordCheck.cpp src/LogRecord.cpp
+//		./LogRecordCheck
+///////////////////////////////////////////////////////////////////////////////
+
+#include <string>
+
+#include "Check.h"
+#include "LogRecord.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// Encode the arguments and format the record as the logs do
+template <typename... Args>
+static std::string Format(LogClock clock, int8_t source, const char *format, Args... args)
+{
+	LogEncoder record(format, source);
+	record.PutAll(args...);
+	char text[256];
+	LogFormat(record.Data(), record.Length(), text, sizeof(text), clock);
+	return text;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Line without the time at the start (Both clocks print two parts)
+template <typename... Args>
+static std::string Body(const char *format, Args... args)
+{
+	std::string text = Format(LogClockUptime, LOG_SOURCE_NONE, format, args...);
+	size_t space = text.find(' ', text.find(' ') + 1);
+	return space == std::string::npos ? "" : text.substr(space + 1);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Integers keep the flags and width. The stored type decides the size so
+// length modifiers in the format make no difference
+static void CheckIntegers()
+{
+	CHECK(Body("%d %u %x %05d %-3d|", -5, 7u, 255, 42, 1) == "-5 7 ff 00042 1  |");
+	CHECK(Body("%lu %ld %lums", 4000000000UL, -2L, 12UL) == "4000000000 -2 12ms");
+	CHECK(Body("%llu %lld", 5000000000000ULL, -1LL) == "5000000000000 -1");
+	CHECK(Body("%d %d %d", true, (short)-3, (unsigned char)200) == "1 -3 200");
+	CHECK(Body("%c%c", 'O', 'K') == "OK");
+	CHECK(Body("%06x", 0xABCDEFu) == "abcdef");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Floating point is stored as a double
+static void CheckFloats()
+{
+	CHECK(Body("%.2f", 3.14159) == "3.14");
+	CHECK(Body("%.1f %g", 2.25f, 0.5) == "2.2 0.5" || Body("%.1f %g", 2.25f, 0.5) == "2.3 0.5");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Strings are copied when logged and cut at LOG_STRING_MAX
+static void CheckStrings()
+{
+	std::string host = "rtk2go.com";
+	char buffer[] = "buffer";
+	CHECK(Body("%s '%s' %s", host, "SOURCE", buffer) == "rtk2go.com 'SOURCE' buffer");
+	CHECK(Body("[%s]", (const char *)nullptr) == "[(null)]");
+	CHECK(Body("[%8s]", "ab") == "[      ab]");
+
+	std::string longText(LOG_STRING_MAX + 20, 'x');
+	CHECK(Body("%s", longText) == std::string(LOG_STRING_MAX, 'x'));
+
+	// The copy is taken when logged, not when read
+	std::string changing = "before";
+	LogEncoder record("%s", LOG_SOURCE_NONE);
+	record.PutAll(changing);
+	changing = "after";
+	char text[64];
+	LogFormat(record.Data(), record.Length(), text, sizeof(text), LogClockUptime);
+	CHECK(std::string(text).find("before") != std::string::npos);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// %H prints a blob as hex. %% is a percent sign
+static void CheckBlobsAndPercent()
+{
+	uint8_t bytes[] = {0x01, 0xAB, 0xFF};
+	CHECK(Body("Data %H", LogBytes(bytes, sizeof(bytes))) == "Data 01 ab ff ");
+	CHECK(Body("%d%%", 50) == "50%");
+
+	uint8_t big[LOG_BLOB_MAX + 10] = {};
+	CHECK(Body("%H", LogBytes(big, sizeof(big))).length() == LOG_BLOB_MAX * 3);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Missing arguments print ? and extra ones are ignored. Arguments past
+// LOG_RECORD_MAX are dropped rather than overflowing the record
+static void CheckArgumentCount()
+{
+	CHECK(Body("%d and %d", 1) == "1 and ?");
+	CHECK(Body("%d", 1, 2, 3) == "1");
+
+	std::string part(LOG_STRING_MAX, 'y');
+	LogEncoder record("%s %s %s %s %d", LOG_SOURCE_NONE);
+	record.PutAll(part, part, part, part, 7);
+	CHECK(record.Length() <= LOG_RECORD_MAX);
+	char text[1024];
+	LogFormat(record.Data(), record.Length(), text, sizeof(text), LogClockUptime);
+	std::string line = text;
+	CHECK(line.find(part + " " + part) != std::string::npos);
+	CHECK(line.back() == '?');
+
+	// A record cut short keeps the whole arguments and drops the part one
+	LogEncoder cut("%d [%s]", LOG_SOURCE_NONE);
+	cut.PutAll(9, "text");
+	LogFormat(cut.Data(), cut.Length() - 2, text, sizeof(text), LogClockUptime);
+	line = text;
+	CHECK(line.substr(line.length() - 5) == " 9 []");
+	CHECK(LogFormat(cut.Data(), 5, text, sizeof(text), LogClockUptime) == 0 && text[0] == 0);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Time at the start from the log's clock, then the caster it came from
+static void CheckPrefix()
+{
+	std::string uptime = Format(LogClockUptime, LOG_SOURCE_NONE, "Hello");
+	CHECK(uptime.rfind("0 00:00:0", 0) == 0 && uptime.substr(uptime.length() - 6) == " Hello");
+
+	// The PC clock is set so the wall clock is used
+	std::string wall = Format(LogClockWall, LOG_SOURCE_NONE, "Hello");
+	CHECK(wall.rfind("20", 0) == 0 && wall[4] == '-' && wall[13] == ':' && wall.substr(20) == "Hello");
+
+	std::string caster = Format(LogClockUptime, 2, "Connected");
+	CHECK(caster.find(" NTRIP 2:Connected") != std::string::npos);
+
+	// Same record in another log with its source changed
+	LogEncoder record("Sent %d", LOG_SOURCE_NONE);
+	record.PutAll(5);
+	record.SetSource(1);
+	char text[64];
+	LogFormat(record.Data(), record.Length(), text, sizeof(text), LogClockUptime);
+	CHECK(std::string(text).find(" NTRIP 1:Sent 5") != std::string::npos);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Text is cut to the buffer and always ends with a null
+static void CheckCut()
+{
+	LogEncoder record("%s", LOG_SOURCE_NONE);
+	record.PutAll("A long line that will not fit");
+	char text[12];
+	memset(text, '#', sizeof(text));
+	size_t length = LogFormat(record.Data(), record.Length(), text, sizeof(text), LogClockUptime);
+	CHECK(length == sizeof(text) - 1 && text[sizeof(text) - 1] == 0 && strlen(text) == length);
+}
+
+int main()
+{
+	CheckIntegers();
+	CheckFloats();
+	CheckStrings();
+	CheckBlobsAndPercent();
+	CheckArgumentCount();
+	CheckPrefix();
+	CheckCut();
+	return CheckResult("LogRecord");
+}
@@ -0,0 +1,79 @@
+#!/usr/bin/env python3
+###############################################################################
+# Build include/Web/WebAssets.h with the web page assets gzipped into flash
+#
+#	python3 Tools/MakeWebAssets.py
+#
+# Everything the pages load is in Web/ so they work with no Internet.
+# Run from the UM98RTKServer folder after changing anything in Web/
+###############################################################################
+import gzip
+import os
+import zlib
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+WEB = os.path.join(ROOT, "Web")
+OUT = os.path.join(ROOT, "include", "Web", "WebAssets.h")
+
+CONTENT_TYPES = {
+	".css": "text/css",
+	".js": "application/javascript",
+	".woff2": "font/woff2",
+	".svg": "image/svg+xml",
+	".html": "text/html",
+}
+
+# Already compressed. Gzip would only make them bigger
+NO_GZIP = {".woff2"}
+
+
+def sources():
+	# Served name and file for everything under Web/
+	found = []
+	for folder, _, files in os.walk(WEB):
+		for file in sorted(files):
+			path = os.path.join(folder, file)
+			found.append((os.path.relpath(path, WEB).replace(os.sep, "/"), path))
+	return sorted(found)
+
+
+def main():
+	lines = [
+		"#pragma once",
+		"",
+		"// Generated by Tools/MakeWebAssets.py from the files in Web/. Do not edit",
+		"",
+		"#include <Arduino.h>",
+		"",
+	]
+	table = []
+	for n, (name, path) in enumerate(sources()):
+		ext = os.path.splitext(name)[1]
+		if ext not in CONTENT_TYPES:
+			continue
+		raw = open(path, "rb").read()
+		gz = ext not in NO_GZIP
+		data = gzip.compress(raw, 9, mtime=0) if gz else raw
+		etag = "%08x" % (zlib.crc32(data) & 0xFFFFFFFF)
+		symbol = "WEB_ASSET_%d" % n
+		print("%-30s %7d -> %7d bytes %s" % (name, len(raw), len(data), etag))
+
+		lines.append("// %s (%d bytes before gzip)" % (name, len(raw)))
+		lines.append("static const uint8_t %s[] PROGMEM = {" % symbol)
+		for i in range(0, len(data), 20):
+			lines.append("\t" + ",".join("0x%02x" % b for b in data[i:i + 20]) + ",")
+		lines.append("};")
+		lines.append("")
+		table.append('\t{"%s", "%s", "%s", %s, sizeof(%s), %s},' % (name, CONTENT_TYPES[ext], etag, symbol, symbol, "true" if gz else "false"))
+
+	lines.append("static const WebAsset WEB_ASSETS[] = {")
+	lines.extend(table)
+	lines.append("};")
+	lines.append("")
+
+	with open(OUT, "w", newline="\n") as f:
+		f.write("\n".join(lines))
+	print("Wrote", OUT)
+
+
+main()
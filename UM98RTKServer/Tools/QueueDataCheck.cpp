@@ -0,0 +1,87 @@
+///////////////////////////////////////////////////////////////////////////////
+// Check the RTCM classification and MSM epoch times of QueueData on a PC
+//
+// Build (Linux or macOS, from the project folder)
+//		g++ -std=c++17 -O2 -ITools/Host -Iinclude -o QueueDataCheck Tools/QueueDataCheck.cpp
+//		./QueueDataCheck
+///////////////////////////////////////////////////////////////////////////////
+
+#include <memory>
+
+#include "Check.h"
+
+// Seconds in a GPS week
+#define WEEK (7 * 86400)
+
+///////////////////////////////////////////////////////////////////////////////
+// GPS second of the week for an MSM frame of the type and epoch
+static uint32_t GpsSecond(int type, uint32_t epoch)
+{
+	std::unique_ptr<QueueData> pItem(MakeRtcm(type, epoch));
+	return pItem->getGpsSecond();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Message type, class and GNSS
+static void CheckClassify()
+{
+	std::unique_ptr<QueueData> pStation(MakeRtcm(1005));
+	CHECK(pStation->getType() == 1005 && pStation->getClass() == RtcmClassStation && pStation->getGnss() < 0);
+
+	std::unique_ptr<QueueData> pEphemeris(MakeRtcm(1019));
+	CHECK(pEphemeris->getClass() == RtcmClassOther && pEphemeris->getGnss() < 0);
+
+	std::unique_ptr<QueueData> pMsm(MakeRtcm(1127, BEIDOU_EPOCH));
+	CHECK(pMsm->getClass() == RtcmClassMsm && pMsm->getGnss() == RTCM_GNSS_BEIDOU && pMsm->getEpoch() == BEIDOU_EPOCH);
+
+	// 1070 and 1078 are not MSM
+	std::unique_ptr<QueueData> pNotMsm(MakeRtcm(1078, GPS_EPOCH));
+	CHECK(pNotMsm->getClass() == RtcmClassOther && pNotMsm->getEpoch() == 0);
+
+	// Too short to be a frame
+	QueueData shortItem((const unsigned char *)"\xD3\x00", 2);
+	CHECK(shortItem.getType() == 0 && shortItem.getClass() == RtcmClassOther);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Every GNSS of one epoch gives the same GPS second
+static void CheckCommonTime()
+{
+	const uint32_t gps = GPS_EPOCH / 1000;
+	CHECK(GpsSecond(1074, GPS_EPOCH) == gps);
+	CHECK(GpsSecond(1094, GPS_EPOCH) == gps);
+	CHECK(GpsSecond(1114, GPS_EPOCH) == gps);
+	CHECK(GpsSecond(1124, BEIDOU_EPOCH) == gps);
+	CHECK(GpsSecond(1084, GLONASS_EPOCH) == gps);
+
+	// GLONASS early on Sunday Moscow time is late Saturday in GPS time
+	CHECK(GpsSecond(1084, (0u << 27) | 1000) == WEEK - 3 * 3600 + RTCM_GPS_LEAP_SECONDS + 1);
+
+	// BeiDou late on Saturday wraps into the next GPS week
+	CHECK(GpsSecond(1124, (WEEK - 5) * 1000u) == 9);
+
+	// Unknown GLONASS day still lands on the right second of the day
+	CHECK(GpsSecond(1084, (7u << 27) | (GLONASS_EPOCH & 0x7FFFFFF)) % 86400 == gps % 86400);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// The reduced message set keeps or drops all GNSS of an epoch together
+static void CheckReducedSetAgrees()
+{
+	for (uint32_t second = 0; second < 30; second++)
+	{
+		uint32_t gpsMs = GPS_EPOCH + second * 1000;
+		bool keep = GpsSecond(1074, gpsMs) % 5 == 0;
+		CHECK((GpsSecond(1124, gpsMs - 14000) % 5 == 0) == keep);
+		CHECK((GpsSecond(1084, GLONASS_EPOCH + second * 1000) % 5 == 0) == keep);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int main()
+{
+	CheckClassify();
+	CheckCommonTime();
+	CheckReducedSetAgrees();
+	return CheckResult("QueueData");
+}
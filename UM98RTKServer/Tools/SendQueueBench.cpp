@@ -0,0 +1,419 @@
+///////////////////////////////////////////////////////////////////////////////
+// Drive the caster queue and send logic on a PC against the stand-in caster
+//
+// Runs the firmware's SendQueue (Overflow drops, deadline expiry and earliest
+// deadline first batching) and SendGather (Gather writes with NTRIP 2.0 chunk
+// framing) with a synthetic RTCM stream, the way the caster task does
+//
+// Build (Linux or macOS, from the project folder)
+//		g++ -std=c++17 -O2 -pthread -ITools/Host -Iinclude -o SendQueueBench Tools/SendQueueBench.cpp
+//
+// Run with Tools/StandInCaster.cpp listening (Use its faults to load the queue)
+//		./StandInCaster -p 2101 -slow 2000 -reset 20
+//		./SendQueueBench [options]
+//
+//	-h <host>			Caster address (Default 127.0.0.1)
+//	-p <port>			Caster port (Default 2101)
+//	-v <1|2>			NTRIP version (Default 1)
+//	-rate <Hz>			Epochs per second (Default 1)
+//	-msm <n>			MSM frames per epoch (Default 4)
+//	-size <bytes>		Length of each MSM frame (Default 300)
+//	-station <s>		Seconds between station frames (Default 5)
+//	-t <s>				Seconds to run (Default 60)
+//	-retry <ms>			Wait before reconnecting (Default 1000)
+//	-timeout <ms>		Write timeout (Default 2000)
+//	-sndbuf <bytes>		Socket send buffer (Default 5744 as lwIP on the ESP32)
+//
+// Each second a line shows frames and bytes written, the queue, the frames
+// dropped and expired by class and the enqueue to wire latency. The summary
+// adds the throughput and each reconnect's time from the failed write to the
+// first good write on the new connection
+///////////////////////////////////////////////////////////////////////////////
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "SendQueue.h"
+#include "LatencyHistogram.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// Settings from the command line
+struct Options
+{
+	std::string Host = "127.0.0.1";
+	int Port = 2101;
+	int NtripVersion = 1;
+	double Rate = 1;
+	int MsmPerEpoch = 4;
+	int MsmSize = 300;
+	int StationInterval = 5;
+	int Seconds = 60;
+	int RetryMs = 1000;
+	int TimeoutMs = 2000;
+	int SendBuffer = 5744;
+};
+static Options _options;
+
+///////////////////////////////////////////////////////////////////////////////
+// Counts shared by the GPS and caster threads
+struct Counts
+{
+	long Queued = 0;
+	long Sent = 0;
+	long SentBytes = 0;
+	long Writes = 0;
+	long LostDisconnected = 0;
+	long Dropped[RtcmClassCount] = {};
+	long Expired[RtcmClassCount] = {};
+};
+static Counts _counts;
+static SendQueue _queue;
+static std::mutex _queMutex; // Stands in for the caster's queue mutex
+static LatencyHistogram _latency;
+static std::atomic<bool> _running = {true};
+
+///////////////////////////////////////////////////////////////////////////////
+// RTCM3 CRC24Q
+static uint32_t Crc24q(const uint8_t *pData, size_t length)
+{
+	uint32_t crc = 0;
+	for (size_t n = 0; n < length; n++)
+	{
+		crc ^= (uint32_t)pData[n] << 16;
+		for (int bit = 0; bit < 8; bit++)
+		{
+			crc <<= 1;
+			if (crc & 0x1000000)
+				crc ^= 0x1864CFB;
+		}
+	}
+	return crc & 0xFFFFFF;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Write bits into a frame (MSB first)
+static void SetBits(std::vector<uint8_t> &frame, int pos, int len, uint32_t value)
+{
+	for (int n = 0; n < len; n++)
+	{
+		int bit = pos + n;
+		if ((value >> (len - 1 - n)) & 1)
+			frame[bit / 8] |= 0x80 >> (bit % 8);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// RTCM frame of the type with a valid CRC. MSM frames carry the epoch
+static std::vector<uint8_t> MakeFrame(int type, int length, uint32_t epochMs)
+{
+	int payload = std::max(8, std::min(1023, length - 6));
+	std::vector<uint8_t> frame(payload + 6, 0);
+	frame[0] = 0xD3;
+	frame[1] = (payload >> 8) & 0x03;
+	frame[2] = payload & 0xFF;
+	SetBits(frame, 24, 12, type);
+	SetBits(frame, 36, 12, 1); // Station id
+	if (1071 <= type && type <= 1137)
+		SetBits(frame, 48, 30, epochMs);
+	uint32_t crc = Crc24q(frame.data(), payload + 3);
+	frame[payload + 3] = crc >> 16;
+	frame[payload + 4] = crc >> 8;
+	frame[payload + 5] = crc;
+	return frame;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Queue a frame as EnqueueData does
+static void Enqueue(const std::vector<uint8_t> &frame)
+{
+	static const unsigned long deadlines[RtcmClassCount] = {NTRIP_DEADLINE_STATION_MS, NTRIP_DEADLINE_MSM_MS, NTRIP_DEADLINE_OTHER_MS};
+	QueueData *pItem = new QueueData(frame.data(), frame.size());
+	pItem->SetDeadline(deadlines[pItem->getClass()]);
+
+	std::lock_guard<std::mutex> lock(_queMutex);
+	_counts.Queued++;
+	_queue.Push(pItem, [](QueueData *pOldItem)
+				{
+					_counts.Dropped[pOldItem->getClass()]++;
+					_latency.RecordDropped(micros() - pOldItem->getQueuedMicros()); });
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Stands in for the GPS. A burst of frames each epoch
+static void GpsThread()
+{
+	static const int MSM_TYPES[] = {1074, 1084, 1094, 1124, 1114, 1134};
+	double interval = 1.0 / _options.Rate;
+	auto next = std::chrono::steady_clock::now();
+	uint32_t epochMs = 0;
+	int epoch = 0;
+	while (_running)
+	{
+		if (_options.StationInterval > 0 && (epoch % std::max(1, (int)(_options.StationInterval * _options.Rate))) == 0)
+		{
+			Enqueue(MakeFrame(1005, 25, 0));
+			Enqueue(MakeFrame(1033, 40, 0));
+		}
+		for (int n = 0; n < _options.MsmPerEpoch; n++)
+			Enqueue(MakeFrame(MSM_TYPES[n % 6], _options.MsmSize, epochMs));
+		if (epoch % 10 == 5)
+			Enqueue(MakeFrame(1019, 68, 0));
+
+		epoch++;
+		epochMs = (uint32_t)(epoch * interval * 1000) % (7 * 24 * 3600 * 1000);
+		next += std::chrono::microseconds((long)(interval * 1e6));
+		std::this_thread::sleep_until(next);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Connect and log in. Returns the socket or -1
+static int Connect()
+{
+	addrinfo hints = {}, *pResult = nullptr;
+	hints.ai_family = AF_INET;
+	hints.ai_socktype = SOCK_STREAM;
+	if (getaddrinfo(_options.Host.c_str(), std::to_string(_options.Port).c_str(), &hints, &pResult) != 0)
+		return -1;
+	int fd = socket(AF_INET, SOCK_STREAM, 0);
+	setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &_options.SendBuffer, sizeof(_options.SendBuffer));
+	bool ok = connect(fd, pResult->ai_addr, pResult->ai_addrlen) == 0;
+	freeaddrinfo(pResult);
+	if (!ok)
+	{
+		close(fd);
+		return -1;
+	}
+
+	timeval timeout = {_options.TimeoutMs / 1000, (_options.TimeoutMs % 1000) * 1000};
+	setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+	setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+	std::string request = _options.NtripVersion == 2
+							  ? "POST /BENCH HTTP/1.1\r\nHost: " + _options.Host + "\r\nNtrip-Version: Ntrip/2.0\r\nUser-Agent: NTRIP SendQueueBench\r\nAuthorization: Basic YmVuY2g6YmVuY2g=\r\nContent-Type: gnss/data\r\nTransfer-Encoding: chunked\r\n\r\n"
+							  : "SOURCE bench /BENCH\r\nSource-Agent: NTRIP SendQueueBench\r\n\r\n";
+	send(fd, request.c_str(), request.length(), MSG_NOSIGNAL);
+
+	char reply[128] = {};
+	ssize_t length = recv(fd, reply, sizeof(reply) - 1, 0);
+	bool accepted = length > 0 && (strstr(reply, " 200") != nullptr);
+	if (!accepted)
+	{
+		printf("Login refused '%.*s'\n", (int)strcspn(reply, "\r\n"), reply);
+		close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Write the gather list, resuming after partial writes as WriteGather does
+static size_t WriteGather(int fd, SendGather &gather)
+{
+	size_t total = 0;
+	while (total < gather.WireLength && gather.Left() > 0)
+	{
+		ssize_t written = writev(fd, gather.Next(), gather.Left());
+		if (written <= 0)
+			break;
+		total += written;
+		gather.Consume(written);
+	}
+	return total;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Percentile line for the latency
+static std::string LatencyText(bool window)
+{
+	LatencySummary h;
+	_latency.Summarise(h, window);
+	char text[96];
+	snprintf(text, sizeof(text), "p50 %uus p99 %uus max %uus", h.P50, h.P99, h.Max);
+	return text;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Read the options then play the caster task till the time is up
+int main(int argc, char **argv)
+{
+	for (int n = 1; n < argc; n++)
+	{
+		std::string arg = argv[n];
+		bool hasValue = n + 1 < argc;
+		if (arg == "-h" && hasValue)
+			_options.Host = argv[++n];
+		else if (arg == "-p" && hasValue)
+			_options.Port = atoi(argv[++n]);
+		else if (arg == "-v" && hasValue)
+			_options.NtripVersion = atoi(argv[++n]) == 2 ? 2 : 1;
+		else if (arg == "-rate" && hasValue)
+			_options.Rate = std::max(0.1, atof(argv[++n]));
+		else if (arg == "-msm" && hasValue)
+			_options.MsmPerEpoch = atoi(argv[++n]);
+		else if (arg == "-size" && hasValue)
+			_options.MsmSize = atoi(argv[++n]);
+		else if (arg == "-station" && hasValue)
+			_options.StationInterval = atoi(argv[++n]);
+		else if (arg == "-t" && hasValue)
+			_options.Seconds = atoi(argv[++n]);
+		else if (arg == "-retry" && hasValue)
+			_options.RetryMs = atoi(argv[++n]);
+		else if (arg == "-timeout" && hasValue)
+			_options.TimeoutMs = atoi(argv[++n]);
+		else if (arg == "-sndbuf" && hasValue)
+			_options.SendBuffer = atoi(argv[++n]);
+		else
+		{
+			fprintf(stderr, "Unknown option %s. See the top of SendQueueBench.cpp\n", arg.c_str());
+			return 1;
+		}
+	}
+	signal(SIGPIPE, SIG_IGN);
+
+	printf("NTRIP %d to %s:%d. %.1f epochs/s of %d x %d byte MSM for %ds\n",
+		   _options.NtripVersion, _options.Host.c_str(), _options.Port, _options.Rate, _options.MsmPerEpoch, _options.MsmSize, _options.Seconds);
+	std::thread gps(GpsThread);
+
+	int fd = -1;
+	unsigned long lastAttempt = 0;
+	unsigned long failedAt = 0; // Time the last write failed (0 when connected)
+	std::vector<unsigned long> reconnectTimes;
+	unsigned long sendEstimateUs = 0;
+	unsigned long start = millis();
+	unsigned long lastReport = start;
+	long lastSent = 0, lastBytes = 0;
+	std::vector<QueueData *> batch;
+	batch.reserve(NTRIP_SEND_MAX_FRAMES);
+
+	while (millis() - start < (unsigned long)_options.Seconds * 1000)
+	{
+		// Gather the next items as DequeueBatch does
+		int remaining;
+		{
+			std::lock_guard<std::mutex> lock(_queMutex);
+			remaining = _queue.DequeueBatch(batch, millis(), sendEstimateUs / 1000, NTRIP_SEND_BUDGET, [](QueueData *pItem)
+											{
+												_counts.Expired[pItem->getClass()]++;
+												_latency.RecordExpired(micros() - pItem->getQueuedMicros()); });
+		}
+		(void)remaining;
+
+		if (!batch.empty())
+		{
+			// Connect when needed. Frames that arrive while down are lost as on the device
+			if (fd < 0 && (lastAttempt == 0 || millis() - lastAttempt >= (unsigned long)_options.RetryMs))
+			{
+				lastAttempt = std::max(millis(), 1UL);
+				fd = Connect();
+				if (fd >= 0)
+					printf("Connected\n");
+			}
+
+			if (fd < 0)
+			{
+				_counts.LostDisconnected += batch.size();
+			}
+			else
+			{
+				SendGather gather;
+				gather.Build(batch, _options.NtripVersion == 2);
+				unsigned long startT = micros();
+				size_t sent = WriteGather(fd, gather);
+				unsigned long time = micros() - startT;
+				if (sent != gather.WireLength)
+				{
+					printf("Only sent %zu of %zu in %d frames (%lums) %s\n", sent, gather.WireLength, gather.Frames, time / 1000, strerror(errno));
+					close(fd);
+					fd = -1;
+					lastAttempt = millis();
+					failedAt = std::max(millis(), 1UL);
+					_counts.LostDisconnected += batch.size();
+				}
+				else
+				{
+					unsigned long now = micros();
+					for (auto pItem : batch)
+						_latency.Record(now - pItem->getQueuedMicros());
+					_counts.Sent += gather.Frames;
+					_counts.SentBytes += gather.WireLength;
+					_counts.Writes++;
+					sendEstimateUs = (sendEstimateUs * 7 + time) / 8;
+					if (failedAt != 0)
+					{
+						reconnectTimes.push_back(millis() - failedAt);
+						printf("Reconnected. Dark for %lums\n", reconnectTimes.back());
+						failedAt = 0;
+					}
+				}
+			}
+			for (auto pItem : batch)
+				delete pItem;
+		}
+		else
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(2));
+		}
+
+		// Report each second
+		if (millis() - lastReport >= 1000)
+		{
+			_latency.Rotate(millis());
+			std::lock_guard<std::mutex> lock(_queMutex);
+			printf("%4lus %3ld fr/s %6ld B/s | queue %3d fr %5zu B | drop %ld/%ld/%ld exp %ld/%ld/%ld | %s\n",
+				   (millis() - start) / 1000, _counts.Sent - lastSent, _counts.SentBytes - lastBytes,
+				   _queue.GetCount(), _queue.GetBytes(),
+				   _counts.Dropped[RtcmClassStation], _counts.Dropped[RtcmClassMsm], _counts.Dropped[RtcmClassOther],
+				   _counts.Expired[RtcmClassStation], _counts.Expired[RtcmClassMsm], _counts.Expired[RtcmClassOther],
+				   LatencyText(false).c_str());
+			lastSent = _counts.Sent;
+			lastBytes = _counts.SentBytes;
+			lastReport = millis();
+		}
+	}
+	_running = false;
+	gps.join();
+	if (fd >= 0)
+		close(fd);
+
+	// Summary
+	double seconds = (millis() - start) / 1000.0;
+	long dropped = 0, expired = 0;
+	for (int n = 0; n < RtcmClassCount; n++)
+	{
+		dropped += _counts.Dropped[n];
+		expired += _counts.Expired[n];
+	}
+	printf("\nQueued %ld frames. Sent %ld (%.1f%%) in %ld writes, %.0f B/s, %.1f frames/write\n",
+		   _counts.Queued, _counts.Sent, _counts.Queued ? 100.0 * _counts.Sent / _counts.Queued : 0.0, _counts.Writes,
+		   _counts.SentBytes / seconds, _counts.Writes ? (double)_counts.Sent / _counts.Writes : 0.0);
+	printf("Dropped %ld (Station %ld, MSM %ld, other %ld). Expired %ld (Station %ld, MSM %ld, other %ld). Lost while down %ld\n",
+		   dropped, _counts.Dropped[RtcmClassStation], _counts.Dropped[RtcmClassMsm], _counts.Dropped[RtcmClassOther],
+		   expired, _counts.Expired[RtcmClassStation], _counts.Expired[RtcmClassMsm], _counts.Expired[RtcmClassOther],
+		   _counts.LostDisconnected);
+	printf("Latency %s\n", LatencyText(false).c_str());
+	unsigned long longest = 0, total = 0;
+	for (auto time : reconnectTimes)
+	{
+		longest = std::max(longest, time);
+		total += time;
+	}
+	printf("Reconnects %zu. Dark mean %lums, max %lums\n",
+		   reconnectTimes.size(), reconnectTimes.empty() ? 0 : total / reconnectTimes.size(), longest);
+	return 0;
+}
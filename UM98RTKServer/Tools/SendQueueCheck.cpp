@@ -0,0 +1,219 @@
+///////////////////////////////////////////////////////////////////////////////
+// Check the caster queue's overflow policy and deadline order on a PC
+//
+// Build (Linux or macOS, from the project folder)
+//		g++ -std=c++17 -O2 -ITools/Host -Iinclude -o SendQueueCheck Tools/SendQueueCheck.cpp
+//		./SendQueueCheck
+///////////////////////////////////////////////////////////////////////////////
+
+#include <string>
+
+#include "Check.h"
+#include "SendQueue.h"
+
+// Frame length that puts the queue over its limit in a few frames
+#define BIG 1000
+
+///////////////////////////////////////////////////////////////////////////////
+// Queue that notes the type of each dropped frame
+struct CheckedQueue
+{
+	SendQueue Queue;
+	std::vector<int> Dropped;
+
+	void Push(QueueData *pItem)
+	{
+		Queue.Push(pItem, [this](QueueData *pOld)
+				   { Dropped.push_back(pOld->getType()); });
+	}
+
+	~CheckedQueue()
+	{
+		std::vector<QueueData *> batch;
+		while (Queue.GetCount() > 0)
+		{
+			Queue.DequeueBatch(batch, millis(), 0, 1 << 20, [](QueueData *) {});
+			for (auto pItem : batch)
+				delete pItem;
+		}
+	}
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Older copies of a station message go first and the latest copy stays
+static void CheckStationCopies()
+{
+	CheckedQueue q;
+	for (int n = 0; n < 8; n++)
+		q.Push(MakeRtcm(1005, 0, BIG));
+	q.Push(MakeRtcm(1005, 0, BIG));
+	CHECK(q.Dropped.size() == 1 && q.Dropped[0] == 1005);
+
+	// With only the latest copy left it is never the victim
+	CheckedQueue single;
+	single.Push(MakeRtcm(1005, 0, BIG));
+	for (int n = 0; n < 9; n++)
+		single.Push(MakeRtcm(1019, 0, BIG));
+	CHECK(!single.Dropped.empty());
+	for (int type : single.Dropped)
+		CHECK(type == 1019);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// The current epoch of every GNSS outranks other messages even though each
+// GNSS stamps the epoch in its own time base
+static void CheckMixedGnssEpoch()
+{
+	CheckedQueue q;
+	q.Push(MakeRtcm(1019, 0, BIG));
+	q.Push(MakeRtcm(1020, 0, BIG));
+	for (int type : {1074, 1084, 1094, 1124, 1077, 1087, 1097, 1127})
+	{
+		uint32_t epoch = type / 10 == 108 ? GLONASS_EPOCH : type / 10 == 112 ? BEIDOU_EPOCH : GPS_EPOCH;
+		q.Push(MakeRtcm(type, epoch, BIG));
+	}
+	CHECK(q.Dropped.size() == 2);
+	for (int type : q.Dropped)
+		CHECK(type == 1019 || type == 1020);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// An older epoch of one GNSS goes before other messages, and only that GNSS
+static void CheckOlderEpoch()
+{
+	CheckedQueue q;
+	q.Push(MakeRtcm(1084, GLONASS_EPOCH - 1000, BIG));
+	q.Push(MakeRtcm(1074, GPS_EPOCH - 1000, BIG));
+	q.Push(MakeRtcm(1019, 0, BIG));
+	for (int n = 0; n < 3; n++)
+		q.Push(MakeRtcm(1074, GPS_EPOCH, BIG));
+	for (int n = 0; n < 2; n++)
+		q.Push(MakeRtcm(1084, GLONASS_EPOCH, BIG));
+	CHECK(q.Dropped.empty());
+
+	// Each frame now puts it over the limit. The older GLONASS then the older
+	// GPS epoch are dropped, then the other message before any current epoch
+	for (int n = 0; n < 3; n++)
+		q.Push(MakeRtcm(1124, BEIDOU_EPOCH, BIG));
+	CHECK(q.Dropped == std::vector<int>({1084, 1074, 1019}));
+	CHECK(q.Queue.GetBytes() <= NTRIP_QUEUE_MAX_BYTES);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// A queue of one frame is never over the limit however big
+static void CheckSingleFrame()
+{
+	CheckedQueue q;
+	q.Push(MakeRtcm(1074, GPS_EPOCH, 1023));
+	CHECK(q.Dropped.empty() && q.Queue.GetCount() == 1);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Frame with the deadline its class gets from the caster settings
+static QueueData *MakeDue(int type, unsigned long deadlineMs, int length = 40)
+{
+	QueueData *pItem = MakeRtcm(type, type / 10 == 107 ? GPS_EPOCH : 0, length);
+	pItem->SetDeadline(deadlineMs);
+	return pItem;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Types of the frames in a batch. The frames are deleted
+static std::vector<int> Types(std::vector<QueueData *> &batch)
+{
+	std::vector<int> types;
+	for (auto pItem : batch)
+	{
+		types.push_back(pItem->getType());
+		delete pItem;
+	}
+	batch.clear();
+	return types;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Earliest deadline first whatever the arrival order. Equal deadlines keep
+// arrival order so the MSM of one epoch are not shuffled
+static void CheckDeadlineOrder()
+{
+	CheckedQueue q;
+	q.Push(MakeDue(1019, NTRIP_DEADLINE_OTHER_MS));
+	q.Push(MakeDue(1005, NTRIP_DEADLINE_STATION_MS));
+	q.Push(MakeDue(1074, NTRIP_DEADLINE_MSM_MS));
+	q.Push(MakeDue(1084, NTRIP_DEADLINE_MSM_MS));
+	q.Push(MakeDue(1094, NTRIP_DEADLINE_MSM_MS));
+
+	std::vector<QueueData *> batch;
+	int left = q.Queue.DequeueBatch(batch, millis(), 0, 1 << 20, [](QueueData *) {});
+	CHECK(left == 0);
+	CHECK(Types(batch) == std::vector<int>({1074, 1084, 1094, 1019, 1005}));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Frames that would be late once written are dropped before they are sent
+static void CheckExpiry()
+{
+	CheckedQueue q;
+	q.Push(MakeDue(1074, NTRIP_DEADLINE_MSM_MS));
+	q.Push(MakeDue(1019, NTRIP_DEADLINE_OTHER_MS));
+	q.Push(MakeDue(1005, NTRIP_DEADLINE_STATION_MS));
+
+	// Writing takes longer than the MSM can wait
+	std::vector<int> expired;
+	std::vector<QueueData *> batch;
+	int left = q.Queue.DequeueBatch(batch, millis(), NTRIP_DEADLINE_MSM_MS + 100, 1 << 20, [&](QueueData *pItem)
+									{ expired.push_back(pItem->getType()); });
+	CHECK(expired == std::vector<int>({1074}));
+	CHECK(left == 0 && Types(batch) == std::vector<int>({1019, 1005}));
+
+	// Later on everything has missed its deadline
+	q.Push(MakeDue(1005, NTRIP_DEADLINE_STATION_MS));
+	expired.clear();
+	left = q.Queue.DequeueBatch(batch, millis() + NTRIP_DEADLINE_STATION_MS + 1, 0, 1 << 20, [&](QueueData *pItem)
+								{ expired.push_back(pItem->getType()); });
+	CHECK(expired == std::vector<int>({1005}) && batch.empty() && left == 0);
+	CHECK(q.Queue.GetBytes() == 0);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// A batch stops at the byte budget or the frame limit but always takes one
+static void CheckBatchLimits()
+{
+	CheckedQueue q;
+	for (int n = 0; n < 3; n++)
+		q.Push(MakeDue(1074, NTRIP_DEADLINE_MSM_MS, 500));
+	std::vector<QueueData *> batch;
+	int left = q.Queue.DequeueBatch(batch, millis(), 0, NTRIP_SEND_BUDGET, [](QueueData *) {});
+	CHECK(batch.size() == 2 && left == 1);
+	Types(batch);
+
+	// A frame bigger than the budget still goes, on its own
+	q.Push(MakeDue(1074, NTRIP_DEADLINE_MSM_MS, 1023));
+	left = q.Queue.DequeueBatch(batch, millis(), 0, 100, [](QueueData *) {});
+	CHECK(batch.size() == 1 && left == 1);
+	Types(batch);
+	left = q.Queue.DequeueBatch(batch, millis(), 0, 100, [](QueueData *) {});
+	CHECK(batch.size() == 1 && left == 0);
+	Types(batch);
+
+	// Small frames stop at the frame limit
+	for (int n = 0; n < NTRIP_SEND_MAX_FRAMES + 5; n++)
+		q.Push(MakeDue(1074, NTRIP_DEADLINE_MSM_MS, 20));
+	left = q.Queue.DequeueBatch(batch, millis(), 0, 1 << 20, [](QueueData *) {});
+	CHECK(batch.size() == NTRIP_SEND_MAX_FRAMES && left == 5);
+	CHECK(q.Queue.GetBytes() == 5 * 20);
+	Types(batch);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int main()
+{
+	CheckStationCopies();
+	CheckMixedGnssEpoch();
+	CheckOlderEpoch();
+	CheckSingleFrame();
+	CheckDeadlineOrder();
+	CheckExpiry();
+	CheckBatchLimits();
+	return CheckResult("SendQueue");
+}
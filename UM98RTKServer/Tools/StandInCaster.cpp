@@ -0,0 +1,524 @@
+///////////////////////////////////////////////////////////////////////////////
+// Stand-in NTRIP caster for testing the RTK server without a real caster
+//
+// Build (Linux or macOS with OpenSSL)
+//		g++ -std=c++17 -O2 -pthread -o StandInCaster StandInCaster.cpp -lssl -lcrypto
+//
+// Run then point a caster at this machine's IP and port
+//		./StandInCaster [options]
+//
+//	-p <port>			Port to listen on (Default 2101)
+//	-slow <bytes/s>		Read no faster than this to build a back log on the device
+//	-reset <s>			Reset the connection (RST) after this many seconds
+//	-reject				Refuse every login (NTRIP 1 "ERROR - Bad Password", NTRIP 2 401)
+//	-stall <s>			Stop reading after this many seconds but keep the socket open
+//	-stallfor <s>		Resume reading after stalling this long (Default forever)
+//	-once				Take one connection then exit. Status 0 if the login was
+//						good and every frame and chunk checked out (See UploadCheck.cpp).
+//						With -reject, status 0 if the refused login was well formed
+//	-count <n>			As -once but take n connections one after another
+//	-tls <cert> <key>	Accept TLS using the PEM certificate and key files. Session
+//						IDs and tickets are on so the device can resume a session
+//	-resume				With -tls and -count, connections after the first must
+//						resume the TLS session
+//
+// Each second a line per connection shows frames and bytes received, CRC
+// errors, the longest gap between frames and how long the connection has been
+// up. Connection and disconnection times show the device's reconnect timing
+///////////////////////////////////////////////////////////////////////////////
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <openssl/err.h>
+#include <openssl/ssl.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+///////////////////////////////////////////////////////////////////////////////
+// Fault settings from the command line
+struct Options
+{
+	int Port = 2101;
+	long SlowBytesPerSecond = 0;
+	int ResetAfter = 0;
+	bool Reject = false;
+	int StallAfter = 0;
+	int StallFor = 0;
+	int Count = 0;
+	std::string TlsCertificate;
+	std::string TlsKey;
+	bool Resume = false;
+};
+static Options _options;
+static std::mutex _printMutex;
+static SSL_CTX *_pTlsContext = nullptr; // Set when accepting TLS
+
+///////////////////////////////////////////////////////////////////////////////
+// Seconds since the program started
+static double Now()
+{
+	static const auto start = Clock::now();
+	return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Thread safe print with a time stamp
+template <typename... Args>
+static void Log(const char *format, Args... args)
+{
+	std::lock_guard<std::mutex> lock(_printMutex);
+	printf("%9.3f ", Now());
+	printf(format, args...);
+	printf("\n");
+	fflush(stdout);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// RTCM3 CRC24Q
+static uint32_t Crc24q(const uint8_t *pData, size_t length)
+{
+	uint32_t crc = 0;
+	for (size_t n = 0; n < length; n++)
+	{
+		crc ^= (uint32_t)pData[n] << 16;
+		for (int bit = 0; bit < 8; bit++)
+		{
+			crc <<= 1;
+			if (crc & 0x1000000)
+				crc ^= 0x1864CFB;
+		}
+	}
+	return crc & 0xFFFFFF;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// One connection from the device
+class Connection
+{
+private:
+	int _socket;
+	SSL *_pSsl = nullptr; // TLS session or null for plain TCP
+	std::string _peer;
+	int _index;			  // Connection number when counting
+	double _start;
+	std::vector<uint8_t> _rtcm;		 // Bytes of the RTCM stream not yet framed
+	std::vector<uint8_t> _chunked;	 // NTRIP 2 chunked bytes not yet decoded
+	long _chunkLeft = -1;			 // Bytes left in the current chunk (-1 reading size line)
+	bool _chunkedStream = false;	 // NTRIP 2 upload
+	bool _wellFormed = false;		 // Login request had everything needed
+	bool _accepted = false;			 // Login was good
+	bool _resumed = false;			 // TLS handshake resumed an earlier session
+	long _frames = 0, _bytes = 0, _crcErrors = 0, _chunkErrors = 0;
+	long _framesThisSecond = 0, _bytesThisSecond = 0;
+	double _lastFrame = 0, _maxGap = 0;
+
+public:
+	Connection(int socket, const std::string &peer, int index = 0) : _socket(socket), _peer(peer), _index(index), _start(Now()) {}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Handshake then read till the device goes away or a fault ends it
+	void Run()
+	{
+		Log("%s Connected", _peer.c_str());
+		if (StartTls() && Handshake())
+			Stream();
+		if (_pSsl)
+		{
+			SSL_shutdown(_pSsl);
+			SSL_free(_pSsl);
+		}
+		close(_socket);
+		Log("%s Closed after %.1fs. %ld frames, %ld bytes, %ld CRC errors, %ld chunk errors, max gap %.0fms",
+			_peer.c_str(), Now() - _start, _frames, _bytes, _crcErrors, _chunkErrors, _maxGap * 1000);
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Logged in and sent frames with nothing wrong
+	// .. When refusing, a well formed login is enough
+	bool Passed() const
+	{
+		if (_pSsl == nullptr && _pTlsContext)
+			return false;
+		if (_options.Resume && _index > 0 && !_resumed)
+			return false;
+		if (_options.Reject)
+			return _wellFormed;
+		return _accepted && _frames > 0 && _crcErrors == 0 && _chunkErrors == 0 && (!_chunkedStream || (_chunkLeft < 0 && _chunked.empty()));
+	}
+
+private:
+	///////////////////////////////////////////////////////////////////////////
+	// Run the server side of the TLS handshake when accepting TLS
+	bool StartTls()
+	{
+		if (!_pTlsContext)
+			return true;
+		SSL *pSsl = SSL_new(_pTlsContext);
+		SSL_set_fd(pSsl, _socket);
+		if (SSL_accept(pSsl) != 1)
+		{
+			char error[256];
+			ERR_error_string_n(ERR_get_error(), error, sizeof(error));
+			Log("%s TLS handshake failed. %s", _peer.c_str(), error);
+			SSL_free(pSsl);
+			return false;
+		}
+		_pSsl = pSsl;
+		_resumed = SSL_session_reused(_pSsl) == 1;
+		Log("%s %s %s", _peer.c_str(), SSL_get_version(_pSsl), _resumed ? "resumed a session" : "full handshake");
+		return true;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Read from the socket or the TLS session
+	ssize_t Read(void *pBuffer, size_t length)
+	{
+		if (_pSsl)
+			return SSL_read(_pSsl, pBuffer, (int)length);
+		return recv(_socket, pBuffer, length, 0);
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Read the request line and headers then accept or reject the login
+	bool Handshake()
+	{
+		std::string request, line;
+		std::vector<std::string> headers;
+		char ch;
+		while (Read(&ch, 1) == 1)
+		{
+			if (ch == '\r')
+				continue;
+			if (ch != '\n')
+			{
+				line += ch;
+				continue;
+			}
+			if (request.empty())
+				request = line;
+			else if (line.empty())
+				break;
+			else
+				headers.push_back(line);
+			line.clear();
+		}
+		Log("%s <- '%s'", _peer.c_str(), request.c_str());
+
+		_chunkedStream = request.rfind("POST ", 0) == 0;
+		if (!_chunkedStream && request.rfind("SOURCE ", 0) != 0)
+		{
+			Send("HTTP/1.1 400 Bad Request\r\n\r\n");
+			return false;
+		}
+
+		// NTRIP 2 needs the version, a login and chunked transfer
+		if (_chunkedStream)
+		{
+			for (const char *pNeeded : {"ntrip-version: ntrip/2.0", "authorization: basic ", "transfer-encoding: chunked"})
+			{
+				if (!HasHeader(headers, pNeeded))
+				{
+					Log("%s Missing header '%s'", _peer.c_str(), pNeeded);
+					Send("HTTP/1.1 400 Bad Request\r\n\r\n");
+					return false;
+				}
+			}
+		}
+
+		_wellFormed = true;
+		if (_options.Reject)
+		{
+			Send(_chunkedStream ? "HTTP/1.1 401 Unauthorized\r\n\r\n" : "ERROR - Bad Password\r\n");
+			return false;
+		}
+		Send(_chunkedStream ? "HTTP/1.1 200 OK\r\nNtrip-Version: Ntrip/2.0\r\n\r\n" : "ICY 200 OK\r\n");
+		_accepted = true;
+		return true;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Check for a header starting with the lower case text
+	static bool HasHeader(const std::vector<std::string> &headers, const char *pStart)
+	{
+		for (std::string header : headers)
+		{
+			std::transform(header.begin(), header.end(), header.begin(), ::tolower);
+			if (header.rfind(pStart, 0) == 0)
+				return true;
+		}
+		return false;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Read the correction stream applying any faults
+	void Stream()
+	{
+		uint8_t buffer[4096];
+		double lastReport = Now();
+		double stalledAt = 0;
+		while (true)
+		{
+			double up = Now() - _start;
+
+			// Reset with RST rather than a clean close
+			if (_options.ResetAfter > 0 && up >= _options.ResetAfter)
+			{
+				struct linger lingerReset = {1, 0};
+				setsockopt(_socket, SOL_SOCKET, SO_LINGER, &lingerReset, sizeof(lingerReset));
+				Log("%s Fault: reset", _peer.c_str());
+				return;
+			}
+
+			// Stop reading but leave the socket open
+			if (_options.StallAfter > 0 && up >= _options.StallAfter)
+			{
+				if (stalledAt == 0)
+				{
+					stalledAt = Now();
+					Log("%s Fault: stalled", _peer.c_str());
+				}
+				if (_options.StallFor == 0 || (Now() - stalledAt) < _options.StallFor)
+				{
+					std::this_thread::sleep_for(std::chrono::milliseconds(100));
+					continue;
+				}
+			}
+
+			// Throttle to the slow rate
+			size_t readSize = sizeof(buffer);
+			if (_options.SlowBytesPerSecond > 0)
+			{
+				readSize = std::max(1L, std::min((long)sizeof(buffer), _options.SlowBytesPerSecond / 10));
+				std::this_thread::sleep_for(std::chrono::milliseconds(100));
+			}
+
+			ssize_t length = Read(buffer, readSize);
+			if (length <= 0)
+				return;
+			if (_chunkedStream)
+				Unchunk(buffer, length);
+			else
+				AddRtcm(buffer, length);
+
+			if (Now() - lastReport >= 1.0)
+			{
+				Log("%s %ld frames/s %ld bytes/s. Total %ld frames, %ld CRC errors, max gap %.0fms, up %.0fs",
+					_peer.c_str(), _framesThisSecond, _bytesThisSecond, _frames, _crcErrors, _maxGap * 1000, up);
+				_framesThisSecond = _bytesThisSecond = 0;
+				lastReport = Now();
+			}
+		}
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Strip the HTTP chunk framing from an NTRIP 2 upload
+	void Unchunk(const uint8_t *pData, size_t length)
+	{
+		_chunked.insert(_chunked.end(), pData, pData + length);
+		size_t pos = 0;
+		while (pos < _chunked.size())
+		{
+			if (_chunkLeft < 0)
+			{
+				// Size line in hex
+				auto end = std::find(_chunked.begin() + pos, _chunked.end(), '\n');
+				if (end == _chunked.end())
+					break;
+				std::string sizeLine(_chunked.begin() + pos, end);
+				char *pEnd = nullptr;
+				long size = strtol(sizeLine.c_str(), &pEnd, 16);
+				if (sizeLine.empty() || pEnd == sizeLine.c_str() || strcmp(pEnd, "\r") != 0 || size <= 0)
+				{
+					// A zero size chunk ends the upload and the device never sends one
+					Log("%s Bad chunk size line '%s'", _peer.c_str(), sizeLine.c_str());
+					_chunkErrors++;
+				}
+				_chunkLeft = std::max(0L, size) + 2; // Data and trailing CRLF
+				pos = end - _chunked.begin() + 1;
+				continue;
+			}
+
+			// Chunk data then its CRLF
+			size_t take = std::min((size_t)_chunkLeft, _chunked.size() - pos);
+			size_t data = std::min(take, (size_t)std::max(0L, _chunkLeft - 2));
+			AddRtcm(_chunked.data() + pos, data);
+			for (size_t n = data; n < take; n++)
+			{
+				char expected = (_chunkLeft - (long)n) == 2 ? '\r' : '\n';
+				if (_chunked[pos + n] != expected)
+				{
+					Log("%s Chunk not followed by CRLF", _peer.c_str());
+					_chunkErrors++;
+					break;
+				}
+			}
+			pos += take;
+			_chunkLeft -= take;
+			if (_chunkLeft == 0)
+				_chunkLeft = -1;
+		}
+		_chunked.erase(_chunked.begin(), _chunked.begin() + pos);
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Split the stream into RTCM frames and check each CRC
+	void AddRtcm(const uint8_t *pData, size_t length)
+	{
+		_bytes += length;
+		_bytesThisSecond += length;
+		_rtcm.insert(_rtcm.end(), pData, pData + length);
+		size_t pos = 0;
+		while (_rtcm.size() - pos >= 6)
+		{
+			if (_rtcm[pos] != 0xD3)
+			{
+				pos++;
+				continue;
+			}
+			size_t frameLength = (((_rtcm[pos + 1] & 0x03) << 8) | _rtcm[pos + 2]) + 6;
+			if (_rtcm.size() - pos < frameLength)
+				break;
+			const uint8_t *pFrame = _rtcm.data() + pos;
+			uint32_t crc = (pFrame[frameLength - 3] << 16) | (pFrame[frameLength - 2] << 8) | pFrame[frameLength - 1];
+			if (Crc24q(pFrame, frameLength - 3) != crc)
+			{
+				_crcErrors++;
+				pos++;
+				continue;
+			}
+
+			double now = Now();
+			if (_lastFrame != 0)
+				_maxGap = std::max(_maxGap, now - _lastFrame);
+			_lastFrame = now;
+			_frames++;
+			_framesThisSecond++;
+			pos += frameLength;
+		}
+		_rtcm.erase(_rtcm.begin(), _rtcm.begin() + pos);
+	}
+
+	void Send(const char *text)
+	{
+		if (_pSsl)
+			SSL_write(_pSsl, text, strlen(text));
+		else
+			send(_socket, text, strlen(text), MSG_NOSIGNAL);
+		Log("%s -> '%s'", _peer.c_str(), std::string(text, strcspn(text, "\r\n")).c_str());
+	}
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Read the options then accept connections forever
+int main(int argc, char **argv)
+{
+	for (int n = 1; n < argc; n++)
+	{
+		std::string arg = argv[n];
+		bool hasValue = n + 1 < argc;
+		if (arg == "-p" && hasValue)
+			_options.Port = atoi(argv[++n]);
+		else if (arg == "-slow" && hasValue)
+			_options.SlowBytesPerSecond = atol(argv[++n]);
+		else if (arg == "-reset" && hasValue)
+			_options.ResetAfter = atoi(argv[++n]);
+		else if (arg == "-reject")
+			_options.Reject = true;
+		else if (arg == "-stall" && hasValue)
+			_options.StallAfter = atoi(argv[++n]);
+		else if (arg == "-stallfor" && hasValue)
+			_options.StallFor = atoi(argv[++n]);
+		else if (arg == "-once")
+			_options.Count = 1;
+		else if (arg == "-count" && hasValue)
+			_options.Count = std::max(1, atoi(argv[++n]));
+		else if (arg == "-tls" && n + 2 < argc)
+		{
+			_options.TlsCertificate = argv[++n];
+			_options.TlsKey = argv[++n];
+		}
+		else if (arg == "-resume")
+			_options.Resume = true;
+		else
+		{
+			fprintf(stderr, "Unknown option %s. See the top of StandInCaster.cpp\n", arg.c_str());
+			return 1;
+		}
+	}
+
+	signal(SIGPIPE, SIG_IGN);
+
+	// TLS with the default server session cache and tickets so sessions can resume
+	if (!_options.TlsCertificate.empty())
+	{
+		_pTlsContext = SSL_CTX_new(TLS_server_method());
+		static const unsigned char SESSION_CONTEXT[] = "StandInCaster";
+		SSL_CTX_set_session_id_context(_pTlsContext, SESSION_CONTEXT, sizeof(SESSION_CONTEXT) - 1);
+		SSL_CTX_set_session_cache_mode(_pTlsContext, SSL_SESS_CACHE_SERVER);
+		if (SSL_CTX_use_certificate_chain_file(_pTlsContext, _options.TlsCertificate.c_str()) != 1 ||
+			SSL_CTX_use_PrivateKey_file(_pTlsContext, _options.TlsKey.c_str(), SSL_FILETYPE_PEM) != 1)
+		{
+			ERR_print_errors_fp(stderr);
+			return 1;
+		}
+	}
+
+	int listener = socket(AF_INET, SOCK_STREAM, 0);
+	int reuse = 1;
+	setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+	// A small window when reading slowly so the back log builds on the device, not in our buffers
+	if (_options.SlowBytesPerSecond > 0)
+	{
+		int receiveBuffer = 4096;
+		setsockopt(listener, SOL_SOCKET, SO_RCVBUF, &receiveBuffer, sizeof(receiveBuffer));
+	}
+	sockaddr_in address = {};
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = INADDR_ANY;
+	address.sin_port = htons(_options.Port);
+	if (bind(listener, (sockaddr *)&address, sizeof(address)) != 0 || listen(listener, 8) != 0)
+	{
+		perror("Cannot listen");
+		return 1;
+	}
+	Log("Listening on %d%s", _options.Port, _pTlsContext ? " for TLS" : "");
+
+	int served = 0, passed = 0;
+	while (true)
+	{
+		sockaddr_in peer = {};
+		socklen_t peerLength = sizeof(peer);
+		int socket = accept(listener, (sockaddr *)&peer, &peerLength);
+		if (socket < 0)
+			continue;
+		std::string name = std::string(inet_ntoa(peer.sin_addr)) + ":" + std::to_string(ntohs(peer.sin_port));
+		if (_options.Count > 0)
+		{
+			Connection connection(socket, name, served++);
+			connection.Run();
+			if (connection.Passed())
+				passed++;
+			if (served < _options.Count)
+				continue;
+			Log("%s %d of %d connections passed", passed == served ? "PASS" : "FAIL", passed, served);
+			return passed == served ? 0 : 1;
+		}
+		std::thread([socket, name]()
+					{ Connection(socket, name).Run(); })
+			.detach();
+	}
+}
@@ -0,0 +1,355 @@
+///////////////////////////////////////////////////////////////////////////////
+// Check the device's upload against the stand-in caster
+//
+// Sends the firmware's login (NtripRequest.h), reads the reply with the
+// firmware's parser (CasterReply.h) then writes RTCM frames with the firmware's
+// gather list (SendGather in SendQueue.h). Each write is cut into small
+// pieces so the resume after a partial write and the NTRIP 2.0 chunk framing
+// are both checked. The stand-in checks every frame, chunk and header
+//
+// With -openssl the login and frames go over TLS through an OpenSSL client
+// and every connection after the first must resume the session. This checks
+// the stand-in's TLS and the framing inside TLS records only. CasterLink's
+// mbedTLS code (Session save and restore, the resumed check) is not run here.
+// Check that on the device with the "Resumed" count on the status page
+//
+// Build (Linux or macOS with OpenSSL, from the project folder)
+//		g++ -std=c++17 -O2 -pthread -ITools/Host -Iinclude -o UploadCheck Tools/UploadCheck.cpp -lssl -lcrypto
+//
+// Run against a stand-in taking one connection. Both exit 0 on a pass
+//		./StandInCaster -p 2101 -once &
+//		./UploadCheck -p 2101 -v 2 && wait $!
+//
+// Or run every check with Tools/UploadCheck.sh
+//
+//	-h <host>			Caster address (Default 127.0.0.1)
+//	-p <port>			Caster port (Default 2101)
+//	-v <1|2>			NTRIP version (Default 2)
+//	-frames <n>			Frames to send (Default 100)
+//	-piece <bytes>		Most bytes in each write (Default 7)
+//	-reject				Expect the caster to refuse the login
+//	-openssl			Connect with an OpenSSL TLS client and check the session resumes
+//	-connections <n>	Connections one after another (Default 1, or 2 with -openssl)
+///////////////////////////////////////////////////////////////////////////////
+
+#include <netdb.h>
+#include <openssl/err.h>
+#include <openssl/ssl.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "CasterReply.h"
+#include "NtripRequest.h"
+#include "SendQueue.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// Settings from the command line
+struct Options
+{
+	std::string Host = "127.0.0.1";
+	int Port = 2101;
+	int NtripVersion = 2;
+	int Frames = 100;
+	size_t Piece = 7;
+	bool Reject = false;
+	bool OpenSsl = false;
+	int Connections = 0;
+};
+static Options _options;
+static SSL_CTX *_pTlsContext = nullptr;	  // Set when connecting with TLS
+static SSL_SESSION *_pTlsSession = nullptr; // Last session for resumption
+
+///////////////////////////////////////////////////////////////////////////////
+// Connection to the caster over plain TCP or TLS
+struct Link
+{
+	int Socket = -1;
+	SSL *pSsl = nullptr;
+	bool Resumed = false;
+
+	ssize_t Read(void *pBuffer, size_t length)
+	{
+		if (pSsl)
+			return SSL_read(pSsl, pBuffer, (int)length);
+		return recv(Socket, pBuffer, length, 0);
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Write a gather list. TLS sends it as one record as CasterLink::Writev does
+	ssize_t Write(const struct iovec *iov, int count)
+	{
+		if (!pSsl)
+			return writev(Socket, iov, count);
+		std::vector<uint8_t> flat;
+		for (int n = 0; n < count; n++)
+			flat.insert(flat.end(), (const uint8_t *)iov[n].iov_base, (const uint8_t *)iov[n].iov_base + iov[n].iov_len);
+		return SSL_write(pSsl, flat.data(), (int)flat.size());
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Let the caster read everything before it sees the close
+	void Close()
+	{
+		if (pSsl)
+		{
+			SSL_shutdown(pSsl);
+			SSL_free(pSsl);
+			pSsl = nullptr;
+		}
+		shutdown(Socket, SHUT_WR);
+		char ch;
+		while (recv(Socket, &ch, 1, 0) > 0)
+			;
+		close(Socket);
+	}
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Print the result and give the exit status
+static int Result(bool pass, const char *why)
+{
+	printf("%s NTRIP %d%s%s: %s\n", pass ? "PASS" : "FAIL", _options.NtripVersion,
+		   _options.OpenSsl ? " OpenSSL TLS" : "", _options.Reject ? " refused" : "", why);
+	return pass ? 0 : 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// RTCM3 CRC24Q
+static uint32_t Crc24q(const uint8_t *pData, size_t length)
+{
+	uint32_t crc = 0;
+	for (size_t n = 0; n < length; n++)
+	{
+		crc ^= (uint32_t)pData[n] << 16;
+		for (int bit = 0; bit < 8; bit++)
+		{
+			crc <<= 1;
+			if (crc & 0x1000000)
+				crc ^= 0x1864CFB;
+		}
+	}
+	return crc & 0xFFFFFF;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// RTCM frame of the type with a valid CRC and a varying payload
+static QueueData *MakeFrame(int type, int length, int seed)
+{
+	int payload = length - 6;
+	std::vector<uint8_t> frame(length, 0);
+	frame[0] = 0xD3;
+	frame[1] = (payload >> 8) & 0x03;
+	frame[2] = payload & 0xFF;
+	frame[3] = type >> 4;
+	frame[4] = (type & 0x0F) << 4;
+	for (int n = 5; n < payload + 3; n++)
+		frame[n] = (uint8_t)(seed * 31 + n);
+	uint32_t crc = Crc24q(frame.data(), payload + 3);
+	frame[payload + 3] = crc >> 16;
+	frame[payload + 4] = crc >> 8;
+	frame[payload + 5] = crc;
+	return new QueueData(frame.data(), frame.size());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Write the rest of the gather list no more than a piece at a time
+static bool WritePieces(Link &link, SendGather &gather)
+{
+	size_t total = 0;
+	while (total < gather.WireLength && gather.Left() > 0)
+	{
+		// Copy the entries that fit in the piece, trimming the last
+		struct iovec piece[NTRIP_SEND_MAX_FRAMES + 2];
+		int count = 0;
+		size_t room = _options.Piece;
+		for (int n = 0; n < gather.Left() && room > 0; n++, count++)
+		{
+			piece[count] = gather.Next()[n];
+			piece[count].iov_len = std::min(piece[count].iov_len, room);
+			room -= piece[count].iov_len;
+		}
+		ssize_t written = link.Write(piece, count);
+		if (written <= 0)
+			return false;
+		total += written;
+		gather.Consume(written);
+	}
+	return total == gather.WireLength;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Connect and run any TLS handshake offering the last session
+// .. Returns an empty string on success or the reason it failed
+static std::string Connect(Link &link)
+{
+	addrinfo hints = {}, *pResult = nullptr;
+	hints.ai_family = AF_INET;
+	hints.ai_socktype = SOCK_STREAM;
+	if (getaddrinfo(_options.Host.c_str(), std::to_string(_options.Port).c_str(), &hints, &pResult) != 0)
+		return "Cannot resolve the caster";
+	link.Socket = socket(AF_INET, SOCK_STREAM, 0);
+	bool connected = connect(link.Socket, pResult->ai_addr, pResult->ai_addrlen) == 0;
+	freeaddrinfo(pResult);
+	if (!connected)
+		return "Cannot connect to the caster";
+	timeval timeout = {5, 0};
+	setsockopt(link.Socket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+	setsockopt(link.Socket, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+	if (!_pTlsContext)
+		return "";
+
+	link.pSsl = SSL_new(_pTlsContext);
+	SSL_set_fd(link.pSsl, link.Socket);
+	SSL_set_tlsext_host_name(link.pSsl, _options.Host.c_str());
+	if (_pTlsSession)
+		SSL_set_session(link.pSsl, _pTlsSession);
+	if (SSL_connect(link.pSsl) != 1)
+	{
+		char error[256];
+		ERR_error_string_n(ERR_get_error(), error, sizeof(error));
+		return std::string("TLS handshake failed. ") + error;
+	}
+	link.Resumed = SSL_session_reused(link.pSsl) == 1;
+	if (_pTlsSession)
+		SSL_SESSION_free(_pTlsSession);
+	_pTlsSession = SSL_get1_session(link.pSsl);
+	printf("%s %s\n", SSL_get_version(link.pSsl), link.Resumed ? "resumed the session" : "full handshake");
+	return "";
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Log in and send the frames on one connection. Returns the exit status
+static int Upload(int index)
+{
+	Link link;
+	std::string error = Connect(link);
+	if (!error.empty())
+		return Result(false, error.c_str());
+	if (_pTlsContext && index > 0 && !link.Resumed)
+	{
+		link.Close();
+		return Result(false, "TLS session was not resumed");
+	}
+
+	// Log in as the device does
+	std::string request = _options.NtripVersion == 2
+							  ? NtripRequest::Post("CHECK", _options.Host, _options.Port, "", "secret")
+							  : NtripRequest::Source("secret", "CHECK");
+	struct iovec login = {(void *)request.c_str(), request.length()};
+	if (link.Write(&login, 1) != (ssize_t)request.length())
+	{
+		link.Close();
+		return Result(false, "Cannot send the login");
+	}
+
+	// Read till the reply is understood
+	CasterReply reply;
+	auto result = CasterReply::Result::None;
+	uint8_t ch;
+	while (result == CasterReply::Result::None && link.Read(&ch, 1) == 1)
+		if (reply.Add(ch))
+			result = reply.GetResult();
+
+	if (_options.Reject || result != CasterReply::Result::Accepted)
+	{
+		link.Close();
+		if (_options.Reject && result == CasterReply::Result::Rejected)
+		{
+			printf("Refused with '%s'\n", reply.GetReason());
+			return Result(true, "Refusal understood");
+		}
+		if (_options.Reject)
+			return Result(false, "Login was not refused");
+		return Result(false, result == CasterReply::Result::None ? "No reply to the login" : reply.GetReason());
+	}
+
+	// Queue the frames a few at a time and send in batches as the caster task does
+	static const int TYPES[] = {1005, 1074, 1084, 1094, 1124, 1019};
+	SendQueue queue;
+	std::vector<QueueData *> batch;
+	int dropped = 0, sent = 0, writes = 0;
+	bool ok = true;
+	for (int n = 0; ok && n < _options.Frames; n++)
+	{
+		QueueData *pItem = MakeFrame(TYPES[n % 6], 20 + (n * 37) % 400, n);
+		pItem->SetDeadline(60000);
+		dropped += queue.Push(pItem, [](QueueData *) {});
+		if (queue.GetBytes() < 2 * NTRIP_SEND_BUDGET && n + 1 < _options.Frames)
+			continue;
+
+		while (ok && queue.GetCount() > 0)
+		{
+			queue.DequeueBatch(batch, millis(), 0, NTRIP_SEND_BUDGET, [](QueueData *) {});
+			SendGather gather;
+			gather.Build(batch, _options.NtripVersion == 2);
+			ok = WritePieces(link, gather);
+			sent += gather.Frames;
+			writes++;
+			for (auto pItem : batch)
+				delete pItem;
+		}
+	}
+	link.Close();
+	if (dropped > 0)
+		return Result(false, "The queue overflowed");
+	printf("Sent %d frames in %d writes of up to %zu bytes\n", sent, writes, _options.Piece);
+	if (!ok)
+		return Result(false, strerror(errno));
+	return Result(sent == _options.Frames, "Frames written. See the caster for what it received");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+	for (int n = 1; n < argc; n++)
+	{
+		std::string arg = argv[n];
+		bool hasValue = n + 1 < argc;
+		if (arg == "-h" && hasValue)
+			_options.Host = argv[++n];
+		else if (arg == "-p" && hasValue)
+			_options.Port = atoi(argv[++n]);
+		else if (arg == "-v" && hasValue)
+			_options.NtripVersion = atoi(argv[++n]) == 1 ? 1 : 2;
+		else if (arg == "-frames" && hasValue)
+			_options.Frames = atoi(argv[++n]);
+		else if (arg == "-piece" && hasValue)
+			_options.Piece = std::max(1, atoi(argv[++n]));
+		else if (arg == "-reject")
+			_options.Reject = true;
+		else if (arg == "-openssl")
+			_options.OpenSsl = true;
+		else if (arg == "-connections" && hasValue)
+			_options.Connections = std::max(1, atoi(argv[++n]));
+		else
+		{
+			fprintf(stderr, "Unknown option %s. See the top of UploadCheck.cpp\n", arg.c_str());
+			return 1;
+		}
+	}
+	signal(SIGPIPE, SIG_IGN);
+
+	// Client held to TLS 1.2 with tickets and no certificate check
+	if (_options.OpenSsl)
+	{
+		_pTlsContext = SSL_CTX_new(TLS_client_method());
+		SSL_CTX_set_max_proto_version(_pTlsContext, TLS1_2_VERSION);
+		SSL_CTX_set_verify(_pTlsContext, SSL_VERIFY_NONE, nullptr);
+		if (_options.Connections == 0)
+			_options.Connections = 2;
+	}
+
+	int failed = 0;
+	for (int n = 0; n < std::max(1, _options.Connections); n++)
+		failed |= Upload(n);
+	return failed;
+}
@@ -0,0 +1,46 @@
+#!/bin/sh
+###############################################################################
+# Build the stand-in caster and the upload check then run every check
+# .. Run from the project folder. Exits 0 when every check passes
+###############################################################################
+
+PORT=${PORT:-2199}
+OUT=${OUT:-/tmp/ntrip-check}
+mkdir -p "$OUT"
+g++ -std=c++17 -O2 -pthread -o "$OUT/StandInCaster" Tools/StandInCaster.cpp -lssl -lcrypto || exit 1
+g++ -std=c++17 -O2 -pthread -ITools/Host -Iinclude -o "$OUT/UploadCheck" Tools/UploadCheck.cpp -lssl -lcrypto || exit 1
+
+# Self signed certificate for the stand-in's TLS
+openssl req -x509 -newkey rsa:2048 -nodes -days 1 -subj /CN=localhost \
+	-keyout "$OUT/key.pem" -out "$OUT/cert.pem" > /dev/null 2>&1 || exit 1
+
+FAILED=0
+
+# Run one check. $1 is the stand-in options, $2 the check options
+Check()
+{
+	"$OUT/StandInCaster" -p $PORT -once $1 > "$OUT/caster.log" 2>&1 &
+	CASTER=$!
+	sleep 0.5
+	"$OUT/UploadCheck" -p $PORT $2 || FAILED=1
+	if ! wait $CASTER; then
+		echo "Stand-in caster failed. Its log follows"
+		cat "$OUT/caster.log"
+		FAILED=1
+	fi
+}
+
+Check "" "-v 1"
+Check "" "-v 2"
+Check "" "-v 2 -piece 1"
+Check "-reject" "-v 1 -reject"
+Check "-reject" "-v 2 -reject"
+
+# Two OpenSSL connections where the second must resume the first's session
+# .. Checks the stand-in and the framing over TLS, not the device's mbedTLS
+TLS="-tls $OUT/cert.pem $OUT/key.pem"
+Check "$TLS -count 2 -resume" "-v 1 -openssl"
+Check "$TLS -count 2 -resume" "-v 2 -openssl"
+
+[ $FAILED -eq 0 ] && echo "All upload checks passed"
+exit $FAILED
@@ -0,0 +1,88 @@
+// Small line chart for the RTK Server pages (Stands in for Plotly)
+// .. LineChart(divId, title, yValues [, xValues])
+// .. FetchChart(divId, title, url, type) draws a binary series from /api/history
+// .. X defaults to the sample index. Hover shows the nearest point
+function LineChart(divId, title, ys, xs) {
+	const div = document.getElementById(divId);
+	if (!div) return;
+	xs = xs || ys.map((v, i) => i);
+	const canvas = document.createElement('canvas');
+	const tip = document.createElement('div');
+	tip.style.cssText = 'position:absolute;display:none;background:#000c;color:#fff;padding:2px 6px;border-radius:4px;font:12px sans-serif;pointer-events:none';
+	div.style.position = 'relative';
+	div.replaceChildren(canvas, tip);
+
+	const pad = { l: 60, r: 16, t: 36, b: 28 };
+	let w, h, xMin, xMax, yMin, yMax;
+	const px = x => pad.l + (x - xMin) / (xMax - xMin || 1) * (w - pad.l - pad.r);
+	const py = y => h - pad.b - (y - yMin) / (yMax - yMin || 1) * (h - pad.t - pad.b);
+
+	function draw() {
+		const dpr = window.devicePixelRatio || 1;
+		w = div.clientWidth || 700;
+		h = 320;
+		canvas.width = w * dpr;
+		canvas.height = h * dpr;
+		canvas.style.width = w + 'px';
+		canvas.style.height = h + 'px';
+		const c = canvas.getContext('2d');
+		c.scale(dpr, dpr);
+
+		xMin = Math.min(...xs); xMax = Math.max(...xs);
+		yMin = Math.min(0, ...ys); yMax = Math.max(...ys);
+		if (!isFinite(yMax)) { yMin = 0; yMax = 1; }
+
+		c.font = '12px sans-serif';
+		c.fillStyle = '#333';
+		c.textAlign = 'center';
+		c.fillText(title.replace(/&#181;/g, 'µ').replace(/&deg;/g, '°'), w / 2, 20);
+
+		// Grid with 5 steps on y
+		c.strokeStyle = '#ddd';
+		c.textAlign = 'right';
+		for (let i = 0; i <= 5; i++) {
+			const y = yMin + (yMax - yMin) * i / 5;
+			c.beginPath(); c.moveTo(pad.l, py(y)); c.lineTo(w - pad.r, py(y)); c.stroke();
+			c.fillText(Math.round(y * 10) / 10, pad.l - 6, py(y) + 4);
+		}
+		c.textAlign = 'center';
+		for (let i = 0; i <= 5; i++) {
+			const x = xMin + (xMax - xMin) * i / 5;
+			c.fillText(Math.round(x), px(x), h - 8);
+		}
+
+		c.strokeStyle = '#1f77b4';
+		c.lineWidth = 1.5;
+		c.beginPath();
+		ys.forEach((y, i) => i ? c.lineTo(px(xs[i]), py(y)) : c.moveTo(px(xs[i]), py(y)));
+		c.stroke();
+	}
+
+	canvas.onmousemove = e => {
+		if (!ys.length) return;
+		const r = canvas.getBoundingClientRect();
+		const x = xMin + (e.clientX - r.left - pad.l) / (w - pad.l - pad.r) * (xMax - xMin);
+		let n = 0;
+		xs.forEach((v, i) => { if (Math.abs(v - x) < Math.abs(xs[n] - x)) n = i; });
+		tip.textContent = xs[n] + ' : ' + ys[n];
+		tip.style.left = px(xs[n]) + 8 + 'px';
+		tip.style.top = py(ys[n]) - 24 + 'px';
+		tip.style.display = 'block';
+	};
+	canvas.onmouseleave = () => tip.style.display = 'none';
+	window.addEventListener('resize', draw);
+	draw();
+}
+
+// Fetch a little endian series ('i32' or 'i8') and chart it
+function FetchChart(divId, title, url, type) {
+	fetch(url)
+		.then(r => r.arrayBuffer())
+		.then(b => {
+			const v = new DataView(b);
+			const ys = type == 'i8'
+				? Array.from(new Int8Array(b))
+				: Array.from({ length: b.byteLength >> 2 }, (x, i) => v.getInt32(i * 4, true));
+			LineChart(divId, title, ys);
+		});
+}
@@ -0,0 +1,69 @@
+// Page behaviour for the RTK Server portal (Stands in for Bootstrap's script and jQuery)
+// .. Help buttons (data-bs-toggle='popover') show their title and data-bs-content
+// .. Accordion buttons (data-bs-toggle='collapse') open and close data-bs-target
+// .. Eye buttons (.toggle-password) show or hide the password beside them
+document.addEventListener('DOMContentLoaded', function () {
+	let open = null;
+
+	function closePopover() {
+		if (open) open.remove();
+		open = null;
+	}
+
+	document.querySelectorAll('[data-bs-toggle="popover"]').forEach(function (button) {
+		button.addEventListener('click', function (e) {
+			e.stopPropagation();
+			const same = open && open.owner === button;
+			closePopover();
+			if (same) return;
+			open = document.createElement('div');
+			open.owner = button;
+			open.className = 'popover';
+			const header = document.createElement('h3');
+			header.className = 'popover-header';
+			header.textContent = button.dataset.title;
+			const body = document.createElement('div');
+			body.className = 'popover-body';
+			body.textContent = button.getAttribute('data-bs-content') || '';
+			open.append(header, body);
+			document.body.append(open);
+			const r = button.getBoundingClientRect();
+			const left = Math.min(r.left + window.scrollX, window.scrollX + document.documentElement.clientWidth - open.offsetWidth - 8);
+			open.style.left = Math.max(8, left) + 'px';
+			open.style.top = (r.bottom + window.scrollY + 6) + 'px';
+		});
+		// Keep the title for the popover so the browser does not show it as a tooltip too
+		button.dataset.title = button.title;
+		button.setAttribute('aria-label', button.title);
+		button.removeAttribute('title');
+	});
+	document.addEventListener('click', function (e) {
+		if (open && !open.contains(e.target)) closePopover();
+	});
+
+	document.querySelectorAll('[data-bs-toggle="collapse"]').forEach(function (button) {
+		button.addEventListener('click', function () {
+			const panel = document.querySelector(button.getAttribute('data-bs-target'));
+			if (!panel) return;
+			const show = !panel.classList.contains('show');
+			panel.classList.toggle('show', show);
+			button.classList.toggle('collapsed', !show);
+			button.setAttribute('aria-expanded', show);
+		});
+	});
+
+	document.querySelectorAll('.toggle-password').forEach(function (button) {
+		button.addEventListener('click', function () {
+			const wrapper = button.closest('.password-wrapper');
+			const input = wrapper && wrapper.querySelector('input[type="password"], input[type="text"]');
+			if (!input) return;
+			const hidden = input.type === 'password';
+			input.type = hidden ? 'text' : 'password';
+			const icon = button.querySelector('i');
+			if (icon) {
+				icon.classList.toggle('bi-eye');
+				icon.classList.toggle('bi-eye-slash');
+			}
+		});
+	});
+});
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <Arduino.h>
+#include <string>
+#include <time.h>
+
+#include "HandyString.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// Daily and monthly upload budget for a caster on a metered link
+// .. Stored as one comma separated line in the caster config
+struct BandwidthQuota
+{
+	int DailyMB = 0;	// Most MB sent in a day (0 = no limit)
+	int MonthlyMB = 0;	// Most MB sent in a calendar month (0 = no limit)
+	bool Pause = false; // Pause uploads when used up. Otherwise send a reduced message set
+
+	///////////////////////////////////////////////////////////////////////////
+	// Read from "daily,monthly,pause". Missing values keep their defaults
+	void FromString(const std::string &text)
+	{
+		*this = BandwidthQuota();
+		auto parts = Split(text, ",");
+		if (parts.size() > 0)
+			DailyMB = max(0, atoi(parts[0].c_str()));
+		if (parts.size() > 1)
+			MonthlyMB = max(0, atoi(parts[1].c_str()));
+		if (parts.size() > 2)
+			Pause = atoi(parts[2].c_str()) != 0;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Write in the config file format
+	std::string ToString() const
+	{
+		return StringPrintf("%d,%d,%d", DailyMB, MonthlyMB, Pause ? 1 : 0);
+	}
+
+	inline bool IsSet() const { return DailyMB > 0 || MonthlyMB > 0; }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Count the bytes sent to and received from a caster
+// .. Rolling rates use a ring of 60 one second buckets feeding a ring of 60
+// .. one minute buckets so reading a rate is a division, not a sum.
+// .. Day and month totals follow the calendar once the clock is set and are
+// .. kept with the all time totals in a small file that is written rarely
+class BandwidthMeter
+{
+private:
+	uint64_t _totalSent = 0;	 // All time bytes sent
+	uint64_t _totalReceived = 0; // All time bytes received
+	uint64_t _daySent = 0;		 // Bytes sent today
+	uint64_t _monthSent = 0;	 // Bytes sent this month
+	int _dayKey = 0;			 // Day the day total is for (yyyymmdd. 0 if the clock was never set)
+	int _monthKey = 0;			 // Month the month total is for (yyyymm)
+	bool _dirty = false;		 // Changed since the last save
+
+	uint32_t _seconds[60] = {};		 // Bytes sent in each of the last 60 seconds
+	uint32_t _minutes[60] = {};		 // Bytes sent in each of the last 60 minutes
+	uint32_t _thisSecond = 0;		 // Bytes sent in the current second
+	uint32_t _lastSecond = 0;		 // Bytes sent in the last complete second
+	uint32_t _minuteSum = 0;		 // Sum of _seconds
+	uint64_t _hourSum = 0;			 // Sum of _minutes
+	int _secondIndex = 0;			 // Next _seconds bucket to fill
+	int _minuteIndex = 0;			 // Next _minutes bucket to fill
+	unsigned long _secondStart = 0;	 // Start of the current second
+
+public:
+	inline uint64_t GetTotalSent() const { return _totalSent; }
+	inline uint64_t GetTotalReceived() const { return _totalReceived; }
+	inline uint64_t GetDaySent() const { return _daySent; }
+	inline uint64_t GetMonthSent() const { return _monthSent; }
+	inline bool IsDirty() const { return _dirty; }
+
+	// Rates in bytes per second
+	inline uint32_t GetRate1s() const { return _lastSecond; }
+	inline uint32_t GetRate1m() const { return _minuteSum / 60; }
+	inline uint32_t GetRate1h() const { return (uint32_t)(_hourSum / 3600); }
+
+	void AddSent(size_t bytes)
+	{
+		_totalSent += bytes;
+		_daySent += bytes;
+		_monthSent += bytes;
+		_thisSecond += bytes;
+		_dirty = true;
+	}
+
+	void AddReceived(size_t bytes)
+	{
+		_totalReceived += bytes;
+		_dirty = true;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Move the rolling buckets on. Call often from the sending task
+	// .. Returns true when at least one second has completed
+	bool Tick(unsigned long now)
+	{
+		if ((now - _secondStart) < 1000)
+			return false;
+
+		// After a long stall start the rings again rather than loop for ages
+		if ((now - _secondStart) > 3600000UL)
+		{
+			memset(_seconds, 0, sizeof(_seconds));
+			memset(_minutes, 0, sizeof(_minutes));
+			_minuteSum = 0;
+			_hourSum = 0;
+			_thisSecond = 0;
+			_secondStart = now;
+		}
+
+		while ((now - _secondStart) >= 1000)
+		{
+			_minuteSum += _thisSecond - _seconds[_secondIndex];
+			_seconds[_secondIndex] = _thisSecond;
+			_lastSecond = _thisSecond;
+			_thisSecond = 0;
+			_secondStart += 1000;
+
+			// Each full lap of the seconds is a minute
+			if (++_secondIndex < 60)
+				continue;
+			_secondIndex = 0;
+			_hourSum += _minuteSum;
+			_hourSum -= _minutes[_minuteIndex];
+			_minutes[_minuteIndex] = _minuteSum;
+			_minuteIndex = (_minuteIndex + 1) % 60;
+		}
+		return true;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Start new day and month totals when the calendar moves on
+	// .. Totals counted before the clock was first set stay in the first period
+	void SetDate(const struct tm &info)
+	{
+		int dayKey = (info.tm_year + 1900) * 10000 + (info.tm_mon + 1) * 100 + info.tm_mday;
+		int monthKey = dayKey / 100;
+		if (dayKey != _dayKey)
+		{
+			if (_dayKey != 0)
+				_daySent = 0;
+			_dayKey = dayKey;
+			_dirty = true;
+		}
+		if (monthKey != _monthKey)
+		{
+			if (_monthKey != 0)
+				_monthSent = 0;
+			_monthKey = monthKey;
+			_dirty = true;
+		}
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Check if the quota has been used up
+	bool IsOverQuota(const BandwidthQuota &quota) const
+	{
+		const uint64_t MB = 1024 * 1024;
+		if (quota.DailyMB > 0 && _daySent >= quota.DailyMB * MB)
+			return true;
+		return quota.MonthlyMB > 0 && _monthSent >= quota.MonthlyMB * MB;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Saved counters as "sent,received,day,dayKey,month,monthKey"
+	// .. Clears the changed flag as the text is about to be saved
+	std::string ToString()
+	{
+		_dirty = false;
+		return StringPrintf("%llu,%llu,%llu,%d,%llu,%d", _totalSent, _totalReceived, _daySent, _dayKey, _monthSent, _monthKey);
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Restore the saved counters
+	void FromString(const std::string &text)
+	{
+		auto parts = Split(text, ",");
+		if (parts.size() < 6)
+			return;
+		_totalSent = strtoull(parts[0].c_str(), nullptr, 10);
+		_totalReceived = strtoull(parts[1].c_str(), nullptr, 10);
+		_daySent = strtoull(parts[2].c_str(), nullptr, 10);
+		_dayKey = atoi(parts[3].c_str());
+		_monthSent = strtoull(parts[4].c_str(), nullptr, 10);
+		_monthKey = atoi(parts[5].c_str());
+		_dirty = false;
+	}
+};
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <Arduino.h>
+
+#define HEALTH_BACKOFF_MIN_MS 15000		   // First retry delay after a failure
+#define HEALTH_BACKOFF_MAX_MS 300000	   // Longest retry delay while the breaker is closed
+#define HEALTH_BREAKER_FAILURES 5		   // Consecutive failures that open the breaker
+#define HEALTH_PROBE_MS (10 * 60 * 1000)   // Time between probes while the breaker is open
+#define HEALTH_STABLE_MS 60000			   // Connection time before failures are forgotten
+#define HEALTH_DISCONNECT_HISTORY 8		   // Recent disconnects kept for the score
+#define HEALTH_DISCONNECT_WINDOW_MS 3600000 // Disconnects older than this do not count
+
+///////////////////////////////////////////////////////////////////////////////
+// Track how well a caster is behaving and decide when to reconnect
+// .. Retries back off exponentially with jitter so casters don't retry in step.
+// .. Repeated failures open the circuit breaker and the caster is only probed
+// .. occasionally. A connection must stay up a while before the failures are
+// .. forgotten so a flapping caster cannot reset its own backoff
+class CasterHealth
+{
+public:
+	enum class Breaker
+	{
+		Closed,	  // Normal retries
+		Open,	  // Too many failures. Waiting to probe
+		HalfOpen, // Probe connection is up. Closes once stable
+	};
+
+private:
+	Breaker _breaker = Breaker::Closed;
+	int _failures = 0;				 // Consecutive failed connections or short lived connections
+	unsigned long _nextAttempt = 0;	 // Time the next connection may be tried
+	unsigned long _connectedAt = 0;	 // Time the connection came up (0 when down)
+	float _successRate = 1.0f;		 // Smoothed write success (0 to 1)
+	float _latencyUs = 0.0f;		 // Smoothed write time
+	unsigned long _disconnects[HEALTH_DISCONNECT_HISTORY] = {};
+	int _disconnectIndex = 0;
+
+public:
+	CasterHealth(unsigned long firstAttempt) : _nextAttempt(firstAttempt) {}
+
+	inline Breaker GetBreaker() const { return _breaker; }
+	inline int GetFailures() const { return _failures; }
+
+	///////////////////////////////////////////////////////////////////////////
+	// Check if a connection may be tried now. A due probe half opens the breaker
+	bool CanAttempt(unsigned long now)
+	{
+		if ((long)(now - _nextAttempt) < 0)
+			return false;
+		if (_breaker == Breaker::Open)
+			_breaker = Breaker::HalfOpen;
+		return true;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Record the result of a connection attempt
+	void OnConnectResult(bool ok, unsigned long now)
+	{
+		if (ok)
+		{
+			_connectedAt = max(now, 1UL);
+			return;
+		}
+		Fail(now);
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Record a write. Forgets past failures once the connection is stable
+	void OnWrite(bool ok, unsigned long micros, unsigned long now)
+	{
+		_successRate = _successRate * 0.95f + (ok ? 0.05f : 0.0f);
+		if (ok)
+			_latencyUs = _latencyUs * 0.95f + micros * 0.05f;
+
+		if (ok && _connectedAt != 0 && (now - _connectedAt) > HEALTH_STABLE_MS)
+		{
+			_failures = 0;
+			_breaker = Breaker::Closed;
+		}
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Record a lost connection. A short lived connection counts as a failure
+	void OnDisconnect(unsigned long now)
+	{
+		RecordDisconnect(now);
+		bool stable = _connectedAt != 0 && (now - _connectedAt) > HEALTH_STABLE_MS;
+		_connectedAt = 0;
+		if (stable)
+			_nextAttempt = now + Jitter(2000); // Good caster. Try again straight away
+		else
+			Fail(now);
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Count a disconnect against the score without changing the retry timing
+	void RecordDisconnect(unsigned long now)
+	{
+		_disconnects[_disconnectIndex] = max(now, 1UL);
+		_disconnectIndex = (_disconnectIndex + 1) % HEALTH_DISCONNECT_HISTORY;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Allow a connection straight away (Settings changed)
+	void RetryNow(unsigned long now)
+	{
+		_failures = 0;
+		_breaker = Breaker::Closed;
+		_nextAttempt = now;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Time till the next connection may be tried
+	unsigned long WaitTime(unsigned long now) const
+	{
+		return (long)(_nextAttempt - now) > 0 ? _nextAttempt - now : 0;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Health from 0 (dead) to 100 combining write success, write time and
+	// .. the disconnects in the last hour
+	int Score(unsigned long now) const
+	{
+		if (_breaker == Breaker::Open)
+			return 0;
+
+		int recent = 0;
+		for (auto time : _disconnects)
+			if (time != 0 && (now - time) < HEALTH_DISCONNECT_WINDOW_MS)
+				recent++;
+
+		float latencyMs = min(_latencyUs / 1000.0f, 500.0f);
+		float score = 100.0f * _successRate * (1.0f - latencyMs / 1000.0f) * (1.0f - recent / (2.0f * HEALTH_DISCONNECT_HISTORY));
+		return (int)(score + 0.5f);
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Breaker state for display
+	const char *BreakerText() const
+	{
+		switch (_breaker)
+		{
+		case Breaker::Closed:
+			return "Closed";
+		case Breaker::Open:
+			return "Open";
+		default:
+			return "Half open";
+		}
+	}
+
+private:
+	///////////////////////////////////////////////////////////////////////////
+	// Back off after a failure and open the breaker when they keep coming
+	void Fail(unsigned long now)
+	{
+		_failures++;
+		if (_breaker == Breaker::HalfOpen || _failures >= HEALTH_BREAKER_FAILURES)
+		{
+			_breaker = Breaker::Open;
+			_nextAttempt = now + Jitter(HEALTH_PROBE_MS);
+			return;
+		}
+		unsigned long backoff = min((unsigned long)HEALTH_BACKOFF_MAX_MS, (unsigned long)HEALTH_BACKOFF_MIN_MS << (_failures - 1));
+		_nextAttempt = now + Jitter(backoff);
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Random time between half and all of the period
+	static unsigned long Jitter(unsigned long period)
+	{
+		return random(period / 2, period + 1);
+	}
+};
@@ -0,0 +1,351 @@
+#pragma once
+
+#include <WiFi.h>
+#include <lwip/sockets.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <mbedtls/ssl.h>
+#include <mbedtls/net_sockets.h>
+#include <mbedtls/entropy.h>
+#include <mbedtls/ctr_drbg.h>
+#include <mbedtls/error.h>
+#include <mbedtls/sha256.h>
+
+#include "HandyString.h"
+
+// Session fields are private in mbedTLS 3
+#ifndef MBEDTLS_PRIVATE
+#define MBEDTLS_PRIVATE(member) member
+#endif
+
+// Tries to flush a TLS record before giving up on the connection
+#define TLS_WRITE_RETRIES 3
+
+///////////////////////////////////////////////////////////////////////////////
+// Connection to a caster. Plain TCP or TLS over the same socket
+// .. TLS uses mbedTLS directly so the session can be kept between
+// .. connections and the next handshake to the same host resumed.
+// .. The certificate is only checked when a SHA-256 fingerprint is pinned
+class CasterLink
+{
+private:
+	///////////////////////////////////////////////////////////////////////////
+	// Make the blocking socket non-blocking while in scope so mbedTLS returns
+	// .. WANT_READ instead of waiting for the rest of a record
+	struct NonBlocking
+	{
+		int Fd;
+		int Flags;
+		NonBlocking(int fd) : Fd(fd), Flags(lwip_fcntl(fd, F_GETFL, 0))
+		{
+			lwip_fcntl(Fd, F_SETFL, Flags | O_NONBLOCK);
+		}
+		~NonBlocking() { lwip_fcntl(Fd, F_SETFL, Flags); }
+	};
+
+	///////////////////////////////////////////////////////////////////////////
+	// mbedTLS state for one connection. Heap allocated as it is large
+	struct TlsState
+	{
+		mbedtls_net_context Net;
+		mbedtls_ssl_context Ssl;
+		mbedtls_ssl_config Config;
+		mbedtls_entropy_context Entropy;
+		mbedtls_ctr_drbg_context Drbg;
+
+		TlsState()
+		{
+			mbedtls_net_init(&Net);
+			mbedtls_ssl_init(&Ssl);
+			mbedtls_ssl_config_init(&Config);
+			mbedtls_entropy_init(&Entropy);
+			mbedtls_ctr_drbg_init(&Drbg);
+		}
+		~TlsState()
+		{
+			// The socket belongs to the WiFiClient
+			Net.fd = -1;
+			mbedtls_ssl_free(&Ssl);
+			mbedtls_ssl_config_free(&Config);
+			mbedtls_ctr_drbg_free(&Drbg);
+			mbedtls_entropy_free(&Entropy);
+		}
+	};
+
+	WiFiClient _tcp;
+	std::unique_ptr<TlsState> _pTls;
+	std::unique_ptr<mbedtls_ssl_session> _pSession; // Last session for resumption
+	std::string _sessionHost;						// Host the saved session belongs to
+	std::string _fingerprint;						// SHA-256 of the caster's certificate (Hex)
+	std::vector<uint8_t> _flatBuffer;				// Gather list flattened into one TLS record
+
+	unsigned long _handshakeTime = 0; // Last TLS handshake (ms)
+	bool _resumed = false;			  // Last handshake resumed a saved session
+	int _fullHandshakes = 0;		  // TLS handshakes with a full key exchange
+	int _resumedHandshakes = 0;		  // TLS handshakes that resumed a session
+	int _heapUsed = 0;				  // Heap taken by the TLS state (bytes)
+	uint64_t _encryptMicros = 0;	  // Time spent in mbedtls_ssl_write
+	uint64_t _encryptBytes = 0;		  // Plain text bytes encrypted
+
+public:
+	CasterLink() = default;
+	CasterLink(CasterLink &&) = default;
+	CasterLink &operator=(CasterLink &&) = default;
+	~CasterLink()
+	{
+		if (_pSession)
+			mbedtls_ssl_session_free(_pSession.get());
+	}
+
+	inline bool IsSecure() const { return _pTls != nullptr; }
+	inline int fd() const { return _tcp.fd(); }
+	inline bool connected() { return _tcp.connected(); }
+	inline unsigned long GetHandshakeTime() const { return _handshakeTime; }
+	inline bool GetResumed() const { return _resumed; }
+	inline int GetFullHandshakes() const { return _fullHandshakes; }
+	inline int GetResumedHandshakes() const { return _resumedHandshakes; }
+	inline int GetHeapUsed() const { return _heapUsed; }
+	inline const std::string &GetFingerprint() const { return _fingerprint; }
+	inline int GetEncryptMicrosPerKb() const { return _encryptBytes == 0 ? 0 : (int)(_encryptMicros * 1024 / _encryptBytes); }
+
+	///////////////////////////////////////////////////////////////////////////
+	// Open the TCP connection
+	int connect(IPAddress ip, uint16_t port, int32_t timeoutMs)
+	{
+		stop();
+		return _tcp.connect(ip, port, timeoutMs);
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Close the connection. The TLS session is kept for the next handshake
+	void stop()
+	{
+		if (_pTls)
+		{
+			mbedtls_ssl_close_notify(&_pTls->Ssl);
+			_pTls.reset();
+		}
+		_tcp.stop();
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Run the TLS handshake on the connected socket
+	// .. Most casters self-sign so there is no CA check. When pin holds a
+	// .. SHA-256 fingerprint (Hex, any case, colons allowed) the certificate must
+	// .. match it or the connection is dropped before the password is sent.
+	// .. Returns an empty string on success or the reason it failed
+	std::string StartTls(const std::string &host, unsigned long timeoutMs, const std::string &pin)
+	{
+		unsigned long start = millis();
+		uint32_t heapBefore = ESP.getFreeHeap();
+		_pTls.reset(new (std::nothrow) TlsState());
+		if (!_pTls)
+			return "Out of memory";
+		TlsState &tls = *_pTls;
+		tls.Net.fd = _tcp.fd();
+
+		int ret = mbedtls_ctr_drbg_seed(&tls.Drbg, mbedtls_entropy_func, &tls.Entropy, NULL, 0);
+		if (ret == 0)
+			ret = mbedtls_ssl_config_defaults(&tls.Config, MBEDTLS_SSL_IS_CLIENT, MBEDTLS_SSL_TRANSPORT_STREAM, MBEDTLS_SSL_PRESET_DEFAULT);
+		if (ret != 0)
+			return Fail("Setup", ret);
+		mbedtls_ssl_conf_authmode(&tls.Config, MBEDTLS_SSL_VERIFY_NONE);
+		mbedtls_ssl_conf_rng(&tls.Config, mbedtls_ctr_drbg_random, &tls.Drbg);
+#if defined(MBEDTLS_SSL_SESSION_TICKETS)
+		mbedtls_ssl_conf_session_tickets(&tls.Config, MBEDTLS_SSL_SESSION_TICKETS_ENABLED);
+#endif
+		if ((ret = mbedtls_ssl_setup(&tls.Ssl, &tls.Config)) != 0)
+			return Fail("Setup", ret);
+		mbedtls_ssl_set_hostname(&tls.Ssl, host.c_str());
+		mbedtls_ssl_set_bio(&tls.Ssl, &tls.Net, mbedtls_net_send, mbedtls_net_recv, NULL);
+
+		// Offer the last session with this host
+		bool offered = false;
+		if (_pSession && _sessionHost == host)
+			offered = mbedtls_ssl_set_session(&tls.Ssl, _pSession.get()) == 0;
+
+		// Non-blocking so a silent caster cannot hold the task past the time out
+		{
+			NonBlocking nonBlocking(_tcp.fd());
+			while ((ret = mbedtls_ssl_handshake(&tls.Ssl)) != 0)
+			{
+				if (ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE)
+					return Fail("Handshake", ret);
+				if ((millis() - start) > timeoutMs)
+					return Fail("Handshake timeout", ret);
+				vTaskDelay(10 / portTICK_PERIOD_MS);
+			}
+		}
+
+		// Check the pinned certificate before anything is sent
+		_fingerprint = Fingerprint(mbedtls_ssl_get_peer_cert(&tls.Ssl));
+		if (!pin.empty() && NormaliseFingerprint(pin) != _fingerprint)
+		{
+			_pTls.reset();
+			return "Certificate " + _fingerprint + " does not match the pinned fingerprint";
+		}
+
+		// A resumed session keeps the old master secret
+		std::unique_ptr<mbedtls_ssl_session> pSession(new (std::nothrow) mbedtls_ssl_session);
+		_resumed = false;
+		if (pSession)
+		{
+			mbedtls_ssl_session_init(pSession.get());
+			if (mbedtls_ssl_get_session(&tls.Ssl, pSession.get()) == 0)
+			{
+				_resumed = offered && memcmp(pSession->MBEDTLS_PRIVATE(master), _pSession->MBEDTLS_PRIVATE(master),
+											 sizeof(pSession->MBEDTLS_PRIVATE(master))) == 0;
+				if (_pSession)
+					mbedtls_ssl_session_free(_pSession.get());
+				_pSession = std::move(pSession);
+				_sessionHost = host;
+			}
+			else
+			{
+				mbedtls_ssl_session_free(pSession.get());
+			}
+		}
+		if (_resumed)
+			_resumedHandshakes++;
+		else
+			_fullHandshakes++;
+
+		_handshakeTime = millis() - start;
+		_heapUsed = (int)heapBefore - (int)ESP.getFreeHeap();
+		return "";
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Write a gather list. Returns bytes written or -1 with errno set
+	// .. TLS sends the list as one record. A record that cannot be flushed
+	// .. leaves the stream unusable so is reported as a time out
+	ssize_t Writev(const struct iovec *iov, int count)
+	{
+		if (!_pTls)
+			return lwip_writev(_tcp.fd(), iov, count);
+
+		_flatBuffer.clear();
+		for (int n = 0; n < count; n++)
+			_flatBuffer.insert(_flatBuffer.end(), (const uint8_t *)iov[n].iov_base, (const uint8_t *)iov[n].iov_base + iov[n].iov_len);
+		return WriteTls(_flatBuffer.data(), _flatBuffer.size());
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Write a buffer. Returns the bytes written
+	size_t write(const uint8_t *pData, size_t length)
+	{
+		if (!_pTls)
+			return _tcp.write(pData, length);
+		ssize_t written = WriteTls(pData, length);
+		return written < 0 ? 0 : written;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Bytes ready to read without waiting
+	int available()
+	{
+		if (!_pTls)
+			return _tcp.available();
+
+		int pending = mbedtls_ssl_get_bytes_avail(&_pTls->Ssl);
+		if (pending > 0)
+			return pending;
+
+		// Only decrypt when bytes have arrived. A record may only be part here
+		// .. so read without waiting. mbedTLS keeps the part for the next call
+		int count = 0;
+		if (lwip_ioctl(_tcp.fd(), FIONREAD, &count) < 0 || count < 1)
+			return 0;
+		{
+			NonBlocking nonBlocking(_tcp.fd());
+			mbedtls_ssl_read(&_pTls->Ssl, NULL, 0);
+		}
+		return mbedtls_ssl_get_bytes_avail(&_pTls->Ssl);
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Read one byte or -1 if nothing is waiting
+	int read()
+	{
+		uint8_t ch;
+		return read(&ch, 1) == 1 ? ch : -1;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Read what is waiting up to length. Returns the bytes read or -1
+	int read(uint8_t *pBuffer, size_t length)
+	{
+		if (!_pTls)
+			return _tcp.read(pBuffer, length);
+		if (available() < 1)
+			return -1;
+		int ret = mbedtls_ssl_read(&_pTls->Ssl, pBuffer, length);
+		return ret < 0 ? -1 : ret;
+	}
+
+private:
+	///////////////////////////////////////////////////////////////////////////
+	// Encrypt and send. Retries the same data as mbedTLS requires
+	ssize_t WriteTls(const uint8_t *pData, size_t length)
+	{
+		unsigned long start = micros();
+		size_t total = 0;
+		int retries = 0;
+		while (total < length)
+		{
+			int ret = mbedtls_ssl_write(&_pTls->Ssl, pData + total, length - total);
+			if (ret > 0)
+			{
+				total += ret;
+				continue;
+			}
+			if ((ret == MBEDTLS_ERR_SSL_WANT_WRITE || ret == MBEDTLS_ERR_SSL_WANT_READ) && retries++ < TLS_WRITE_RETRIES)
+			{
+				vTaskDelay(10 / portTICK_PERIOD_MS);
+				continue;
+			}
+			errno = (ret == MBEDTLS_ERR_SSL_WANT_WRITE) ? ETIMEDOUT : ECONNRESET;
+			break;
+		}
+		_encryptMicros += micros() - start;
+		_encryptBytes += total;
+		return total == length ? (ssize_t)total : -1;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// SHA-256 of the certificate in lower case hex. Empty if there is none
+	static std::string Fingerprint(const mbedtls_x509_crt *pCertificate)
+	{
+		if (pCertificate == nullptr)
+			return "";
+		uint8_t hash[32];
+		mbedtls_sha256(pCertificate->raw.p, pCertificate->raw.len, hash, 0);
+		std::string hex;
+		for (uint8_t b : hash)
+			hex += StringPrintf("%02x", b);
+		return hex;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Lower case hex digits only so "AB:CD ..." matches "abcd..."
+	static std::string NormaliseFingerprint(const std::string &text)
+	{
+		std::string hex;
+		for (char ch : text)
+			if (isxdigit((unsigned char)ch))
+				hex += (char)tolower((unsigned char)ch);
+		return hex;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Drop the TLS state and describe the mbedTLS error
+	std::string Fail(const char *stage, int ret)
+	{
+		_pTls.reset();
+		char text[100];
+		mbedtls_strerror(ret, text, sizeof(text));
+		return StringPrintf("%s -0x%04X %s", stage, -ret, text);
+	}
+};
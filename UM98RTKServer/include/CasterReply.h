@@ -0,0 +1,113 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Longest reply line kept. Longer lines are truncated
+#define CASTER_REPLY_LINE_MAX 96
+
+///////////////////////////////////////////////////////////////////////////////
+// Split what a caster sends back into lines and decide if the upload was
+// .. accepted or refused. Understands NTRIP 1 ("ICY 200 OK", "ERROR - ...")
+// .. and NTRIP 2 ("HTTP/1.1 200 OK", "HTTP/1.1 401 Unauthorized") replies.
+// .. Works on a fixed buffer so nothing is allocated as bytes arrive
+class CasterReply
+{
+public:
+	enum class Result
+	{
+		None,	  // Header or chatter that does not change anything
+		Accepted, // Caster took the upload
+		Rejected, // Caster refused the upload (Bad login, mount point taken). See GetReason
+		Failed,	  // Caster could not take the upload right now (HTTP 5xx). See GetReason
+	};
+
+private:
+	char _line[CASTER_REPLY_LINE_MAX + 1] = {};	  // Line being gathered then the last complete line
+	int _length = 0;							  // Characters in the line being gathered
+	bool _complete = false;						  // _line holds a complete line
+	Result _result = Result::None;				  // What the last complete line means
+	char _reason[CASTER_REPLY_LINE_MAX + 1] = {}; // Why the caster last refused us
+
+public:
+	inline const char *GetLine() const { return _line; }
+	inline Result GetResult() const { return _result; }
+	inline const char *GetReason() const { return _reason; }
+
+	///////////////////////////////////////////////////////////////////////////
+	// Forget any part line. Call on each new connection
+	void Reset()
+	{
+		_length = 0;
+		_complete = false;
+		_line[0] = 0;
+		_result = Result::None;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Add the next received character
+	// .. Returns true when it completes a non blank line. Use GetResult and
+	// .. GetLine to see what it was
+	bool Add(uint8_t ch)
+	{
+		if (_complete)
+		{
+			_complete = false;
+			_length = 0;
+		}
+		if (ch == '\r')
+			return false;
+		if (ch != '\n')
+		{
+			if (_length < CASTER_REPLY_LINE_MAX)
+				_line[_length++] = (ch >= ' ' && ch < 0x7F) ? ch : '.';
+			return false;
+		}
+		if (_length == 0)
+			return false;
+		_line[_length] = 0;
+		_complete = true;
+		_result = Classify();
+		return true;
+	}
+
+private:
+	///////////////////////////////////////////////////////////////////////////
+	// Work out what the complete line means
+	Result Classify()
+	{
+		// NTRIP 1
+		if (strncmp(_line, "ICY 200", 7) == 0)
+			return Result::Accepted;
+		if (strncmp(_line, "ERROR", 5) == 0)
+		{
+			// "ERROR - Bad Password" keeps "Bad Password"
+			const char *pText = _line + 5;
+			while (*pText == ' ' || *pText == '-')
+				pText++;
+			return Reject(*pText ? pText : _line);
+		}
+		if (strncmp(_line, "SOURCETABLE", 11) == 0)
+			return Reject("Unknown mount point");
+
+		// NTRIP 2 status line
+		if (strncmp(_line, "HTTP/", 5) == 0)
+		{
+			const char *pCode = strchr(_line, ' ');
+			int code = pCode ? atoi(pCode + 1) : 0;
+			if (code >= 200 && code < 300)
+				return Result::Accepted;
+			Reject(pCode ? pCode + 1 : _line);
+			return (code >= 400 && code < 500) ? Result::Rejected : Result::Failed;
+		}
+		return Result::None;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Keep the reason for the UI
+	Result Reject(const char *reason)
+	{
+		strncpy(_reason, reason, CASTER_REPLY_LINE_MAX);
+		_reason[CASTER_REPLY_LINE_MAX] = 0;
+		return Result::Rejected;
+	}
+};
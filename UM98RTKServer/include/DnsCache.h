@@ -0,0 +1,196 @@
+#pragma once
+
+#include <WiFi.h>
+#include <string>
+
+#include "Global.h"
+#include "HandyLog.h"
+#include "HandyString.h"
+#include "LogLevel.h"
+
+#define DNS_CACHE_SIZE (RTK_SERVERS * 2)  // Room for a primary and a spare host per caster
+#define DNS_CACHE_TTL_MS (10 * 60 * 1000) // Refresh resolved addresses every 10 minutes
+#define DNS_CACHE_RETRY_MS (30 * 1000)	  // Retry failed lookups after 30 seconds
+
+///////////////////////////////////////////////////////////////////////////////
+// Cache of resolved host addresses
+// .. Lookups run in a background task so the caster tasks never block on a
+// .. dead DNS server. Cached addresses are refreshed before they go stale
+class DnsCache
+{
+private:
+	struct Entry
+	{
+		std::string Host;			  // Host name (Empty if slot unused)
+		IPAddress Address;			  // Last good address
+		unsigned long Resolved = 0;	  // Time of the last good lookup (0 = never)
+		unsigned long Attempted = 0;  // Time of the last lookup attempt (0 = lookup now)
+		unsigned long LastUsed = 0;	  // Time the entry was last asked for
+	};
+
+	Entry _entries[DNS_CACHE_SIZE];
+	SemaphoreHandle_t _mutex = NULL;
+	TaskHandle_t _task = NULL;
+
+public:
+	///////////////////////////////////////////////////////////////////////////
+	// Start the background lookup task
+	void Setup()
+	{
+		_mutex = xSemaphoreCreateMutex();
+		if (_mutex == NULL)
+		{
+			perror("Failed to create DNS mutex\n");
+			return;
+		}
+		xTaskCreatePinnedToCore(
+			TaskWrapper,
+			"DnsCacheTask", // Task name
+			4000,			// Stack size (bytes)
+			this,			// Parameter
+			1,				// Task priority
+			&_task,			// Task handle
+			APP_CPU_NUM);
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Get the address of a host
+	// .. Returns straight away if the address is cached (Even if being refreshed)
+	// .. otherwise waits up to timeoutMs for the background task to resolve it
+	bool Lookup(const std::string &host, IPAddress &address, unsigned long timeoutMs)
+	{
+		// No lookup needed for IP addresses
+		if (address.fromString(host.c_str()))
+			return true;
+
+		unsigned long start = millis();
+		while (true)
+		{
+			if (!xSemaphoreTake(_mutex, portMAX_DELAY))
+				return false;
+			Entry *pEntry = FindOrAdd(host);
+			pEntry->LastUsed = millis();
+			bool resolved = pEntry->Resolved != 0;
+			if (resolved)
+				address = pEntry->Address;
+			xSemaphoreGive(_mutex);
+
+			if (resolved)
+				return true;
+			xTaskNotifyGive(_task);
+			if ((millis() - start) >= timeoutMs)
+				return false;
+			vTaskDelay(20 / portTICK_PERIOD_MS);
+		}
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Look the host up again straight away
+	// .. Used when a cached address refuses connections
+	void Invalidate(const std::string &host)
+	{
+		if (!xSemaphoreTake(_mutex, portMAX_DELAY))
+			return;
+		for (auto &entry : _entries)
+		{
+			if (entry.Host == host)
+			{
+				entry.Attempted = 0;
+				break;
+			}
+		}
+		xSemaphoreGive(_mutex);
+	}
+
+private:
+	static void TaskWrapper(void *param)
+	{
+		static_cast<DnsCache *>(param)->TaskFunction();
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Find the host or take over the least recently used slot
+	// WARNING : Call with the mutex held
+	Entry *FindOrAdd(const std::string &host)
+	{
+		Entry *pOldest = &_entries[0];
+		for (auto &entry : _entries)
+		{
+			if (entry.Host == host)
+				return &entry;
+			if (entry.Host.empty() || entry.LastUsed < pOldest->LastUsed)
+				pOldest = &entry;
+			if (entry.Host.empty())
+				break;
+		}
+		*pOldest = Entry();
+		pOldest->Host = host;
+		return pOldest;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Loop forever looking up hosts that are new or due for a refresh
+	void TaskFunction()
+	{
+		Serial.println("+++++ DnsCache Starting");
+		while (true)
+		{
+			// Wake every second or when a new host is asked for
+			ulTaskNotifyTake(pdTRUE, 1000 / portTICK_PERIOD_MS);
+			if (WiFi.status() != WL_CONNECTED)
+				continue;
+
+			// Work through every entry that is due
+			while (true)
+			{
+				std::string host;
+				if (!xSemaphoreTake(_mutex, portMAX_DELAY))
+					break;
+				unsigned long now = millis();
+				for (auto &entry : _entries)
+				{
+					if (entry.Host.empty())
+						continue;
+					bool due = entry.Attempted == 0 ||
+							   (entry.Resolved == 0 && (now - entry.Attempted) > DNS_CACHE_RETRY_MS) ||
+							   (entry.Resolved != 0 && (now - entry.Resolved) > DNS_CACHE_TTL_MS && (now - entry.Attempted) > DNS_CACHE_RETRY_MS);
+					if (due)
+					{
+						entry.Attempted = max(now, 1UL);
+						host = entry.Host;
+						break;
+					}
+				}
+				xSemaphoreGive(_mutex);
+				if (host.empty())
+					break;
+
+				// Blocking lookup outside the lock
+				unsigned long start = millis();
+				IPAddress address;
+				bool ok = WiFi.hostByName(host.c_str(), address) == 1;
+				unsigned long lookupTime = millis() - start;
+
+				if (!xSemaphoreTake(_mutex, portMAX_DELAY))
+					break;
+				for (auto &entry : _entries)
+				{
+					if (entry.Host != host)
+						continue;
+					if (ok)
+					{
+						entry.Address = address;
+						entry.Resolved = max(millis(), 1UL);
+					}
+					break;
+				}
+				xSemaphoreGive(_mutex);
+
+				if (ok)
+					LogInfo(LogWifi, "DNS %s -> %s (%lums)", host, address.toString().c_str(), lookupTime);
+				else
+					LogError(LogWifi, "E110 - DNS lookup failed %s (%lums)", host, lookupTime);
+			}
+		}
+	}
+};
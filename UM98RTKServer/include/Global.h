@@ -9,6 +9,10 @@
 // Enables Logging to the flash drive
 //#define LOG_TO_FLASH
 
+// Most detailed log level built (See LogLevel.h). Lower it to leave the
+// .. detail out of the build. Each module's level is set on the settings page
+#define LOG_COMPILE_LEVEL LOG_LEVEL_VERBOSE
+
 // Enables the LC29HDA code (Comment out for UM980 and UM982)
 //#define IS_LC29HDA
 
@@ -28,9 +32,22 @@
 #endif
 
 #define MAX_LOG_LENGTH (512)
-#define MAX_LOG_SIZE (MAX_LOG_LENGTH * 80)
 #define MAX_LOG_ROW_LENGTH (128 +24)
 
+// Fixed memory for each log (Bytes, power of 2). Oldest lines are overwritten
+// .. Allocated in setup() and halved to fit LOG_ARENA_HEAP_SHARE of the free
+// .. heap (See LogArenaSize). A board can set its own with build flags
+#ifndef LOG_ARENA_MAIN
+#define LOG_ARENA_MAIN (32 * 1024)
+#endif
+#ifndef LOG_ARENA_GPS
+#define LOG_ARENA_GPS (16 * 1024)
+#endif
+#ifndef LOG_ARENA_CASTER
+#define LOG_ARENA_CASTER (8 * 1024)
+#endif
+#define LOG_ARENA_HEAP_SHARE 8 // Each arena gets at most 1/8 of the free heap
+
 #define RTK_SERVERS 3
 
 #define GPS_BUFFER_SIZE (16*1024)
@@ -43,6 +60,8 @@
 #define BASE_LOCATION_FILENAME "/BaseLocn.txt"
 #define MDNS_HOST_FILENAME "/MDNS_HOST_Name.txt"
 #define TIMEZONE_MINUTES "/TIMEZONE_MINUTES.txt"
+#define LOG_LEVELS_FILENAME "/LogLevels.txt"
+#define WEB_BUDGETS_FILENAME "/WebBudgets.txt"
 
 extern HandyTime _handyTime;
 extern std::string _mdnsHostName;
@@ -2,6 +2,7 @@
 
 #include <vector>
 #include <string>
+#include "Metrics.h"
 
 extern MyDisplay _display;
 extern std::string _baseLocation;
@@ -253,7 +254,8 @@ public:
 		// Second reset we set the RTCM3 messages
 		// Third reset we save config
 
-		_display.UpdateGpsStarts(false, true);
+		_metrics.Add(Metric::GpsReinitialise);
+		_display.RefreshGpsStarts();
 		StartInitialiseProcess();
 		_resetProcessed = true;
 		return true;
@@ -2,9 +2,6 @@
 
 #define GPS_TIMEOUT (60000)
 
-// VERBOSE will log more GPS detail including dump logs and received RTK types
-// #define VERBOSE
-
 // Process the received packets after a GPS is configured and running
 #define PROCESS_ALL_PACKETS true
 
@@ -18,10 +15,33 @@
 #include "HandyString.h"
 #include "NTRIPServer.h"
 #include "Global.h"
+#include "LogLevel.h"
+#include "Metrics.h"
+#include "LogHistory.h"
 
 // Note : Max RTK packet size id 1029 bytes
 #define MAX_BUFF 1200
 
+// Copy of the parser state for other tasks (Web pages) made this often
+#define GPS_SNAPSHOT_MS 1000
+#define GPS_SNAPSHOT_TYPES 32
+#define GPS_SNAPSHOT_TEXT 48
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Parser state copied out under a lock so other tasks never read the
+/// .. parser while loop() is changing it
+struct GpsSnapshot
+{
+	char DeviceType[GPS_SNAPSHOT_TEXT];
+	char DeviceFirmware[GPS_SNAPSHOT_TEXT];
+	char DeviceSerial[GPS_SNAPSHOT_TEXT];
+	int MaxBufferSize;
+	int TypeCount;					// Entries used in Types and Counts
+	int Types[GPS_SNAPSHOT_TYPES];	// RTCM message type
+	int Counts[GPS_SNAPSHOT_TYPES]; // Packets received of the type
+	unsigned long Time;				// millis() when taken
+};
+
 const static unsigned int tbl_CRC24Q[] = {
 	0x000000, 0x864CFB, 0x8AD50D, 0x0C99F6, 0x93E6E1, 0x15AA1A, 0x1933EC, 0x9F7F17,
 	0xA18139, 0x27CDC2, 0x2B5434, 0xAD18CF, 0x3267D8, 0xB42B23, 0xB8B2D5, 0x3EFE2E,
@@ -72,19 +92,17 @@ private:
 	unsigned char _byteArray[MAX_BUFF + 1];	   // Buffer to hold the binary data
 	int _binaryIndex = 0;					   // Index of the binary data
 	int _binaryLength = 0;					   // Length of the binary packet
-	std::vector<std::string> _logHistory;	   // Last few log messages
+	LogHistory _logHistory;					   // Last few log messages
 	BuildState _buildState = BuildStateNone;   // Where we are with the build of a packet
 	unsigned char _skippedArray[MAX_BUFF + 2]; // Skipped item array
 	int _skippedIndex = 0;					   // Count of skipped items
 	std::map<int, int> _msgTypeTotals;		   // Collection of totals for each message type
-	int _readErrorCount = 0;				   // Total number of read errors
 	int _missedBytesDuringError = 0;		   // Number of bytes we received during the error
 	int _maxBufferSize = 0;					   // Maximum size of the serial buffer
 	bool _startup = true;					   // Are we starting up?
-	int32_t _gpsResetCount = 0;				   // Number GPS resets
-	int32_t _gpsReinitialize = 0;			   // Number GPS initializations
-	int32_t _asciiMsgCount = 0;				   // Number ASCII of packets received
-	int32_t _bytesReceived = 0;				   // Total number of received GPS bytes
+	const SemaphoreHandle_t _snapshotMutex;	   // Thread safe snapshot access
+	GpsSnapshot _snapshot = {};				   // Last published state
+	volatile bool _fresetRequested = false;	   // Web task wants a factory reset
 
 public:
 	MyDisplay &_display;
@@ -92,22 +110,38 @@ public:
 	bool _gpsConnected = false; // Are we receiving GPS data from GPS unit (Does not mean we have location)
 	NTRIPServer *_pNtripServer0, *_pNtripServer1, *_pNtripServer2;
 
-	GpsParser(MyDisplay &display) : _display(display), _commandQueue([this](std::string str)
+	GpsParser(MyDisplay &display) : _logHistory(LogClockWall),
+									_snapshotMutex(xSemaphoreCreateMutex()),
+									_display(display), _commandQueue([this](std::string str)
 																	 { LogX(str); })
 	{
-		_logHistory.reserve(MAX_LOG_LENGTH);
+		if (_snapshotMutex == nullptr)
+			perror("Failed to create GPS mutex\n");
 		_timeOfLastMessage = 10000 - GPS_TIMEOUT; // Timeout in 5 seconds
 	}
 
-	inline std::vector<std::string> GetLogHistory() const { return _logHistory; }
+	///////////////////////////////////////////////////////////////////////////
+	// Copy of the log. Safe to call from any task
+	inline std::vector<std::string> GetLogHistory() const { return _logHistory.Copy(); }
+	inline const LogHistory &GetLog() const { return _logHistory; }
+
+	///////////////////////////////////////////////////////////////////////////
+	// Copy of the last published state. Safe to call from any task
+	void GetSnapshot(GpsSnapshot &snapshot) const
+	{
+		if (xSemaphoreTake(_snapshotMutex, portMAX_DELAY))
+		{
+			snapshot = _snapshot;
+			xSemaphoreGive(_snapshotMutex);
+		}
+	}
+
+	// Ask loop() to factory reset the GPS. Safe to call from any task
+	inline void RequestFReset() { _fresetRequested = true; }
+
 	inline GpsCommandQueue &GetCommandQueue() { return _commandQueue; }
 	inline const std::map<int, int> &GetMsgTypeTotals() const { return _msgTypeTotals; }
-	inline const int GetReadErrorCount() const { return _readErrorCount; }
 	inline const int GetMaxBufferSize() const { return _maxBufferSize; }
-	inline const int GetGpsBytesRec() const { return _bytesReceived; }
-	inline const int32_t GetGpsResetCount() const { return _gpsResetCount; }
-	inline const int32_t GetGpsReinitialize() const { return _gpsReinitialize; }
-	inline const int32_t GetAsciiMsgCount() const { return _asciiMsgCount; }
 	inline const bool HasGpsExpired(unsigned long millis) const { return (millis - _timeOfLastMessage) > GPS_TIMEOUT; }
 
 	/// @brief Save links to the NTRIP casters
@@ -116,6 +150,8 @@ public:
 		_pNtripServer0 = pNtripServer0;
 		_pNtripServer1 = pNtripServer1;
 		_pNtripServer2 = pNtripServer2;
+		if (!_logHistory.Allocate(LogArenaSize(LOG_ARENA_GPS)))
+			LogError(LogGps, "E111 - No memory for the GPS log");
 	}
 
 	///////////////////////////////////////////////////////////////////////////
@@ -133,9 +169,19 @@ public:
 
 		ProcessStream(stream);
 
+		// Reset asked for by the web pages
+		if (_fresetRequested)
+		{
+			_fresetRequested = false;
+			_commandQueue.IssueFReset();
+		}
+
 		// Check output command queue
 		_commandQueue.CheckForTimeouts();
 
+		if (millis() - _snapshot.Time > GPS_SNAPSHOT_MS)
+			PublishSnapshot();
+
 		// Check for loss of RTK data
 		if ((millis() - _timeOfLastMessage) > GPS_TIMEOUT)
 		{
@@ -143,8 +189,8 @@ public:
 			_gpsConnected = false;
 			_timeOfLastMessage = millis();
 			_commandQueue.StartInitialiseProcess();
-			_display.UpdateGpsStarts(true, false);
-			_gpsReinitialize++;
+			_metrics.Add(Metric::GpsTimeouts);
+			_display.RefreshGpsStarts();
 		}
 		return _gpsConnected;
 	}
@@ -163,7 +209,7 @@ public:
 		if (available > GPS_BUFFER_SIZE - 10)
 			LogX("GPS - Serial Buffer overflow");
 
-		_bytesReceived += available;
+		_metrics.Add(Metric::GpsBytes, available);
 
 		// Limit the number of bytes we read
 		available = min(available, MAX_BUFF);
@@ -180,10 +226,8 @@ public:
 
 			_buildState = BuildStateNone;
 
-#ifdef VERBOSE
-			LogX(StringPrintf("IN  BUFF %d : %s", _binaryIndex, HexDump(_byteArray, _binaryIndex).c_str()));
-			LogX(StringPrintf("IN  DATA %d : %s", n, HexDump(pData, available).c_str()));
-#endif
+			LogVerbose(LogGps, "IN  BUFF %d : %H", _binaryIndex, LogBytes(_byteArray, _binaryIndex));
+			LogVerbose(LogGps, "IN  DATA %d : %H", n, LogBytes(pData, available));
 
 			// Output is made up of the existing buffer less the first byte (_binaryIndex - 1)
 			// .. plus what remains in the new data array (available - n)
@@ -218,9 +262,7 @@ public:
 			}
 			_binaryIndex = 0;
 
-#ifdef VERBOSE
-			LogX(StringPrintf("OUT DATA %d : %s", n, HexDump(pData, available).c_str()));
-#endif
+			LogVerbose(LogGps, "OUT DATA %d : %H", n, LogBytes(pData, available));
 		}
 
 		delete[] pData;
@@ -273,7 +315,7 @@ public:
 
 		default:
 			AddToSkipped(ch);
-			LogX(StringPrintf("Unknown state %d", _buildState));
+			LogError(LogGps, "Unknown state %d", (int)_buildState);
 			_buildState = BuildStateNone;
 			return true;
 		}
@@ -285,7 +327,7 @@ public:
 	{
 		if (_skippedIndex >= MAX_BUFF)
 		{
-			LogX("Skip buffer overflowed");
+			LogWarn(LogGps, "Skip buffer overflowed");
 			_skippedIndex = 0;
 		}
 		_skippedArray[_skippedIndex++] = ch;
@@ -309,7 +351,7 @@ public:
 			}
 			if (lengthPrefix != 0)
 			{
-				LogX(StringPrintf("Binary length prefix too big %02x %02x - %d", _byteArray[0], _byteArray[1], lengthPrefix));
+				LogWarn(LogGps, "Binary length prefix too big %02x %02x - %d", _byteArray[0], _byteArray[1], lengthPrefix);
 				return false;
 			}
 		}
@@ -323,13 +365,13 @@ public:
 			auto lengthPrefix = GetUInt(8, 14 - 8);
 			if (lengthPrefix != 0)
 			{
-				LogX(StringPrintf("Binary length prefix too big %02x %02x - %d", _byteArray[0], _byteArray[1], lengthPrefix));
+				LogWarn(LogGps, "Binary length prefix too big %02x %02x - %d", _byteArray[0], _byteArray[1], lengthPrefix);
 				return false;
 			}
 			_binaryLength = GetUInt(14, 10) + 6;
 			if (_binaryLength == 0 || _binaryLength >= MAX_BUFF)
 			{
-				LogX(StringPrintf("Binary length too big %d", _binaryLength));
+				LogWarn(LogGps, "Binary length too big %d", _binaryLength);
 				return false;
 			}
 			// LogX(StringPrintf("Buffer length %d", _binaryLength));
@@ -338,7 +380,7 @@ public:
 		if (_binaryIndex >= MAX_BUFF)
 		{
 			// Dump as HEX
-			LogX(StringPrintf("Buffer overflow %d", _binaryIndex));
+			LogWarn(LogGps, "Buffer overflow %d", _binaryIndex);
 			return false;
 		}
 
@@ -351,20 +393,21 @@ public:
 			auto type = GetUInt(24, 12);
 			if (parity != calculated)
 			{
-				LogX(StringPrintf("Checksum %d (%06x != %06x) [%d] %s", type, parity, calculated, _binaryIndex, HexDump(_byteArray, _binaryIndex).c_str()));
+				LogWarn(LogGps, "Checksum %d (%06x != %06x) [%d] %H", type, parity, calculated, _binaryIndex, LogBytes(_byteArray, _binaryIndex));
 				return false;
 			}
 
 			// Record things are good again
 			_gpsConnected = true;
 			_timeOfLastMessage = millis();
-			_display.IncrementGpsPackets();
+			_metrics.Add(Metric::GpsPackets);
+			_display.RefreshGpsPackets();
 
 			// Log what we missed
 			if (_missedBytesDuringError > 0)
 			{
-				_readErrorCount++;
-				LogX(StringPrintf(" >> E: %d - Skipped %d", _readErrorCount, _missedBytesDuringError));
+				_metrics.Add(Metric::GpsReadErrors);
+				LogWarn(LogGps, " >> E: %u - Skipped %d", _metrics.Get(Metric::GpsReadErrors), _missedBytesDuringError);
 				_missedBytesDuringError = 0;
 			}
 
@@ -374,9 +417,7 @@ public:
 			_pNtripServer2->EnqueueData(_byteArray, _binaryLength);
 
 			_msgTypeTotals[type]++;
-#ifdef VERBOSE
-			Serial.Printf("G %d [%d]\n", type, _binaryLength));
-#endif
+			LogVerbose(LogGps, "G %d [%d]", type, _binaryLength);
 			_buildState = BuildStateNone;
 		}
 		return true;
@@ -408,7 +449,7 @@ public:
 
 		if (_binaryIndex > 254)
 		{
-			LogX(StringPrintf("RTK ASCII Overflowing %s", HexAsciDump(_byteArray, _binaryIndex).c_str()));
+			LogWarn(LogGps, "RTK ASCII Overflowing %H", LogBytes(_byteArray, _binaryIndex));
 			_buildState = BuildStateNone;
 			return false;
 		}
@@ -417,7 +458,7 @@ public:
 
 		if (ch < 32 || ch > 126)
 		{
-			LogX(StringPrintf("RTK Non-ASCII %s", HexAsciDump(_byteArray, _binaryIndex).c_str()));
+			LogWarn(LogGps, "RTK Non-ASCII %H", LogBytes(_byteArray, _binaryIndex));
 			_buildState = BuildStateNone;
 			return false;
 		}
@@ -446,7 +487,7 @@ public:
 		// Is the line too long
 		if (_binaryIndex > 254)
 		{
-			LogX(StringPrintf("ASCII Overflowing %s", HexAsciDump(_byteArray, _binaryIndex).c_str()));
+			LogWarn(LogGps, "ASCII Overflowing %H", LogBytes(_byteArray, _binaryIndex));
 			_buildState = BuildStateNone;
 			return false;
 		}
@@ -457,7 +498,7 @@ public:
 		// Check for non ascii characters
 		if (ch < 32 || ch > 126)
 		{
-			LogX(StringPrintf("Non-ASCII %s", HexDump(_byteArray, _binaryIndex).c_str()));
+			LogWarn(LogGps, "Non-ASCII %H", LogBytes(_byteArray, _binaryIndex));
 			_buildState = BuildStateNone;
 			return false;
 		}
@@ -492,7 +533,7 @@ public:
 			LogX("W700 - GPS ASCII Too short");
 			return;
 		}
-		_asciiMsgCount++;
+		_metrics.Add(Metric::GpsAsciiPackets);
 
 		if (line[0] == '$' && line[1] == 'G')
 			Serial.printf("GPS <- '%s'\n", line.c_str());
@@ -508,8 +549,8 @@ public:
 		if (_commandQueue.HasDeviceReset(line))
 		{
 			_timeOfLastMessage = millis();
-			_gpsResetCount++;
-			_display.UpdateGpsStarts(true, false);
+			_metrics.Add(Metric::GpsResets);
+			_display.RefreshGpsStarts();
 			return;
 		}
 
@@ -531,13 +572,40 @@ private:
 	void LogX(std::string text)
 	{
 		// Normal log
-		auto s = Logln(text.c_str());
-		if (s.length() > MAX_LOG_ROW_LENGTH)
-			_logHistory.push_back(s.substr(0, MAX_LOG_ROW_LENGTH) + "...");
-		else
-			_logHistory.push_back(s);
+		_logHistory.Add(Logln(text.c_str()));
+	}
 
-		TruncateLog(_logHistory);
+	///////////////////////////////////////////////////////////////////////////////
+	// Copy the state shown on the web pages. Only called from loop()
+	void PublishSnapshot()
+	{
+		if (!xSemaphoreTake(_snapshotMutex, portMAX_DELAY))
+			return;
+		strlcpy(_snapshot.DeviceType, _commandQueue.GetDeviceType().c_str(), GPS_SNAPSHOT_TEXT);
+		strlcpy(_snapshot.DeviceFirmware, _commandQueue.GetDeviceFirmware().c_str(), GPS_SNAPSHOT_TEXT);
+		strlcpy(_snapshot.DeviceSerial, _commandQueue.GetDeviceSerial().c_str(), GPS_SNAPSHOT_TEXT);
+		_snapshot.MaxBufferSize = _maxBufferSize;
+		_snapshot.TypeCount = 0;
+		for (const auto &pair : _msgTypeTotals)
+		{
+			if (_snapshot.TypeCount >= GPS_SNAPSHOT_TYPES)
+				break;
+			_snapshot.Types[_snapshot.TypeCount] = pair.first;
+			_snapshot.Counts[_snapshot.TypeCount++] = pair.second;
+		}
+		_snapshot.Time = millis();
+		xSemaphoreGive(_snapshotMutex);
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	// LogX without formatting. The format must be a literal (See LogRecord.h)
+	template <typename... Args>
+	void LogB(const char *format, Args... args)
+	{
+		LogEncoder record(format, LOG_SOURCE_NONE);
+		record.PutAll(args...);
+		Logln(record);
+		_logHistory.Add(record);
 	}
 
 	///////////////////////////////////////////////////////////////////////////////
@@ -548,12 +616,10 @@ private:
 			return;
 
 		_skippedArray[_skippedIndex] = 0;
-		std::string logTest;
 		if (IsAllAscii(_skippedArray, _skippedIndex))
-			logTest = StringPrintf("Skipped [%d] %s", _skippedIndex, _skippedArray).c_str();
+			LogInfo(LogGps, "Skipped [%d] %s", _skippedIndex, (const char *)_skippedArray);
 		else
-			logTest = StringPrintf("Skipped [%d] %s", _skippedIndex, HexDump(_skippedArray, _skippedIndex).c_str());
-		LogX(logTest.c_str());
+			LogInfo(LogGps, "Skipped [%d] %H", _skippedIndex, LogBytes(_skippedArray, _skippedIndex));
 
 		_missedBytesDuringError += _skippedIndex;
 		_skippedIndex = 0;
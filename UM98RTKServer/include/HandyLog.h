@@ -2,15 +2,24 @@
 
 #include <string>
 #include <vector>
+#include "LogRecord.h"
 
 void SetupLog();
+uint32_t LogArenaSize(uint32_t wanted);
 std::string Logln(const char *msg, bool timePrefix = true);
 
+void Logln(const LogEncoder &record);
+
 template<typename... Args>
 void Logf(const std::string& format, Args... args);
 
+template<typename... Args>
+void LogB(const char *format, Args... args);
+
 const std::string Uptime(unsigned long millis);
-const void TruncateLog( std::vector<std::string> &log );
 const std::vector<std::string> CopyMainLog();
 
+class LogHistory;
+const LogHistory &GetMainLog();
+
 #include "HandyLog.tpp"
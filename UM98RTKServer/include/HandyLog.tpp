@@ -24,3 +24,13 @@ void Logf(const std::string& format, Args... args)
 	Logln(std::string(buf.get(), buf.get() + size - 1).c_str());  // We don't want the '\0' inside
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// Log without formatting. The format must be a literal (See LogRecord.h)
+template<typename... Args>
+void LogB(const char *format, Args... args)
+{
+	LogEncoder record(format, LOG_SOURCE_NONE);
+	record.PutAll(args...);
+	Logln(record);
+}
+
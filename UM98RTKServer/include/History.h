@@ -25,14 +25,20 @@ private:
 	unsigned long _timeOfLastTemperature; // Time of last temperature reading
 
 	// Ntrip send history
-	std::vector<int> _sendMicroSeconds[RTK_SERVERS]; // Collection of send times
-	unsigned int _lastMeanTimer[RTK_SERVERS];		 // Last mean time for each server
-	long _totalSendTimes[RTK_SERVERS];				 // Total send times for each server
-	long _totalSendCount[RTK_SERVERS];				 // Total send count for each server
+	int _sendMicroSeconds[RTK_SERVERS][AVERAGE_SEND_TIMERS]; // Ring of send times
+	int _sendHead[RTK_SERVERS];								 // Next slot to write in the ring
+	int _sendCount[RTK_SERVERS];							 // Slots used in the ring
+	unsigned int _lastMeanTimer[RTK_SERVERS];				 // Last mean time for each server
+	long _totalSendTimes[RTK_SERVERS];						 // Total send times for each server
+	long _totalSendCount[RTK_SERVERS];						 // Total send count for each server
+	SemaphoreHandle_t _sendMutex;							 // Casters write the rings while the web and display read them
 
 public:
-	History()
+	History() : _sendMutex(xSemaphoreCreateMutex())
 	{
+		if (_sendMutex == nullptr)
+			perror("Failed to create history mutex\n");
+
 		// Setup to read the temperature on first loop
 		_timeOfLastTemperature -= TEMP_INTERVAL_MS;
 
@@ -40,13 +46,33 @@ public:
 		for (size_t i = 0; i < TEMP_HISTORY_SIZE; i++)
 			_tempHistory[i] = 0;
 
-		// Reserve space for NTRIP lists
+		// Empty NTRIP rings
 		for (int i = 0; i < RTK_SERVERS; i++)
-			_sendMicroSeconds[i].reserve(AVERAGE_SEND_TIMERS);
+		{
+			_sendHead[i] = 0;
+			_sendCount[i] = 0;
+		}
 	}
 
 	const char *GetTemperatures() const { return _tempHistory; } // Get the temperature history
-	inline const std::vector<int> &GetNtripSendTime(int index) const { return _sendMicroSeconds[index]; }
+
+	/////////////////////////////////////////////////////////////////////////////////
+	// Copy the send times for a server oldest first
+	// .. pTimes must hold AVERAGE_SEND_TIMERS values. Returns the number copied
+	int CopyNtripSendTimes(int index, int *pTimes)
+	{
+		if (0 > index || index >= RTK_SERVERS)
+			return 0;
+		if (!xSemaphoreTake(_sendMutex, portMAX_DELAY))
+			return 0;
+		int count = _sendCount[index];
+		int start = (_sendHead[index] - count + AVERAGE_SEND_TIMERS) % AVERAGE_SEND_TIMERS;
+		int first = min(count, AVERAGE_SEND_TIMERS - start);
+		memcpy(pTimes, _sendMicroSeconds[index] + start, first * sizeof(int));
+		memcpy(pTimes + first, _sendMicroSeconds[index], (count - first) * sizeof(int));
+		xSemaphoreGive(_sendMutex);
+		return count;
+	}
 
 	/////////////////////////////////////////////////////////////////////////////////
 	// Check the temperature sensor and return the temperature in Celsius
@@ -111,26 +137,25 @@ public:
 		_totalSendCount[index] = 0;
 		_lastMeanTimer[index] = millis();
 
-		// Add the new mean value
-		_sendMicroSeconds[index].push_back(mean);
-		while (_sendMicroSeconds[index].size() > AVERAGE_SEND_TIMERS)
-			_sendMicroSeconds[index].erase(_sendMicroSeconds[index].begin());
+		// Add the new mean value. The oldest is overwritten when full
+		if (!xSemaphoreTake(_sendMutex, portMAX_DELAY))
+			return;
+		_sendMicroSeconds[index][_sendHead[index]] = mean;
+		_sendHead[index] = (_sendHead[index] + 1) % AVERAGE_SEND_TIMERS;
+		if (_sendCount[index] < AVERAGE_SEND_TIMERS)
+			_sendCount[index]++;
+		xSemaphoreGive(_sendMutex);
 	}
 
 	///////////////////////////////////////////////////////////////////////////////
 	// Get the Median send time without sorting the list
 	int MedianSendTime(int index)
 	{
-		if (0 > index || index >= RTK_SERVERS)
-			return 0;
-		if (_sendMicroSeconds[index].size() < 1)
-			return 0;
-		// for (int n : _sendMicroSeconds[index])
-		// 	total += n;
-		// return total / _sendMicroSeconds[index].size();
-
 		// Make a sorted copy of the list
-		std::vector<int> sortedList = _sendMicroSeconds[index];
+		std::vector<int> sortedList(AVERAGE_SEND_TIMERS);
+		sortedList.resize(CopyNtripSendTimes(index, sortedList.data()));
+		if (sortedList.empty())
+			return 0;
 		std::sort(sortedList.begin(), sortedList.end());
 
 		// Get the median value
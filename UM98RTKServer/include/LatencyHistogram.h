@@ -0,0 +1,197 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+
+// Log-linear buckets. Values below 16us get a bucket each, above that each
+// .. power of two is split into 8 buckets (12.5% resolution) up to ~16 seconds
+#define LATENCY_LINEAR_BUCKETS 16
+#define LATENCY_SUB_BITS 3
+#define LATENCY_MAX_POWER 24
+#define LATENCY_BUCKETS (LATENCY_LINEAR_BUCKETS + (LATENCY_MAX_POWER - 3) * (1 << LATENCY_SUB_BITS))
+
+// Length of the recent window shown next to the lifetime figures
+#define LATENCY_WINDOW_MS 60000
+
+///////////////////////////////////////////////////////////////////////////////
+// Percentiles worked out from a copy of the histogram
+struct LatencySummary
+{
+	uint32_t Count = 0;	  // Frames recorded (Including expired and dropped)
+	uint32_t P50 = 0;	  // Percentiles (us)
+	uint32_t P90 = 0;
+	uint32_t P99 = 0;
+	uint32_t Max = 0;
+	uint32_t Expired = 0; // Frames that missed their deadline
+	uint32_t Dropped = 0; // Frames pushed out by a full queue
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Fixed bucket histogram of latencies in microseconds
+// .. Frames that are sent are recorded at their time on the wire. Frames that
+// .. expire or are dropped are recorded at their age when thrown away so the
+// .. tail is not hidden, and are also counted on their own.
+// .. Kept for the life of the caster and for the last complete window. Any
+// .. task may record. Only the caster task rotates the window. Readers copy
+// .. with a sequence check so a rotation never gives a half cleared window
+class LatencyHistogram
+{
+private:
+	struct Counts
+	{
+		std::atomic<uint32_t> Buckets[LATENCY_BUCKETS];
+		std::atomic<uint32_t> Total;
+		std::atomic<uint32_t> Max;
+		std::atomic<uint32_t> Expired;
+		std::atomic<uint32_t> Dropped;
+	};
+
+	Counts _lifetime = {};
+	Counts _windows[2] = {};			   // One filling, one complete
+	std::atomic<uint8_t> _current = {0};   // Window being filled
+	std::atomic<uint32_t> _sequence = {0}; // Odd while the window rotates
+	unsigned long _windowStart = 0;		   // Caster task only
+
+public:
+	///////////////////////////////////////////////////////////////////////////
+	// Add a sample for a frame that was sent
+	void Record(uint32_t micros)
+	{
+		Add(_lifetime, micros);
+		Add(_windows[_current.load(std::memory_order_relaxed)], micros);
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Add a frame that missed its deadline. Micros is its age when dropped
+	void RecordExpired(uint32_t micros)
+	{
+		Record(micros);
+		_lifetime.Expired.fetch_add(1, std::memory_order_relaxed);
+		_windows[_current.load(std::memory_order_relaxed)].Expired.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Add a frame the full queue pushed out. Micros is its age when dropped
+	void RecordDropped(uint32_t micros)
+	{
+		Record(micros);
+		_lifetime.Dropped.fetch_add(1, std::memory_order_relaxed);
+		_windows[_current.load(std::memory_order_relaxed)].Dropped.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Start a new window when the current one is full. Call from the caster task
+	void Rotate(unsigned long nowMs)
+	{
+		if (nowMs - _windowStart < LATENCY_WINDOW_MS)
+			return;
+		_windowStart = nowMs;
+
+		// Clear the old complete window and start filling it
+		uint8_t next = 1 - _current.load(std::memory_order_relaxed);
+		_sequence.fetch_add(1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		Clear(_windows[next]);
+		_current.store(next, std::memory_order_relaxed);
+		_sequence.fetch_add(1, std::memory_order_release);
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Work out the percentiles
+	// .. window true for the last complete window, false for the lifetime
+	void Summarise(LatencySummary &summary, bool window) const
+	{
+		uint32_t buckets[LATENCY_BUCKETS];
+		uint32_t sequence;
+		do
+		{
+			sequence = _sequence.load(std::memory_order_acquire);
+			const Counts &counts = window ? _windows[1 - _current.load(std::memory_order_relaxed)] : _lifetime;
+			Copy(counts, buckets, summary);
+			std::atomic_thread_fence(std::memory_order_acquire);
+		} while ((sequence & 1) != 0 || sequence != _sequence.load(std::memory_order_relaxed));
+
+		summary.P50 = Percentile(buckets, summary, 50);
+		summary.P90 = Percentile(buckets, summary, 90);
+		summary.P99 = Percentile(buckets, summary, 99);
+	}
+
+private:
+	static void Add(Counts &counts, uint32_t micros)
+	{
+		counts.Buckets[BucketOf(micros)].fetch_add(1, std::memory_order_relaxed);
+		counts.Total.fetch_add(1, std::memory_order_relaxed);
+		uint32_t max = counts.Max.load(std::memory_order_relaxed);
+		while (micros > max && !counts.Max.compare_exchange_weak(max, micros, std::memory_order_relaxed))
+			;
+	}
+
+	static void Clear(Counts &counts)
+	{
+		for (auto &bucket : counts.Buckets)
+			bucket.store(0, std::memory_order_relaxed);
+		counts.Total.store(0, std::memory_order_relaxed);
+		counts.Max.store(0, std::memory_order_relaxed);
+		counts.Expired.store(0, std::memory_order_relaxed);
+		counts.Dropped.store(0, std::memory_order_relaxed);
+	}
+
+	static void Copy(const Counts &counts, uint32_t *pBuckets, LatencySummary &summary)
+	{
+		for (int n = 0; n < LATENCY_BUCKETS; n++)
+			pBuckets[n] = counts.Buckets[n].load(std::memory_order_relaxed);
+		summary.Count = counts.Total.load(std::memory_order_relaxed);
+		summary.Max = counts.Max.load(std::memory_order_relaxed);
+		summary.Expired = counts.Expired.load(std::memory_order_relaxed);
+		summary.Dropped = counts.Dropped.load(std::memory_order_relaxed);
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Get the value at the percentile (0 to 100)
+	// .. Returns the upper edge of the bucket holding the sample
+	static uint32_t Percentile(const uint32_t *pBuckets, const LatencySummary &summary, double percent)
+	{
+		// Use the bucket total as a sample may land between reading the buckets and the count
+		uint32_t total = 0;
+		for (int n = 0; n < LATENCY_BUCKETS; n++)
+			total += pBuckets[n];
+		if (total == 0)
+			return 0;
+		uint32_t target = (uint32_t)ceil(total * percent / 100.0);
+		if (target < 1)
+			target = 1;
+		uint32_t seen = 0;
+		for (int n = 0; n < LATENCY_BUCKETS; n++)
+		{
+			seen += pBuckets[n];
+			if (seen >= target)
+				return n == LATENCY_BUCKETS - 1 ? summary.Max : min(UpperEdge(n), summary.Max);
+		}
+		return summary.Max;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Find the bucket for a value
+	static int BucketOf(uint32_t value)
+	{
+		if (value < LATENCY_LINEAR_BUCKETS)
+			return value;
+		int power = 31 - __builtin_clz(value);
+		if (power > LATENCY_MAX_POWER)
+			return LATENCY_BUCKETS - 1;
+		int sub = (value >> (power - LATENCY_SUB_BITS)) & ((1 << LATENCY_SUB_BITS) - 1);
+		return LATENCY_LINEAR_BUCKETS + (power - 4) * (1 << LATENCY_SUB_BITS) + sub;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Largest value that lands in the bucket
+	static uint32_t UpperEdge(int bucket)
+	{
+		if (bucket < LATENCY_LINEAR_BUCKETS)
+			return bucket;
+		int power = (bucket - LATENCY_LINEAR_BUCKETS) / (1 << LATENCY_SUB_BITS) + 4;
+		int sub = (bucket - LATENCY_LINEAR_BUCKETS) % (1 << LATENCY_SUB_BITS);
+		uint32_t base = (1UL << power) + ((uint32_t)sub << (power - LATENCY_SUB_BITS));
+		return base + (1UL << (power - LATENCY_SUB_BITS)) - 1;
+	}
+};
@@ -0,0 +1,268 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+#include <string>
+#include <vector>
+
+// The PC checks set their own line limits (See Tools/LogHistoryCheck.cpp)
+#ifndef MAX_LOG_LENGTH
+#include "Global.h"
+#endif
+#include "LogRecord.h"
+
+// Longest line kept (Longer lines are cut and end with ...)
+#define LOG_LINE_MAX (MAX_LOG_ROW_LENGTH + 3)
+
+// Largest payload of any record
+#define LOG_PAYLOAD_MAX (LOG_RECORD_MAX > LOG_LINE_MAX ? LOG_RECORD_MAX : LOG_LINE_MAX)
+
+// Smallest arena tried when memory is short (Holds a few of the largest records)
+#define LOG_ARENA_MIN (2 * 1024)
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief The last few log lines in a fixed byte arena
+/// .. Any task can add a line without locking. Each line reserves its space
+/// .. with an atomic add, so adding is O(1) and the oldest lines are simply
+/// .. written over. Readers copy a line out then check it was not written
+/// .. over while they copied (Position and a hash), so they never hold up the
+/// .. writers.
+/// .. Every line gets a sequence number that does not change as old lines
+/// .. are dropped, so a reader can stop and carry on from where it was.
+/// .. Lines are either text or a LogRecord that is formatted when read.
+/// .. Nothing is kept until Allocate() is called from setup()
+class LogHistory
+{
+private:
+	// Start of each record in the arena. Text follows
+	struct Header
+	{
+		uint32_t Seq;	// Sequence number
+		uint8_t Kind;	// RecordText or RecordBinary
+		uint8_t Length; // Bytes of payload
+		uint16_t Check; // Hash of Seq and payload (Catches a lapped writer finishing late)
+	};
+
+	enum RecordKind
+	{
+		RecordText,
+		RecordBinary, // LogRecord
+	};
+
+	// Result of reading one line
+	enum ReadResult
+	{
+		ReadOk,
+		ReadGone,	  // Written over
+		ReadNotReady, // Still being written
+	};
+
+	uint8_t *_pArena = nullptr;					  // Records one after the other, wrapping at the end
+	uint32_t _size = 0;							  // Size of the arena (0 until allocated)
+	const LogClock _clock;						  // Time at the start of formatted records
+	std::atomic<uint32_t> _head;				  // Bytes ever reserved. The next record starts at _head % _size
+	std::atomic<uint32_t> _nextSeq;				  // Sequence of the next line
+	std::atomic<uint32_t> _index[MAX_LOG_LENGTH]; // Arena position of line seq at [seq % MAX_LOG_LENGTH]
+
+public:
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief clock must match the time the text lines start with
+	LogHistory(LogClock clock = LogClockUptime)
+		: _clock(clock), _head(0), _nextSeq(0)
+	{
+		for (auto &position : _index)
+			position.store(0, std::memory_order_relaxed);
+	}
+	~LogHistory() { free(_pArena); }
+
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief Allocate the arena once, before any other task uses the log
+	/// .. Rounds down to a power of 2 and halves until malloc succeeds
+	/// @return false if not even LOG_ARENA_MIN could be had
+	bool Allocate(uint32_t arenaBytes)
+	{
+		if (_size != 0)
+			return true;
+		uint32_t size = LOG_ARENA_MIN;
+		while (size * 2 <= arenaBytes)
+			size *= 2;
+		for (; size >= LOG_ARENA_MIN; size /= 2)
+		{
+			_pArena = (uint8_t *)malloc(size);
+			if (_pArena == nullptr)
+				continue;
+
+			// No record can match a sequence number until it is written
+			memset(_pArena, 0xFF, size);
+			_size = size;
+			return true;
+		}
+		return false;
+	}
+
+	inline uint32_t GetArenaSize() const { return _size; }
+
+	inline void Add(const std::string &text) { Add(text.c_str(), text.length()); }
+
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief Add a line. Long lines are cut short
+	void Add(const char *text, size_t length)
+	{
+		bool cut = length > MAX_LOG_ROW_LENGTH;
+		if (cut)
+			length = MAX_LOG_ROW_LENGTH;
+		Append(RecordText, text, length, cut ? "..." : "", cut ? 3 : 0);
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief Add a record from a LogEncoder. It is formatted when read
+	inline void Add(const LogEncoder &record)
+	{
+		Append(RecordBinary, record.Data(), record.Length(), "", 0);
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief Copy of every line (For the display and log file)
+	std::vector<std::string> Copy() const
+	{
+		std::vector<std::string> copyVector;
+		Visit(0, [&](uint32_t, const char *line)
+			  {
+				  copyVector.push_back(line);
+				  return true; });
+		return copyVector;
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief Call visit(seq, line) for each line from sequence since onwards
+	/// .. while visit returns true. Lines written over while visiting are
+	/// .. skipped. Stops at a line still being written
+	/// @return Sequence of the first line not visited
+	template <typename TVisit>
+	uint32_t Visit(uint32_t since, TVisit visit) const
+	{
+		char line[LOG_LINE_MAX + 1];
+		uint32_t next = _nextSeq.load(std::memory_order_acquire);
+		uint32_t seq = max(since, next - min(next, (uint32_t)MAX_LOG_LENGTH));
+		for (; seq < next; seq++)
+		{
+			ReadResult result = Read(seq, line);
+			if (result == ReadGone)
+				continue;
+			if (result == ReadNotReady || !visit(seq, (const char *)line))
+				break;
+		}
+		return seq;
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief Sequence of the oldest line kept and of the next line to be added
+	void GetRange(uint32_t &first, uint32_t &next) const
+	{
+		next = _nextSeq.load(std::memory_order_acquire);
+		first = next;
+		Visit(0, [&](uint32_t seq, const char *)
+			  {
+				  first = seq;
+				  return false; });
+	}
+
+private:
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief Reserve space and write the payload in two parts
+	void Append(uint8_t kind, const void *pData, size_t length, const char *pTail, size_t tailLength)
+	{
+		if (_size == 0)
+			return;
+		Header header;
+		header.Kind = kind;
+		header.Length = length + tailLength;
+		uint32_t recordSize = (sizeof(Header) + header.Length + 3) & ~3u;
+
+		// Reserve. Nothing else is shared with other writers. A reader that sees
+		// .. any of the new bytes must also see the reservation
+		header.Seq = _nextSeq.fetch_add(1, std::memory_order_relaxed);
+		uint32_t position = _head.fetch_add(recordSize, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		uint32_t hash = Hash(Hash(HashStart(header.Seq), pData, length), pTail, tailLength);
+		header.Check = (uint16_t)(hash ^ (hash >> 16));
+
+		// Payload before header so a reader never sees a header with old payload
+		CopyIn(position + sizeof(Header), pData, length);
+		CopyIn(position + sizeof(Header) + length, pTail, tailLength);
+		CopyIn(position, &header, sizeof(Header));
+		_index[header.Seq % MAX_LOG_LENGTH].store(position, std::memory_order_release);
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief Copy one line out. Checks the space was not reused while copying
+	ReadResult Read(uint32_t seq, char *pLine) const
+	{
+		uint32_t position = _index[seq % MAX_LOG_LENGTH].load(std::memory_order_acquire);
+		if (IsOverwritten(seq, position))
+			return ReadGone;
+
+		Header header;
+		uint8_t payload[LOG_PAYLOAD_MAX];
+		CopyOut(position, &header, sizeof(Header));
+		if (header.Seq != seq || header.Length > sizeof(payload))
+			return ReadNotReady;
+		CopyOut(position + sizeof(Header), payload, header.Length);
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (IsOverwritten(seq, position))
+			return ReadGone;
+
+		// A writer lapped while copying may have finished over this line
+		uint32_t hash = Hash(HashStart(seq), payload, header.Length);
+		if (header.Check != (uint16_t)(hash ^ (hash >> 16)))
+			return ReadGone;
+
+		// Text is copied, records are formatted now
+		if (header.Kind == RecordBinary)
+		{
+			LogFormat(payload, header.Length, pLine, LOG_LINE_MAX + 1, _clock);
+		}
+		else
+		{
+			size_t length = min((size_t)header.Length, (size_t)LOG_LINE_MAX);
+			memcpy(pLine, payload, length);
+			pLine[length] = 0;
+		}
+		return ReadOk;
+	}
+
+	// FNV-1a
+	static inline uint32_t HashStart(uint32_t seq) { return 2166136261u ^ seq; }
+	static uint32_t Hash(uint32_t hash, const void *pData, size_t length)
+	{
+		const uint8_t *p = (const uint8_t *)pData;
+		for (size_t n = 0; n < length; n++)
+			hash = (hash ^ p[n]) * 16777619u;
+		return hash;
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief Has a later writer reserved the arena space or the index slot
+	inline bool IsOverwritten(uint32_t seq, uint32_t position) const
+	{
+		return _head.load(std::memory_order_relaxed) - position > _size ||
+			   _nextSeq.load(std::memory_order_relaxed) - seq >= MAX_LOG_LENGTH;
+	}
+
+	void CopyIn(uint32_t position, const void *pData, size_t length)
+	{
+		uint32_t at = position & (_size - 1);
+		size_t part = min(length, (size_t)(_size - at));
+		memcpy(_pArena + at, pData, part);
+		memcpy(_pArena, (const uint8_t *)pData + part, length - part);
+	}
+
+	void CopyOut(uint32_t position, void *pData, size_t length) const
+	{
+		uint32_t at = position & (_size - 1);
+		size_t part = min(length, (size_t)(_size - at));
+		memcpy(pData, _pArena + at, part);
+		memcpy((uint8_t *)pData + part, _pArena, length - part);
+	}
+};
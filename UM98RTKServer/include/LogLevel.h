@@ -0,0 +1,137 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+#include <string>
+
+#include "Global.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// Log levels and modules
+// .. Each module has a level set at run time (Settings page). A line is only
+// .. logged if its level is at or below the level of its module. The check is
+// .. made before the arguments are evaluated.
+// .. Levels above LOG_COMPILE_LEVEL (Global.h) are not built at all.
+// .. The lines use the LogB in scope, so in the GPS parser and casters they
+// .. also go in their own log. The format must be a literal (See LogRecord.h)
+//
+//		LogVerbose(LogNtripModule(_index), "RTCM %d queued", pItem->getType());
+///////////////////////////////////////////////////////////////////////////////
+
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN 2
+#define LOG_LEVEL_INFO 3
+#define LOG_LEVEL_DEBUG 4
+#define LOG_LEVEL_VERBOSE 5
+
+// Level of each module until changed on the settings page
+#define LOG_LEVEL_DEFAULT LOG_LEVEL_INFO
+
+enum LogModule : uint8_t
+{
+	LogMain,
+	LogGps,
+	LogNtrip0, // One for each caster
+	LogWeb = LogNtrip0 + RTK_SERVERS,
+	LogFile,
+	LogWifi,
+	LogModuleCount
+};
+
+inline LogModule LogNtripModule(int index) { return (LogModule)(LogNtrip0 + index); }
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Run time level of each module. Safe from any task
+class LogLevels
+{
+private:
+	std::atomic<uint8_t> _levels[LogModuleCount];
+
+public:
+	LogLevels()
+	{
+		for (auto &level : _levels)
+			level.store(LOG_LEVEL_DEFAULT, std::memory_order_relaxed);
+	}
+
+	inline bool Enabled(LogModule module, uint8_t level) const
+	{
+		return level <= _levels[module].load(std::memory_order_relaxed);
+	}
+	inline uint8_t Get(LogModule module) const { return _levels[module].load(std::memory_order_relaxed); }
+	inline void Set(LogModule module, uint8_t level)
+	{
+		_levels[module].store(min(level, (uint8_t)LOG_LEVEL_VERBOSE), std::memory_order_relaxed);
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief Name shown on the settings page
+	static const char *ModuleName(int module)
+	{
+		static const char *names[] = {"Main", "GPS", "NTRIP 1", "NTRIP 2", "NTRIP 3", "Web", "File", "WiFi"};
+		static_assert(sizeof(names) / sizeof(names[0]) == LogModuleCount, "A name for each module");
+		return names[module];
+	}
+	static const char *LevelName(int level)
+	{
+		static const char *names[] = {"None", "Error", "Warning", "Info", "Debug", "Verbose"};
+		return names[level];
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief Saved as one digit per module (ie "33333333")
+	std::string ToString() const
+	{
+		std::string text;
+		for (int n = 0; n < LogModuleCount; n++)
+			text += (char)('0' + Get((LogModule)n));
+		return text;
+	}
+	void FromString(const std::string &text)
+	{
+		for (int n = 0; n < LogModuleCount && n < (int)text.length(); n++)
+			if (isdigit(text[n]))
+				Set((LogModule)n, text[n] - '0');
+	}
+};
+
+extern LogLevels _logLevels;
+
+// Log if the module level allows. Arguments are not evaluated otherwise
+#define LOG_AT(module, level, ...)                   \
+	do                                               \
+	{                                                \
+		if (_logLevels.Enabled((module), (level)))   \
+			LogB(__VA_ARGS__);                       \
+	} while (0)
+
+#if LOG_COMPILE_LEVEL >= LOG_LEVEL_ERROR
+#define LogError(module, ...) LOG_AT(module, LOG_LEVEL_ERROR, __VA_ARGS__)
+#else
+#define LogError(module, ...) do {} while (0)
+#endif
+
+#if LOG_COMPILE_LEVEL >= LOG_LEVEL_WARN
+#define LogWarn(module, ...) LOG_AT(module, LOG_LEVEL_WARN, __VA_ARGS__)
+#else
+#define LogWarn(module, ...) do {} while (0)
+#endif
+
+#if LOG_COMPILE_LEVEL >= LOG_LEVEL_INFO
+#define LogInfo(module, ...) LOG_AT(module, LOG_LEVEL_INFO, __VA_ARGS__)
+#else
+#define LogInfo(module, ...) do {} while (0)
+#endif
+
+#if LOG_COMPILE_LEVEL >= LOG_LEVEL_DEBUG
+#define LogDebug(module, ...) LOG_AT(module, LOG_LEVEL_DEBUG, __VA_ARGS__)
+#else
+#define LogDebug(module, ...) do {} while (0)
+#endif
+
+#if LOG_COMPILE_LEVEL >= LOG_LEVEL_VERBOSE
+#define LogVerbose(module, ...) LOG_AT(module, LOG_LEVEL_VERBOSE, __VA_ARGS__)
+#else
+#define LogVerbose(module, ...) do {} while (0)
+#endif
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <Arduino.h>
+#include <string>
+#include <time.h>
+
+///////////////////////////////////////////////////////////////////////////////
+// Deferred format log records
+// .. A record holds the uptime and clock time, a pointer to the format string and the raw
+// .. arguments. Nothing is formatted when it is logged. The text is made
+// .. when the log is read (Web page, serial or log file).
+// .. The format MUST be a string literal as only its address is kept.
+// .. Arguments are stored with a one byte type so the format is only used to
+// .. lay them out. %H prints a LogBytes() blob as hex
+//
+//		LogB("Checksum %d (%06x != %06x) %H", type, parity, crc, LogBytes(p, n));
+///////////////////////////////////////////////////////////////////////////////
+
+#define LOG_RECORD_MAX 192 // Largest record (Arguments past this are dropped)
+#define LOG_STRING_MAX 64  // Longest string argument kept
+#define LOG_BLOB_MAX 48	   // Most bytes of a blob kept
+
+// Record source. 0 and up are casters (Printed as "NTRIP n:")
+#define LOG_SOURCE_NONE (-1)
+
+// Clock times before this (2020-01-01) mean the clock was never set
+#define LOG_EPOCH_VALID 1577836800
+
+// Time printed at the start of each line. Each log uses the same clock as its text lines
+enum LogClock : uint8_t
+{
+	LogClockUptime, // "D HH:MM:SS.mmm" like Uptime()
+	LogClockWall,	// "YYYY-MM-DD HH:MM:SS" like HandyTime::LongString(). Uptime till the clock is set
+};
+
+/// @brief Raw bytes to log as hex with %H
+struct LogBlob
+{
+	const void *pData;
+	size_t Length;
+};
+inline LogBlob LogBytes(const void *pData, size_t length) { return {pData, length}; }
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Build a record in a fixed buffer
+class LogEncoder
+{
+private:
+	uint8_t _buffer[LOG_RECORD_MAX];
+	size_t _length = 0;
+
+public:
+	LogEncoder(const char *format, int8_t source)
+	{
+		uint32_t uptime = millis();
+		uint32_t epoch = (uint32_t)time(nullptr);
+		Raw(&uptime, sizeof(uptime));
+		Raw(&epoch, sizeof(epoch));
+		Raw(&format, sizeof(format));
+		Raw(&source, sizeof(source));
+	}
+
+	inline const uint8_t *Data() const { return _buffer; }
+	inline size_t Length() const { return _length; }
+
+	// Change the source once encoded (Same record in another log)
+	inline void SetSource(int8_t source) { _buffer[2 * sizeof(uint32_t) + sizeof(const char *)] = (uint8_t)source; }
+
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief Add each argument (C++11 pack expansion)
+	template <typename... Args>
+	void PutAll(Args... args)
+	{
+		int unused[] = {0, (Put(args), 0)...};
+		(void)unused;
+	}
+
+	void Put(int value) { Tagged('i', &value, 4); }
+	void Put(unsigned int value) { Tagged('u', &value, 4); }
+	void Put(long value) { Put((int)value); }
+	void Put(unsigned long value) { Put((unsigned int)value); }
+	void Put(char value) { Put((int)value); }
+	void Put(unsigned char value) { Put((int)value); }
+	void Put(signed char value) { Put((int)value); }
+	void Put(short value) { Put((int)value); }
+	void Put(unsigned short value) { Put((int)value); }
+	void Put(bool value) { Put((int)value); }
+	void Put(long long value) { Tagged('q', &value, 8); }
+	void Put(unsigned long long value) { Tagged('Q', &value, 8); }
+	void Put(double value) { Tagged('f', &value, 8); }
+	void Put(float value) { Put((double)value); }
+	void Put(const std::string &value) { Put(value.c_str()); }
+	void Put(char *value) { Put((const char *)value); }
+	void Put(const char *value)
+	{
+		if (value == nullptr)
+			value = "(null)";
+		Sized('s', value, min(strlen(value), (size_t)LOG_STRING_MAX));
+	}
+	void Put(const LogBlob &value) { Sized('b', value.pData, min(value.Length, (size_t)LOG_BLOB_MAX)); }
+
+private:
+	void Raw(const void *pData, size_t length)
+	{
+		if (_length + length > sizeof(_buffer))
+			return;
+		memcpy(_buffer + _length, pData, length);
+		_length += length;
+	}
+
+	void Tagged(char tag, const void *pData, size_t length)
+	{
+		if (_length + 1 + length > sizeof(_buffer))
+			return;
+		_buffer[_length++] = tag;
+		Raw(pData, length);
+	}
+
+	// Strings and blobs also keep their length
+	void Sized(char tag, const void *pData, size_t length)
+	{
+		if (_length + 2 > sizeof(_buffer))
+			return;
+		length = min(length, sizeof(_buffer) - _length - 2);
+		_buffer[_length++] = tag;
+		_buffer[_length++] = (uint8_t)length;
+		Raw(pData, length);
+	}
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Turn a record back into a log line
+/// .. Lines start with the time from the clock the log uses
+/// @return Length of the text (Cut to fit size)
+size_t LogFormat(const uint8_t *pRecord, size_t length, char *pText, size_t size, LogClock clock);
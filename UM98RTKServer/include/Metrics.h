@@ -0,0 +1,190 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+
+#include "Global.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// Every counter, gauge and histogram in the system
+// .. Adding a line here is all it takes to register a metric. The arena slots,
+// .. names and help text are all worked out at compile time
+//
+//	id				Used in code as Metric::id
+//	kind			Counter (only goes up), Gauge (set to a value) or Histogram (us)
+//	perCaster		One value for each caster
+//	name			Exporter name
+//	help			One line description
+#define METRIC_LIST(X)                                                                                       \
+	X(GpsBytes, Counter, false, "gps_received_bytes", "Bytes read from the GPS serial port")                   \
+	X(GpsPackets, Counter, false, "gps_rtcm_packets", "RTCM packets received from the GPS")                    \
+	X(GpsAsciiPackets, Counter, false, "gps_ascii_packets", "ASCII messages received from the GPS")            \
+	X(GpsReadErrors, Counter, false, "gps_read_errors", "Times the GPS stream had to be resynchronised")        \
+	X(GpsTimeouts, Counter, false, "gps_timeouts", "Times the GPS data stopped")                               \
+	X(GpsResets, Counter, false, "gps_resets", "Resets reported by the GPS")                                   \
+	X(GpsReinitialise, Counter, false, "gps_reinitialise", "GPS configurations started after a reset")         \
+	X(HeapFree, Gauge, false, "heap_free_bytes", "Free heap")                                                  \
+	X(HeapMinFree, Gauge, false, "heap_min_free_bytes", "Lowest free heap since start")                        \
+	X(WifiRssi, Gauge, false, "wifi_rssi_dbm", "WiFi signal strength")                                         \
+	X(Temperature, Gauge, false, "chip_temperature_celsius", "Processor temperature")                          \
+	X(MetricsScrapeTime, Gauge, false, "metrics_scrape_us", "Time taken by the last metrics scrape")           \
+	X(WebRenderTime, Histogram, false, "web_render_time_us", "Time taken to send each web page or API reply")  \
+	X(WebHeapUsed, Gauge, false, "web_heap_used_bytes", "Most heap taken while sending the last reply")        \
+	X(LogLineTime, Histogram, false, "log_line_time_us", "Time taken by each call to log a line")              \
+	X(LogFlashWriteTime, Histogram, false, "log_flash_write_us", "Time taken by each flash log write")         \
+	X(LogFlashDropped, Counter, false, "log_flash_dropped", "Log lines lost as the flash log fell behind")     \
+	X(CasterPacketsSent, Counter, true, "caster_packets_sent", "RTCM packets written to the caster")           \
+	X(CasterBytesSent, Counter, true, "caster_sent_bytes", "Bytes written to the caster")                      \
+	X(CasterBytesReceived, Counter, true, "caster_received_bytes", "Bytes read from the caster")               \
+	X(CasterReconnects, Counter, true, "caster_reconnects", "Connections made to the caster")                  \
+	X(CasterQueueOverflows, Counter, true, "caster_queue_overflows", "Packets dropped as the queue was full")   \
+	X(CasterExpiredPackets, Counter, true, "caster_expired_packets", "Packets dropped as they missed deadline") \
+	X(CasterQueueBytes, Gauge, true, "caster_queue_bytes", "Bytes waiting in the send queue")                  \
+	X(CasterQueueLatency, Histogram, true, "caster_queue_latency_us", "Enqueue to wire, lost frames at age")   \
+	X(CasterSendTime, Histogram, true, "caster_send_time_us", "Time taken by each socket write")
+
+enum class MetricKind : uint8_t
+{
+	Counter,
+	Gauge,
+	Histogram,
+};
+
+enum class Metric : uint8_t
+{
+#define METRIC_ENUM(id, kind, perCaster, name, help) id,
+	METRIC_LIST(METRIC_ENUM)
+#undef METRIC_ENUM
+		Count
+};
+
+struct MetricInfo
+{
+	const char *Name;
+	const char *Help;
+	MetricKind Kind;
+	bool PerCaster;
+};
+
+static constexpr MetricInfo METRIC_INFO[] = {
+#define METRIC_INFO_ROW(id, kind, perCaster, name, help) {name, help, MetricKind::kind, perCaster},
+	METRIC_LIST(METRIC_INFO_ROW)
+#undef METRIC_INFO_ROW
+};
+
+// Histogram bucket upper edges (us). The last bucket catches everything above
+static constexpr uint32_t METRIC_BUCKET_EDGES[] = {100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 500000, 1000000};
+#define METRIC_BUCKETS (sizeof(METRIC_BUCKET_EDGES) / sizeof(METRIC_BUCKET_EDGES[0]) + 1)
+
+// A histogram takes a slot per bucket then the sample count and sum (us. Wraps like a counter)
+#define METRIC_HISTOGRAM_SLOTS (METRIC_BUCKETS + 2)
+
+// Slots used by a metric for one caster and in total
+constexpr int MetricWidth(int index)
+{
+	return METRIC_INFO[index].Kind == MetricKind::Histogram ? METRIC_HISTOGRAM_SLOTS : 1;
+}
+constexpr int MetricSlots(int index)
+{
+	return MetricWidth(index) * (METRIC_INFO[index].PerCaster ? RTK_SERVERS : 1);
+}
+
+// First arena slot of each metric
+constexpr int MetricOffset(int index)
+{
+	return index == 0 ? 0 : MetricOffset(index - 1) + MetricSlots(index - 1);
+}
+
+#define METRIC_ARENA_SLOTS MetricOffset((int)Metric::Count)
+
+///////////////////////////////////////////////////////////////////////////////
+// A copy of every metric taken at one time. Readers work from this so a page
+// .. or screen shows values that belong together
+struct MetricSnapshot
+{
+	uint32_t Values[METRIC_ARENA_SLOTS];
+	unsigned long Time; // millis() when taken
+
+	inline uint32_t Get(Metric metric, int caster = 0) const
+	{
+		return Values[MetricOffset((int)metric) + caster * MetricWidth((int)metric)];
+	}
+	inline int32_t GetGauge(Metric metric, int caster = 0) const { return (int32_t)Get(metric, caster); }
+
+	// Histogram buckets (METRIC_BUCKETS of them, not cumulative), count then sum
+	inline const uint32_t *GetHistogram(Metric metric, int caster = 0) const
+	{
+		return &Values[MetricOffset((int)metric) + caster * MetricWidth((int)metric)];
+	}
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Registry of the metrics in a fixed arena of atomics
+// .. Any task may write. Counters are a single relaxed atomic add so they
+// .. are safe and cheap on the hot paths
+class Metrics
+{
+private:
+	std::atomic<uint32_t> _arena[METRIC_ARENA_SLOTS]; // Zeroed as the registry is a global
+
+	inline std::atomic<uint32_t> &Slot(Metric metric, int caster)
+	{
+		return _arena[MetricOffset((int)metric) + caster * MetricWidth((int)metric)];
+	}
+
+public:
+	inline static const MetricInfo &Info(Metric metric) { return METRIC_INFO[(int)metric]; }
+
+	///////////////////////////////////////////////////////////////////////////
+	// Count up a counter
+	inline void Add(Metric metric, uint32_t count = 1)
+	{
+		Slot(metric, 0).fetch_add(count, std::memory_order_relaxed);
+	}
+	inline void Add(Metric metric, int caster, uint32_t count)
+	{
+		Slot(metric, caster).fetch_add(count, std::memory_order_relaxed);
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Set a gauge
+	inline void Set(Metric metric, int32_t value)
+	{
+		Slot(metric, 0).store((uint32_t)value, std::memory_order_relaxed);
+	}
+	inline void Set(Metric metric, int caster, int32_t value)
+	{
+		Slot(metric, caster).store((uint32_t)value, std::memory_order_relaxed);
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Add a sample to a histogram
+	void Record(Metric metric, int caster, uint32_t micros)
+	{
+		std::atomic<uint32_t> *pSlots = &Slot(metric, caster);
+		size_t bucket = 0;
+		while (bucket < METRIC_BUCKETS - 1 && micros > METRIC_BUCKET_EDGES[bucket])
+			bucket++;
+		pSlots[bucket].fetch_add(1, std::memory_order_relaxed);
+		pSlots[METRIC_BUCKETS].fetch_add(1, std::memory_order_relaxed);
+		pSlots[METRIC_BUCKETS + 1].fetch_add(micros, std::memory_order_relaxed);
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Read a single counter or gauge
+	inline uint32_t Get(Metric metric, int caster = 0)
+	{
+		return Slot(metric, caster).load(std::memory_order_relaxed);
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Copy every metric
+	void Snapshot(MetricSnapshot &snapshot)
+	{
+		for (int n = 0; n < METRIC_ARENA_SLOTS; n++)
+			snapshot.Values[n] = _arena[n].load(std::memory_order_relaxed);
+		snapshot.Time = millis();
+	}
+};
+
+extern Metrics _metrics;
@@ -3,6 +3,9 @@
 #include "FS.h"
 #include "SPIFFS.h"
 #include "HandyLog.h"
+#include "LogHistory.h"
+#include "Metrics.h"
+#include "LogLevel.h"
 
 /* You only need to format SPIFFS the first time you run a
    test or else use the SPIFFS plugin to create a partition
@@ -13,14 +16,33 @@
 #define BOOT_LOG_MAX_LENGTH 100
 #define LOG_FILE_PREFIX "/logs/"
 
+// Flash log writer task. Lines are taken from the main log and written in
+// .. blocks that line up with the SPIFFS pages (256 bytes)
+#define LOG_FLASH_BLOCK 1024		 // Bytes per write (Multiple of the SPIFFS page)
+#define LOG_FLASH_FLUSH_MS 5000		 // Longest a part block waits before it is written
+#define LOG_FLASH_POLL_MS 100		 // Time between checks for new lines
+#define LOG_FLASH_ROLLOVER 100000	 // Start a new file after this many bytes
+#define LOG_FLASH_TASK_STACK 6144	 // Stack size (bytes)
+#define LOG_FLASH_CLOSE_MS 1000		 // Longest a restart waits for the last lines to be written
+
 ///////////////////////////////////////////////////////////////////////////////
 // File access routines
 class MyFiles
 {
-	int _logLength = -1;		 // Length of the log file
+	int _logLength = -1;		 // Length of the log file (Including the block not yet written)
 	fs::File _fsLog;			 // Log file
 	SemaphoreHandle_t _mutexLog; // Thread safe access to writing logs
 	SemaphoreHandle_t _mutex;	 // Thread safe access
+
+	// Only used by the log writer task
+	const LogHistory *_pLog = nullptr;	  // Log copied to flash
+	uint32_t _nextSeq = 0;				  // Next line of the log to write
+	char _block[LOG_FLASH_BLOCK];		  // Lines waiting to be written
+	size_t _blockLength = 0;			  // Bytes in _block
+	unsigned long _lastWrite = 0;		  // Time the block was last written (ms)
+	volatile bool _closeRequested = false; // A restart wants the last lines written and the file closed
+	volatile bool _logClosed = false;	  // Log closed for a restart. Nothing more is written
+
 public:
 	bool Setup()
 	{
@@ -39,9 +61,36 @@ public:
 		return false;
 	}
 
+	////////////////////////////////////////////////////////////////////////////////
+	/// @brief Start the task that copies the log to flash
+	/// .. Logln only adds to the lock-free main log, this task follows it and
+	/// .. writes whole blocks. If flash falls so far behind that lines are
+	/// .. written over in the main log they are counted as dropped
+	void StartLogWriter(const LogHistory &log)
+	{
+		_pLog = &log;
+		xTaskCreatePinnedToCore(
+			[](void *pParam)
+			{
+				auto pFiles = static_cast<MyFiles *>(pParam);
+				while (true)
+				{
+					pFiles->WriteLogLines();
+					vTaskDelay(pdMS_TO_TICKS(LOG_FLASH_POLL_MS));
+				}
+			},
+			"LogWriter",		  // Task name
+			LOG_FLASH_TASK_STACK, // Stack size (bytes)
+			this,				  // Parameter
+			1,					  // Task priority
+			NULL,				  // Task handle
+			PRO_CPU_NUM);		  // Off the caster core
+	}
+
 	////////////////////////////////////////////////////////////////////////////////
 	/// @brief Start a new logging file or open the existing one
-	void StartLogFile(std::vector<std::string> *pMainLog)
+	/// .. Only called from the log writer task
+	void StartLogFile(const char *header)
 	{
 		if (!xSemaphoreTake(_mutexLog, portMAX_DELAY))
 			return;
@@ -94,10 +143,8 @@ public:
 		}
 		xSemaphoreGive(_mutexLog);
 
-		// Copy the main log into the log file
-		if (pMainLog != NULL)
-			for (const auto &line : *pMainLog)
-				AppendLog(line.c_str());
+		if (header != nullptr)
+			AppendLog(header);
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
@@ -181,7 +228,7 @@ public:
 		}
 		else
 		{
-			Logf("E207 - Failed to %s file for appending", BOOT_LOG_FILENAME);
+			LogError(LogFile, "E207 - Failed to %s file for appending", BOOT_LOG_FILENAME);
 			return;
 		}
 	}
@@ -190,20 +237,20 @@ public:
 	/// @brief Write a message to the file system.
 	bool WriteFile(const char *path, const char *message)
 	{
-		Logf("Writing file: %s -> '%s'", path, message);
+		LogDebug(LogFile, "Writing file: %s -> '%s'", path, message);
 		bool error = true;
 		if (xSemaphoreTake(_mutex, portMAX_DELAY))
 		{
 			fs::File file = SPIFFS.open(path, FILE_WRITE);
 			if (!file)
 			{
-				Logln("- failed to open file for writing");
+				LogError(LogFile, "- failed to open file for writing");
 				xSemaphoreGive(_mutex);
 				return false;
 			}
 
 			error = file.print(message);
-			Logln(error ? "- file written" : "- write failed");
+			LogDebug(LogFile, "%s", error ? "- file written" : "- write failed");
 
 			file.close();
 			xSemaphoreGive(_mutex);
@@ -213,23 +260,23 @@ public:
 
 	void AppendFile(const char *path, const char *message)
 	{
-		Logf("Appending to file: %s -> '%s'", path, message);
+		LogDebug(LogFile, "Appending to file: %s -> '%s'", path, message);
 		if (xSemaphoreTake(_mutex, portMAX_DELAY))
 		{
 			fs::File file = SPIFFS.open(path, FILE_APPEND);
 			if (!file)
 			{
-				Logln("- failed to open file for appending");
+				LogError(LogFile, "- failed to open file for appending");
 				xSemaphoreGive(_mutex);
 				return;
 			}
 			if (file.print(message))
 			{
-				Logln("- message appended");
+				LogDebug(LogFile, "- message appended");
 			}
 			else
 			{
-				Logln("- append failed");
+				LogError(LogFile, "- append failed");
 			}
 			file.close();
 			xSemaphoreGive(_mutex);
@@ -238,13 +285,13 @@ public:
 
 	bool ReadFile(const char *path, std::string &text, int maxLength = 256)
 	{
-		Logf("Reading file: %s", path);
+		LogDebug(LogFile, "Reading file: %s", path);
 		if (xSemaphoreTake(_mutex, portMAX_DELAY))
 		{
 			fs::File file = SPIFFS.open(path);
 			if (!file || file.isDirectory())
 			{
-				Logln("- failed to open file for reading");
+				LogDebug(LogFile, "- failed to open file for reading");
 				xSemaphoreGive(_mutex);
 				return false;
 			}
@@ -305,39 +352,131 @@ public:
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
-	/// @brief Save the string to the file system.
-	void AppendLog(const char *message)
+	/// @brief Write the lines not yet on flash and close the log file
+	/// .. The log writer task writes them, so this waits for it. Call before
+	/// .. ESP.restart()
+	void CloseLogFile()
 	{
-		if (_logLength < 0)
+		if (_pLog != nullptr && _logLength >= 0)
+		{
+			_closeRequested = true;
+			unsigned long start = millis();
+			while (!_logClosed && millis() - start < LOG_FLASH_CLOSE_MS)
+				vTaskDelay(pdMS_TO_TICKS(LOG_FLASH_POLL_MS / 4));
+		}
+		_logClosed = true;
+		if (_mutexLog == NULL || !xSemaphoreTake(_mutexLog, portMAX_DELAY))
 			return;
+		if (_fsLog)
+		{
+			_fsLog.close();
+			_logLength = -1; // Reset the log length
+		}
+		xSemaphoreGive(_mutexLog);
+	}
 
-		_logLength += strlen(message);
+private:
+	////////////////////////////////////////////////////////////////////////////////
+	/// @brief Write the lines added to the log since the last call
+	/// .. Only called from the log writer task
+	void WriteLogLines()
+	{
+		if (_logClosed || _pLog == nullptr || !_handyTime.GotGoodTime())
+			return;
 
-		if (_logLength > 100000)
+		// First good time. Start with the oldest line still in the log
+		if (_logLength < 0)
 		{
-			std::vector<std::string> logHeader;
-			logHeader.push_back(StringPrintf("***** Rolling over from log file, length %s", _fsLog.path()));
-			StartLogFile(&logHeader);
+			StartLogFile(nullptr);
+			if (_logLength < 0)
+				return;
+			uint32_t next;
+			_pLog->GetRange(_nextSeq, next);
+			_lastWrite = millis();
 		}
 
-		if (!xSemaphoreTake(_mutexLog, portMAX_DELAY))
+		// Copy new lines to the block. Gaps are lines written over before we got here
+		uint32_t dropped = 0;
+		uint32_t next = _pLog->Visit(_nextSeq, [&](uint32_t seq, const char *line)
+									 {
+										 dropped += seq - _nextSeq;
+										 _nextSeq = seq + 1;
+										 AppendLog(line);
+										 return true; });
+		dropped += next - _nextSeq;
+		_nextSeq = next;
+		if (dropped > 0)
+		{
+			_metrics.Add(Metric::LogFlashDropped, dropped);
+			char text[64];
+			snprintf(text, sizeof(text), "**** %u LOG LINES DROPPED ****", dropped);
+			AppendLog(text);
+		}
+
+		// Last lines before a restart. The part block goes too
+		if (_closeRequested)
+		{
+			WriteBlock();
+			_logClosed = true;
 			return;
-		if (_fsLog)
+		}
+
+		// Write a part block if it has waited long enough
+		if (_blockLength > 0 && millis() - _lastWrite >= LOG_FLASH_FLUSH_MS)
+			WriteBlock();
+
+		if (_logLength > LOG_FLASH_ROLLOVER)
 		{
-			_fsLog.println(message);
-			_fsLog.flush();
+			WriteBlock();
+			char header[128];
+			snprintf(header, sizeof(header), "***** Rolling over from log file %s", _fsLog.path());
+			StartLogFile(header);
 		}
-		xSemaphoreGive(_mutexLog);
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
-	/// @brief Close the log file if it is open.
-	void CloseLogFile()
+	/// @brief Add a line to the block. Full blocks are written so each write
+	/// .. ends on a block boundary of the file
+	void AppendLog(const char *message)
 	{
-		if (_fsLog)
+		AppendBlock(message, strlen(message));
+		AppendBlock("\r\n", 2);
+	}
+
+	void AppendBlock(const char *pData, size_t length)
+	{
+		while (length > 0 && _logLength >= 0)
 		{
-			_fsLog.close();
-			_logLength = -1; // Reset the log length
+			size_t room = LOG_FLASH_BLOCK - (_logLength % LOG_FLASH_BLOCK);
+			size_t part = min(length, room);
+			memcpy(_block + _blockLength, pData, part);
+			_blockLength += part;
+			_logLength += part;
+			pData += part;
+			length -= part;
+			if (part == room)
+				WriteBlock();
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// @brief Write and flush the block
+	void WriteBlock()
+	{
+		if (_blockLength == 0)
+			return;
+		if (xSemaphoreTake(_mutexLog, portMAX_DELAY))
+		{
+			unsigned long start = micros();
+			if (_fsLog)
+			{
+				_fsLog.write((const uint8_t *)_block, _blockLength);
+				_fsLog.flush();
+			}
+			_metrics.Record(Metric::LogFlashWriteTime, 0, micros() - start);
+			xSemaphoreGive(_mutexLog);
 		}
+		_blockLength = 0;
+		_lastWrite = millis();
 	}
 };
\ No newline at end of file
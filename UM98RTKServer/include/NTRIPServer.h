@@ -5,9 +5,127 @@
 // Buffer used to grab data to send
 #define SOCKET_IN_BUFFER_MAX 512
 
+// Queue limits, send budget and default deadlines are in SendQueue.h
+
+// Longest time to wait for an address that is not cached
+#define NTRIP_RESOLVE_TIMEOUT_MS 2000
+
+// Longest time to wait for the TCP connection
+#define NTRIP_CONNECT_TIMEOUT_MS 3000
+
+// Longest time to wait for the TLS handshake
+#define NTRIP_TLS_TIMEOUT_MS 5000
+
+// Time between attempts to bring up the standby connection
+#define NTRIP_STANDBY_RETRY_MS 30000
+
+// Task stacks (bytes). An mbedTLS handshake needs far more than plain TCP
+// .. See "Max Stack Height" on the status page for what is left
+#define NTRIP_TASK_STACK 5000
+#define NTRIP_TLS_TASK_STACK 12288
+
+// The standby is connected by its own task so it never holds up the uploads
+#define NTRIP_STANDBY_POLL_MS 100
+
+// Longest host name kept for the status pages
+#define NTRIP_HOST_NAME_MAX 64
+
+// Time between copies of the caster state for the web pages
+#define NTRIP_SNAPSHOT_MS 250
+
+// Time uploads stay suspended after the caster refuses them
+#define NTRIP_REJECT_BACKOFF_MS (30 * 60 * 1000)
+
+// Longest time to wait for the NTRIP 2.0 reply
+#define NTRIP_REPLY_TIMEOUT_MS 5000
+
+// Time between saves of the byte counters (Spares the flash)
+#define NTRIP_USAGE_SAVE_MS (15 * 60 * 1000)
+
+// Seconds between MSM epochs sent while over quota with a reduced message set
+// .. Divides a day so an unknown GLONASS day of week gives the same choice
+#define NTRIP_QUOTA_MSM_INTERVAL_S 5
+
+#include <atomic>
 #include <string>
 #include <vector>
 #include "QueueData.h"
+#include "SendQueue.h"
+#include "LatencyHistogram.h"
+#include "SocketTuning.h"
+#include "CasterLink.h"
+#include "CasterHealth.h"
+#include "CasterReply.h"
+#include "BandwidthMeter.h"
+#include "LogHistory.h"
+#include "HandyLog.h"
+#include "LogLevel.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// Copy of the caster state for the web pages and API
+// .. Written by the caster task, so the web task never reads a counter,
+// .. string or meter while the caster task is changing it
+struct CasterSnapshot
+{
+	const char *Status;								 // Connection status text
+	char RejectReason[CASTER_REPLY_LINE_MAX + 1];	 // Why the caster last refused us
+	unsigned long RejectedAt;						 // Time uploads were suspended (0 if never)
+	bool Rejected;									 // Uploads suspended now
+	int HealthScore;								 // 0 to 100
+	const char *Breaker;							 // Circuit breaker state text
+	unsigned long NextRetryMs;						 // Time till the next connection attempt
+	unsigned long ClassDrops[RtcmClassCount];		 // Overflow drops by message class
+	unsigned long Expired[RtcmClassCount];			 // Expired before send by message class
+	unsigned long TotalTimeouts;					 // Send timeouts
+	unsigned long MaxSendTime;						 // Longest write (us)
+	unsigned long TotalWrites;						 // Socket writes
+	int WritesPerSecond;							 // Writes in the last complete second
+	unsigned long BytesPerWrite;					 // Average write size
+	unsigned long LastCatchUpTime;					 // Time taken to drain the last backlog (ms)
+	unsigned long MaxCatchUpTime;					 // Longest time taken to drain a backlog (ms)
+	unsigned long WouldBlocks;						 // Writes that returned EWOULDBLOCK
+	unsigned long BlockedTime;						 // Total ms spent in writes that would block
+	int SendBufferSize;								 // SO_SNDBUF (-1 if unknown)
+	char ActiveHost[NTRIP_HOST_NAME_MAX];			 // Host the uploads go to
+	bool StandbyReady;								 // Standby connected and waiting
+	int Failovers;									 // Times the standby took over
+	unsigned long LastFailoverTime;					 // Write failure to data on the standby (ms)
+	unsigned long HandshakeTime;					 // Last TLS handshake (ms)
+	int ResumedHandshakes;							 // TLS sessions resumed
+	int FullHandshakes;								 // .. and negotiated in full
+	int TlsHeapUsed;								 // Heap taken by the TLS connection
+	int EncryptMicrosPerKb;							 // Time to encrypt a KB (us)
+	uint64_t TotalSent;								 // Bytes sent
+	uint64_t TotalReceived;							 // Bytes received
+	uint64_t DaySent;								 // Bytes sent today
+	uint64_t MonthSent;								 // .. and this month
+	uint32_t Rate1s;								 // Send rate over the last second (B/s)
+	uint32_t Rate1m;								 // .. minute
+	uint32_t Rate1h;								 // .. hour
+	const char *QuotaStatus;						 // What the quota is doing to uploads
+	unsigned long QuotaDrops;						 // MSM frames skipped by the reduced message set
+	UBaseType_t MaxStackHeight;						 // Stack high water mark
+	UBaseType_t StandbyStackHeight;					 // .. and of the standby task
+	char TlsFingerprint[65];						 // SHA-256 of the caster's certificate
+	unsigned long Time;								 // millis() when taken
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Settings used to open one connection
+// .. Copied by the caster task, so the standby task never reads a setting
+// .. while the web task is saving new ones
+struct CasterLogin
+{
+	std::string Host;		// Host to connect to
+	int Port = 0;			// Caster port
+	std::string Credential; // Mount point
+	std::string Password;	// Mount point password
+	std::string User;		// NTRIP 2.0 user (Blank for the mount point)
+	int NtripVersion = 1;	// NTRIP version 1 or 2
+	bool Tls = false;		// Connect with TLS
+	std::string TlsPin;		// SHA-256 of the caster's certificate (Blank accepts any)
+	SocketTuning Tuning;	// TCP options
+};
 
 ///////////////////////////////////////////////////////////////////////////////
 // Class manages the connection to the RTK Service client
@@ -16,25 +134,33 @@ class NTRIPServer
 public:
 	NTRIPServer(int index);
 	void LoadSettings();
-	void Save(const char *address, const char *port, const char *credential, const char *password);
+	void Save(const char *address, const char *port, const char *credential, const char *password, const char *protocol, const char *user, const char *tuning, const char *standby, const char *transport, const char *tlsPin, const char *deadlines, const char *quota);
 	bool EnqueueData(const byte *pBytes, int length);
 	std::vector<std::string> GetLogHistory();
+	inline const LogHistory &GetLog() const { return _logHistory; }
 	const char *GetStatus() const;
 
 	inline const int GetIndex() const { return _index; }
-	inline int GetReconnects() const { return _reconnects; }
-	inline int GetPacketsSent() const { return _packetsSent; }
+	inline const CasterHealth &GetHealth() const { return _health; }
 	inline const std::string GetAddress() const { return _sAddress; }
 	inline int GetPort() const { return _port; }
 	inline const std::string GetCredential() const { return _sCredential; }
 	inline const std::string GetPassword() const { return _sPassword; }
-	inline int GetMaxSendTime() const { return _maxSendTime; }
-	inline UBaseType_t GetMaxStackHeight() const { return _maxStackHeight; }
-	inline unsigned long GetQueueOverflows() const { return _queueOverflows; }
-	inline unsigned long GetExpiredPackets() const { return _expiredPackets; }
-	inline unsigned long GetTotalTimeouts() const { return _totalTimeouts; }
+	inline int GetNtripVersion() const { return _ntripVersion; }
+	inline const std::string GetUser() const { return _sUser; }
+	inline const SocketTuning &GetTuning() const { return _tuning; }
+	inline const std::string GetStandbyAddress() const { return _sStandby; }
+	inline bool IsTls() const { return _tls; }
+	inline const std::string GetTlsPin() const { return _sTlsPin; }
+	inline unsigned long GetDeadline(RtcmClass c) const { return _deadlines[c]; }
+	const std::string GetDeadlines() const;
+	inline const LatencyHistogram &GetQueueLatency() const { return _queueLatency; }
 	inline bool IsEnabled() const { return _status != ConnectionState::Disabled; }
+	inline const BandwidthQuota &GetQuota() const { return _quota; }
+	const char *GetQuotaStatus() const;
+	void GetSnapshot(CasterSnapshot &snapshot) const;
 	void TaskFunction();
+	void StandbyTaskFunction();
 
 	enum class ConnectionState
 	{
@@ -42,43 +168,147 @@ public:
 		Disabled,
 		Connected,
 		Disconnected,
+		Rejected,
+	};
+
+	// Who owns the standby connection
+	// .. The caster task moves Idle to Wanted and owns it when Ready. The standby
+	// .. task moves Wanted to Connecting and owns it until it is Ready or Wanted
+	// .. again. Cancel asks the standby task to drop what it is connecting
+	enum class StandbyState : uint8_t
+	{
+		Idle,
+		Wanted,
+		Connecting,
+		Cancel,
+		Ready,
+	};
+
+	enum class QuotaState
+	{
+		Normal,	 // Under quota
+		Reduced, // Over quota. Sending a reduced message set
+		Paused,	 // Over quota. Uploads paused
 	};
 
 private:
-	WiFiClient _client;									// Socket connection
-	unsigned long _wifiConnectTime = 0;					// Time we last had good data to prevent reconnects too fast
+	CasterLink _client;									// Socket connection
+	CasterLink _standby;								// Authenticated spare connection ready to take over
+	CasterHealth _health = CasterHealth(10000);			// Health score and reconnect timing (First try after 10s)
+	CasterReply _reply;									// Reply parser for _client
+	CasterReply _standbyReply;							// Reply parser for _standby
+	byte _receiveBuffer[SOCKET_IN_BUFFER_MAX];			// Bytes read from the caster
+	byte _standbyBuffer[SOCKET_IN_BUFFER_MAX];			// Bytes read from the standby
+	char _rejectReason[CASTER_REPLY_LINE_MAX + 1] = {}; // Why the caster last refused us
+	unsigned long _rejectedAt = 0;						// Time uploads were suspended (0 if never)
+	BandwidthMeter _bandwidth;							// Bytes sent and received with rolling rates
+	BandwidthQuota _quota;								// Daily and monthly upload budget
+	QuotaState _quotaState = QuotaState::Normal;		// What the quota is doing to uploads
+	unsigned long _quotaDrops = 0;						// MSM frames skipped by the reduced message set
+	bool _usageLoaded = false;							// Byte counters have been read from flash
+	unsigned long _lastUsageSave = 0;					// Time the byte counters were last saved
 	bool _wasConnected = false;							// Was connected last time
 	const int _index;									// Index of the server used when updating display
 	ConnectionState _status = ConnectionState::Unknown; // Connection status
-	std::vector<std::string> _logHistory;				// History of connection status
-	int _reconnects;									// Total number of reconnects
-	int _packetsSent;									// Total number of packets sent
+	LogHistory _logHistory;								// History of connection status
 	unsigned long _maxSendTime;							// Maximum amount of time it took to send a packet
-	unsigned long _queueOverflows = 0;					// Number of packets dropped from the queue
+	unsigned long _classDrops[RtcmClassCount] = {};		// Overflow drops by message class
+	LatencyHistogram _queueLatency;						// Enqueue to write complete time (us)
+	SocketTuning _tuning;								// TCP options for the caster
+	int _sendBufferSize = -1;							// SO_SNDBUF reported by lwIP (-1 if unknown)
+	unsigned long _wouldBlocks = 0;						// Writes that returned EWOULDBLOCK
+	unsigned long _blockedTime = 0;						// Total ms spent in writes that would block
 	unsigned long _lastStackCheck = 0;					// Last time we checked the stack height
 	UBaseType_t _maxStackHeight = 0;					// Stack height
-	unsigned long _expiredPackets = 0;					// Number of packets that were expired
+	unsigned long _expiredByClass[RtcmClassCount] = {}; // Expired before send by message class
+	unsigned long _deadlines[RtcmClassCount] = {NTRIP_DEADLINE_STATION_MS, NTRIP_DEADLINE_MSM_MS, NTRIP_DEADLINE_OTHER_MS};
+	unsigned long _sendEstimateUs = 0;					// Smoothed time for a write to complete
 	int _overflowSetSize = 0;							// Number of times the overflow set was used in single set
-	int _timeOutIndex = 0;								// Index even increasing timeout periods
 	int _totalTimeouts = 0;								// Total number of timeouts
  	int _consecutiveTimeouts = 0;						// Number of consecutive timeouts
 	bool _forceReconnect = false;						// Force a reconnect on next loop if setting have changed
+	size_t _sendBudget = NTRIP_SEND_BUDGET;				// Most bytes gathered into one write
+	unsigned long _totalWrites = 0;						// Number of socket writes (Each may hold several frames)
+	unsigned long _totalBytesSent = 0;					// Total bytes written to the caster
+	int _writesThisSecond = 0;							// Writes counted in the current second
+	int _writesPerSecond = 0;							// Writes in the last complete second
+	unsigned long _writeSecondStart = 0;				// Start of the current counting second
+	unsigned long _catchUpStart = 0;					// Time a backlog was first seen (0 when not catching up)
+	bool _afterReconnect = false;						// Nothing written yet on this connection
+	unsigned long _lastCatchUpTime = 0;					// Time taken to drain the last backlog (ms)
+	unsigned long _maxCatchUpTime = 0;					// Longest time taken to drain a backlog (ms)
+	std::string _activeHost;							// Host _client is connected to
+	std::string _standbyHost;							// Host _standby is connected to
+	CasterLogin _standbyLogin;							// Settings for the standby task. Only written while Idle
+	std::atomic<StandbyState> _standbyState = {StandbyState::Idle}; // Task that owns _standby
+	std::atomic<unsigned long> _standbyAttempt = {0};	// Time of the last standby connection attempt (0 to try now)
+	std::atomic<uint32_t> _standbySent = {0};			// Standby bytes not yet added to _bandwidth
+	std::atomic<uint32_t> _standbyReceived = {0};		// .. and received
+	std::atomic<UBaseType_t> _standbyStackHeight = {0}; // Standby task stack high water mark
+	TaskHandle_t _standbyTask = NULL;					// Task making the standby connection
+	int _failovers = 0;									// Number of times the standby took over
+	unsigned long _lastFailoverTime = 0;				// Time from write failure to data on the standby (ms)
+	unsigned long _failoverStart = 0;					// Time the active connection failed (0 when not failing over)
 
 	std::string _sAddress;
 	int _port;
 	std::string _sCredential;
 	std::string _sPassword;
+	int _ntripVersion = 1; // 1 = SOURCE handshake, 2 = HTTP POST with chunked transfer
+	std::string _sUser;	   // NTRIP 2.0 user name (Mount point used if blank)
+	std::string _sStandby; // Standby host name or IP (Blank for no standby)
+	bool _tls = false;	   // Connect with TLS
+	std::string _sTlsPin;  // SHA-256 of the caster's certificate (Blank accepts any)
 
-	const SemaphoreHandle_t _logMutex;	 // Thread safe log access
 	const SemaphoreHandle_t _queMutex;	 // Thread safe queue access
-	std::vector<QueueData *> _dataQueue; // Queue to hold QueueData items
+	SendQueue _queue;					 // Frames waiting to be sent
+	std::vector<QueueData *> _sendBatch; // Items gathered for the next write
 	TaskHandle_t _connectingTask = NULL; // Task handle for the main connection and sending task
 
-	QueueData *DequeueData();
-	void ConnectedProcessing(const byte *pBytes, int length);
-	void ConnectedProcessingSend(const byte *pBytes, int length);
+	const SemaphoreHandle_t _snapshotMutex; // Thread safe snapshot access
+	CasterSnapshot _snapshot = {};			// Last published state
+
+	void LoadDeadlines(const std::string &text);
+	void ServiceBandwidth();
+	void PublishSnapshot();
+	void SaveUsage();
+	int DequeueBatch(std::vector<QueueData *> &batch);
+	void RecordLost(const QueueData *pItem, bool expired);
+	void ConnectedProcessing(const std::vector<QueueData *> &batch, int remaining);
+	void ConnectedProcessingSend(const std::vector<QueueData *> &batch, int remaining);
+	size_t WriteGather(SendGather &gather);
 	void ConnectedProcessingReceive();
-	void LogX(std::string text, bool dualLog = true);
+	CasterReply::Result ReceiveReply(CasterLink &client, CasterReply &reply, const std::string &host);
+	void Reject(const std::string &host, const char *reason);
+
+	///////////////////////////////////////////////////////////////////////////////
+	// Log to this caster's history and the main log. The format must be a
+	// .. literal (See LogRecord.h). Use the level macros in LogLevel.h
+	template <typename... Args>
+	void LogB(const char *format, Args... args)
+	{
+		LogEncoder record(format, LOG_SOURCE_NONE);
+		record.PutAll(args...);
+		_logHistory.Add(record);
+		record.SetSource(_index);
+		Logln(record);
+	}
+
+	// Only in the caster log
+	template <typename... Args>
+	void LogBLocal(const char *format, Args... args)
+	{
+		LogEncoder record(format, LOG_SOURCE_NONE);
+		record.PutAll(args...);
+		_logHistory.Add(record);
+	}
 	bool Reconnect();
-	bool WriteText(const char *str);
+	CasterLogin MakeLogin(const std::string &host) const;
+	bool OpenConnection(CasterLink &client, CasterReply &reply, const CasterLogin &login, unsigned long resolveTimeoutMs);
+	void MaintainStandby();
+	void StopStandby();
+	bool Failover(const char *reason, unsigned long startMs);
+	bool HandshakeNtrip1(CasterLink &client, const CasterLogin &login);
+	bool HandshakeNtrip2(CasterLink &client, CasterReply &reply, const CasterLogin &login);
+	bool WriteText(CasterLink &client, const char *str);
 };
\ No newline at end of file
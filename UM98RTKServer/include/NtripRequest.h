@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Agent name sent to the caster
+#define NTRIP_AGENT "NTRIP UM98/ESP32_T_Display_S3"
+
+///////////////////////////////////////////////////////////////////////////////
+// Upload requests sent to the caster
+// .. Plain strings with no Arduino types so Tools/UploadCheck.cpp sends the
+// .. stand-in caster the same bytes as the device
+class NtripRequest
+{
+public:
+	///////////////////////////////////////////////////////////////////////////
+	// NTRIP 1.0 SOURCE handshake. The caster replies "ICY 200 OK"
+	static std::string Source(const std::string &password, const std::string &mountPoint)
+	{
+		return "SOURCE " + password + " " + mountPoint + "\r\n"
+			   "Source-Agent: " NTRIP_AGENT "\r\n"
+			   "STR: \r\n"
+			   "\r\n";
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// NTRIP 2.0 upload using HTTP POST with chunked transfer
+	// .. The mount point is used as the user name when user is blank
+	static std::string Post(const std::string &mountPoint, const std::string &host, int port,
+							const std::string &user, const std::string &password)
+	{
+		return "POST /" + mountPoint + " HTTP/1.1\r\n"
+			   "Host: " + host + ":" + std::to_string(port) + "\r\n"
+			   "Ntrip-Version: Ntrip/2.0\r\n"
+			   "User-Agent: " NTRIP_AGENT "\r\n"
+			   "Authorization: Basic " + Base64((user.empty() ? mountPoint : user) + ":" + password) + "\r\n"
+			   "Connection: close\r\n"
+			   "Transfer-Encoding: chunked\r\n"
+			   "\r\n";
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Base64 with padding for the Basic authorisation header
+	static std::string Base64(const std::string &text)
+	{
+		static const char *ALPHABET = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+		std::string encoded;
+		encoded.reserve((text.length() + 2) / 3 * 4);
+		for (size_t n = 0; n < text.length(); n += 3)
+		{
+			uint32_t bits = (uint8_t)text[n] << 16;
+			if (n + 1 < text.length())
+				bits |= (uint8_t)text[n + 1] << 8;
+			if (n + 2 < text.length())
+				bits |= (uint8_t)text[n + 2];
+			encoded += ALPHABET[(bits >> 18) & 0x3F];
+			encoded += ALPHABET[(bits >> 12) & 0x3F];
+			encoded += n + 1 < text.length() ? ALPHABET[(bits >> 6) & 0x3F] : '=';
+			encoded += n + 2 < text.length() ? ALPHABET[bits & 0x3F] : '=';
+		}
+		return encoded;
+	}
+};
@@ -5,12 +5,35 @@
 #include <cstring>
 #include <Arduino.h>
 
+////////////////////////////////////////
+// Class of RTCM message. Used to decide what to keep when a queue overflows
+enum RtcmClass
+{
+	RtcmClassStation, // Station position and antenna (1005, 1006, 1033, 1230)
+	RtcmClassMsm,	  // Multiple signal messages (1071 to 1137)
+	RtcmClassOther,	  // Ephemeris and anything else
+	RtcmClassCount,
+};
+
+// MSM types run from 1071 (GPS) to 1137 (NavIC). type / 10 - 107 picks the GNSS
+#define RTCM_MSM_GNSS_COUNT 7
+#define RTCM_GNSS_GLONASS 1
+#define RTCM_GNSS_BEIDOU 5
+
+// Seconds GPS time is ahead of UTC. Puts GLONASS (UTC based) epochs on GPS time
+#define RTCM_GPS_LEAP_SECONDS 18
+
 class QueueData
 {
 private:
 	unsigned char *_pData;
 	size_t _length;
 	unsigned long _timestamp;
+	unsigned long _queuedMicros;	   // Time queued for latency measurement
+	int _type = 0;					   // RTCM message type (0 if not RTCM)
+	RtcmClass _class = RtcmClassOther; // Message class
+	uint32_t _epoch = 0;			   // MSM epoch time (0 if not MSM)
+	unsigned long _deadline = 0;	   // Time (ms) the frame is no use to the caster
 
 public:
 	////////////////////////////////////////
@@ -24,6 +47,9 @@ public:
 			std::memcpy(_pData, inputData, inputLength);
 		}
 		_timestamp = millis();
+		_queuedMicros = micros();
+		_deadline = _timestamp + 60000;
+		Classify();
 	}
 
 	////////////////////////////////////////
@@ -46,6 +72,92 @@ public:
 	const unsigned char *getData() const { return _pData; }
 
 	size_t getLength() const { return _length; }
+	int getType() const { return _type; }
+	RtcmClass getClass() const { return _class; }
+	uint32_t getEpoch() const { return _epoch; }
+	int getGnss() const { return _class == RtcmClassMsm ? _type / 10 - 107 : -1; }
+	unsigned long getQueuedMicros() const { return _queuedMicros; }
+	unsigned long getDeadline() const { return _deadline; }
+
+	////////////////////////////////////////
+	// MSM epoch as the GPS second of the week so every GNSS of an epoch agrees
+	// .. GPS, Galileo, SBAS, QZSS and NavIC use GPS time of week. BeiDou is 14s
+	// .. behind. GLONASS has the day of week (7 if unknown) above Moscow time of day
+	uint32_t getGpsSecond() const
+	{
+		const uint32_t WEEK = 7 * 86400;
+		switch (getGnss())
+		{
+		case RTCM_GNSS_GLONASS:
+		{
+			uint32_t day = _epoch >> 27;
+			uint32_t second = (day < 7 ? day * 86400 : 0) + (_epoch & 0x7FFFFFF) / 1000;
+			return (second + WEEK - 3 * 3600 + RTCM_GPS_LEAP_SECONDS) % WEEK;
+		}
+		case RTCM_GNSS_BEIDOU:
+			return (_epoch / 1000 + 14) % WEEK;
+		default:
+			return _epoch / 1000;
+		}
+	}
+
+	////////////////////////////////////////
+	// Set how long after queuing the frame must be sent
+	void SetDeadline(unsigned long ms) { _deadline = _timestamp + ms; }
+
+	////////////////////////////////////////
+	// Check if the frame cannot be sent in time if it takes leadMs to send
+	bool MissesDeadline(unsigned long now, unsigned long leadMs) const
+	{
+		return (long)(_deadline - (now + leadMs)) < 0;
+	}
+
+	////////////////////////////////////////
+	// Check if this frame is due before the other
+	bool DueBefore(const QueueData &other) const
+	{
+		return (long)(_deadline - other._deadline) < 0;
+	}
+
+	////////////////////////////////////////
+	// Pull the message type and MSM epoch out of the RTCM frame
+	//  +-------+--------+-----------+------------+------------+-------------+
+	//  |   D3  | 000000 |  length   |  type      | station id | epoch (MSM) |
+	//  +-------+--------+-----------+------------+------------+-------------+
+	//  |8 bits |6 bits  | 10 bits   | 12 bits    | 12 bits    | 30 bits     |
+	//  +-------+--------+-----------+------------+------------+-------------+
+	void Classify()
+	{
+		if (_pData == nullptr || _length < 6 || _pData[0] != 0xD3)
+			return;
+		_type = GetBits(24, 12);
+		switch (_type)
+		{
+		case 1005:
+		case 1006:
+		case 1033:
+		case 1230:
+			_class = RtcmClassStation;
+			break;
+		default:
+			if (1071 <= _type && _type <= 1137 && 1 <= _type % 10 && _type % 10 <= 7 && _length >= 12)
+			{
+				_class = RtcmClassMsm;
+				_epoch = GetBits(48, 30);
+			}
+			break;
+		}
+	}
+
+	////////////////////////////////////////
+	// Read bits from the frame (MSB first)
+	uint32_t GetBits(int pos, int len) const
+	{
+		uint32_t bits = 0;
+		for (int i = pos; i < pos + len; i++)
+			bits = (bits << 1) + ((_pData[i / 8] >> (7 - i % 8)) & 1u);
+		return bits;
+	}
 
 	////////////////////////////////////////
 	// Disable copy constructor and copy assignment operator
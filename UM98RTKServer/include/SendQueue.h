@@ -0,0 +1,267 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+#ifdef ARDUINO
+#include <lwip/sockets.h>
+#else
+#include <sys/uio.h>
+#endif
+
+#include "QueueData.h"
+
+// Most bytes gathered into a single socket write (One TCP MSS)
+// .. Each caster can change it in the socket tuning up to the max
+#define NTRIP_SEND_BUDGET 1436
+#define NTRIP_SEND_BUDGET_MAX 4096
+
+// Most frames gathered into a single socket write
+#define NTRIP_SEND_MAX_FRAMES 24
+
+// Queue limit. Above this the overflow policy drops the least useful frames
+// .. Age is not a limit as each frame has its own deadline (See DequeueBatch)
+#define NTRIP_QUEUE_MAX_BYTES (8 * 1024)
+
+// A frame waiting longer than one epoch means the queue has backed up
+#define NTRIP_CATCH_UP_AGE_MS 1000
+
+// Default freshness deadline (ms) for each message class. Station, MSM, other
+#define NTRIP_DEADLINE_STATION_MS 5000
+#define NTRIP_DEADLINE_MSM_MS 500
+#define NTRIP_DEADLINE_OTHER_MS 2000
+
+///////////////////////////////////////////////////////////////////////////////
+// Frames waiting to go to one caster
+// .. No locking, logging or counters so it also builds on a PC for
+// .. Tools/SendQueueBench.cpp. The caster holds its queue mutex round each
+// .. call and counts what is lost in the callbacks
+class SendQueue
+{
+private:
+	std::vector<QueueData *> _items; // Frames in arrival order
+	std::vector<int> _edfOrder;		 // Queue indexes in deadline order (Kept to avoid allocating)
+	size_t _bytes = 0;				 // Bytes held in the queue
+	bool _backedUp = false;			 // Oldest frame was older than an epoch at the last dequeue
+
+public:
+	inline size_t GetBytes() const { return _bytes; }
+	inline int GetCount() const { return _items.size(); }
+	inline bool IsBackedUp() const { return _backedUp; }
+
+	///////////////////////////////////////////////////////////////////////////
+	// Add a frame then drop the least useful till we are back under the limit
+	// .. onDropped is given each dropped frame before it is deleted
+	// .. Returns the number of frames dropped
+	template <typename OnDropped>
+	int Push(QueueData *pItem, OnDropped onDropped)
+	{
+		_items.push_back(pItem);
+		_bytes += pItem->getLength();
+
+		int dropped = 0;
+		while (IsOverLimit())
+		{
+			int victim = ChooseOverflowVictim();
+			if (victim < 0)
+				break;
+			QueueData *pOldItem = _items[victim];
+			onDropped(pOldItem);
+			_items.erase(_items.begin() + victim);
+			_bytes -= pOldItem->getLength();
+			delete pOldItem;
+			dropped++;
+		}
+		return dropped;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Gather the next frames into the batch, earliest deadline first
+	// .. Frames that cannot be written before their deadline (leadMs from now)
+	// .. are given to onExpired and deleted first so they never use bandwidth.
+	// .. Stops when the budget is reached. At least one frame is taken.
+	// .. Returns the number of frames left in the queue
+	template <typename OnExpired>
+	int DequeueBatch(std::vector<QueueData *> &batch, unsigned long now, unsigned long leadMs, size_t budget, OnExpired onExpired)
+	{
+		batch.clear();
+
+		// Drop what will be late by the time it is written
+		for (auto it = _items.begin(); it != _items.end();)
+		{
+			QueueData *pItem = *it;
+			if (pItem->MissesDeadline(now, leadMs))
+			{
+				onExpired(pItem);
+				_bytes -= pItem->getLength();
+				delete pItem;
+				it = _items.erase(it);
+				continue;
+			}
+			++it;
+		}
+
+		// The queue is in arrival order so the front is the oldest frame
+		_backedUp = !_items.empty() && _items.front()->IsExpired(NTRIP_CATCH_UP_AGE_MS);
+
+		// Order by deadline. Ties keep arrival order so a class is never reordered
+		_edfOrder.clear();
+		for (int n = 0; n < (int)_items.size(); n++)
+			_edfOrder.push_back(n);
+		std::stable_sort(_edfOrder.begin(), _edfOrder.end(), [this](int a, int b)
+						 { return _items[a]->DueBefore(*_items[b]); });
+
+		// Take the most urgent till the budget is full
+		size_t bytes = 0;
+		for (int index : _edfOrder)
+		{
+			QueueData *pItem = _items[index];
+			if (!batch.empty() && (bytes + pItem->getLength() > budget || batch.size() >= NTRIP_SEND_MAX_FRAMES))
+				break;
+			bytes += pItem->getLength();
+			_bytes -= pItem->getLength();
+			batch.push_back(pItem);
+			_items[index] = nullptr;
+		}
+
+		// Close the gaps left by the taken frames
+		_items.erase(std::remove(_items.begin(), _items.end(), nullptr), _items.end());
+		return _items.size();
+	}
+
+private:
+	///////////////////////////////////////////////////////////////////////////
+	// Check if the queue holds too many bytes
+	// .. Old frames are not a reason to drop others. A station frame may wait
+	// .. up to its 5s deadline at the front while the MSM behind it stays live.
+	// .. Frames past their deadline are dropped by DequeueBatch
+	bool IsOverLimit() const
+	{
+		if (_items.size() < 2)
+			return false;
+		return _bytes > NTRIP_QUEUE_MAX_BYTES;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Pick the frame to drop when the queue is over its limit
+	// .. In order we drop older copies of station messages, MSM from an older
+	// .. epoch, other messages, then MSM from the latest epoch. The latest copy
+	// .. of each station message is never dropped. Each GNSS stamps its MSM
+	// .. with its own time so the latest epoch is found for each GNSS
+	// Returns the index to drop or -1 if there is nothing we can drop
+	int ChooseOverflowVictim() const
+	{
+		const int size = _items.size();
+
+		// Station message with a newer copy behind it
+		for (int n = 0; n < size; n++)
+		{
+			if (_items[n]->getClass() != RtcmClassStation)
+				continue;
+			for (int m = n + 1; m < size; m++)
+				if (_items[m]->getType() == _items[n]->getType())
+					return n;
+		}
+
+		// Find the latest MSM epoch of each GNSS
+		uint32_t latestEpoch[RTCM_MSM_GNSS_COUNT];
+		bool found[RTCM_MSM_GNSS_COUNT] = {};
+		for (int n = size - 1; n >= 0; n--)
+		{
+			int gnss = _items[n]->getGnss();
+			if (gnss >= 0 && !found[gnss])
+			{
+				latestEpoch[gnss] = _items[n]->getEpoch();
+				found[gnss] = true;
+			}
+		}
+
+		// MSM from an older epoch of the same GNSS
+		for (int n = 0; n < size; n++)
+		{
+			int gnss = _items[n]->getGnss();
+			if (gnss >= 0 && _items[n]->getEpoch() != latestEpoch[gnss])
+				return n;
+		}
+
+		// Anything else, then the latest MSM
+		for (int n = 0; n < size; n++)
+			if (_items[n]->getClass() == RtcmClassOther)
+				return n;
+		for (int n = 0; n < size; n++)
+			if (_items[n]->getClass() == RtcmClassMsm)
+				return n;
+		return -1;
+	}
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Gather list for writing one batch in a single call
+// .. NTRIP 2.0 sends the whole write as one HTTP chunk so the first and last
+// .. entries hold the chunk framing. After a partial write Consume steps past
+// .. what was taken so the rest can be written
+struct SendGather
+{
+	struct iovec Iov[NTRIP_SEND_MAX_FRAMES + 2];
+	char ChunkHeader[12];
+	int First = 0;		   // First entry not completely written
+	int Count = 0;		   // Entries in use
+	int Frames = 0;		   // Frames in the write
+	size_t Length = 0;	   // Frame bytes
+	size_t WireLength = 0; // Bytes on the wire including any chunk framing
+
+	inline struct iovec *Next() { return Iov + First; }
+	inline int Left() const { return Count - First; }
+
+	///////////////////////////////////////////////////////////////////////////
+	// Point the entries at the frames. Empty frames are skipped
+	void Build(const std::vector<QueueData *> &batch, bool chunked)
+	{
+		Frames = 0;
+		Length = 0;
+		for (auto pItem : batch)
+		{
+			if (pItem->getLength() < 1 || Frames >= NTRIP_SEND_MAX_FRAMES)
+				continue;
+			Iov[Frames + 1].iov_base = (void *)pItem->getData();
+			Iov[Frames + 1].iov_len = pItem->getLength();
+			Length += pItem->getLength();
+			Frames++;
+		}
+
+		First = 1;
+		Count = Frames + 1;
+		WireLength = Length;
+		if (chunked && Length > 0)
+		{
+			int headerLength = snprintf(ChunkHeader, sizeof(ChunkHeader), "%X\r\n", (unsigned int)Length);
+			Iov[0].iov_base = ChunkHeader;
+			Iov[0].iov_len = headerLength;
+			Iov[Frames + 1].iov_base = (void *)"\r\n";
+			Iov[Frames + 1].iov_len = 2;
+			First = 0;
+			Count = Frames + 2;
+			WireLength = Length + headerLength + 2;
+		}
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Skip the entries completely written and trim the partial one
+	void Consume(size_t written)
+	{
+		while (written > 0 && First < Count)
+		{
+			if (written >= Iov[First].iov_len)
+			{
+				written -= Iov[First].iov_len;
+				First++;
+			}
+			else
+			{
+				Iov[First].iov_base = (uint8_t *)Iov[First].iov_base + written;
+				Iov[First].iov_len -= written;
+				written = 0;
+			}
+		}
+	}
+};
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <Arduino.h>
+#include <lwip/sockets.h>
+#include <string>
+
+#include "HandyString.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// TCP options applied to a caster socket after it connects
+// .. Stored as one comma separated line in the caster config
+// .. Zero means leave the lwIP default in place
+struct SocketTuning
+{
+	bool NoDelay = true;	// Disable Nagle so frames go out straight away
+	int SendBuffer = 0;		// SO_SNDBUF in bytes
+	int KeepIdle = 0;		// Seconds idle before keep-alive probes (0 = keep-alive off)
+	int KeepInterval = 5;	// Seconds between keep-alive probes
+	int KeepCount = 3;		// Unanswered probes before the connection is dropped
+	int WriteTimeoutMs = 0; // SO_SNDTIMEO. How long a write may block
+	int SendBudget = 0;		// Most bytes gathered into one write (0 = NTRIP_SEND_BUDGET)
+
+	///////////////////////////////////////////////////////////////////////////
+	// Read from "nodelay,sndbuf,keepidle,keepintvl,keepcnt,timeout,budget"
+	// .. Missing values keep their defaults
+	void FromString(const std::string &text)
+	{
+		*this = SocketTuning();
+		auto parts = Split(text, ",");
+		if (parts.size() > 0 && parts[0].length() > 0)
+			NoDelay = atoi(parts[0].c_str()) != 0;
+		if (parts.size() > 1)
+			SendBuffer = max(0, atoi(parts[1].c_str()));
+		if (parts.size() > 2)
+			KeepIdle = max(0, atoi(parts[2].c_str()));
+		if (parts.size() > 3 && atoi(parts[3].c_str()) > 0)
+			KeepInterval = atoi(parts[3].c_str());
+		if (parts.size() > 4 && atoi(parts[4].c_str()) > 0)
+			KeepCount = atoi(parts[4].c_str());
+		if (parts.size() > 5)
+			WriteTimeoutMs = max(0, atoi(parts[5].c_str()));
+		if (parts.size() > 6)
+			SendBudget = max(0, atoi(parts[6].c_str()));
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Write in the config file format
+	std::string ToString() const
+	{
+		return StringPrintf("%d,%d,%d,%d,%d,%d,%d", NoDelay ? 1 : 0, SendBuffer, KeepIdle, KeepInterval, KeepCount, WriteTimeoutMs, SendBudget);
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// Set the options on a connected socket
+	// .. Returns the names of any options the stack refused (Empty if all OK)
+	std::string Apply(int fd) const
+	{
+		std::string failed;
+		int value = NoDelay ? 1 : 0;
+		if (lwip_setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &value, sizeof(value)) != 0)
+			failed += " TCP_NODELAY";
+
+		if (SendBuffer > 0 && lwip_setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &SendBuffer, sizeof(SendBuffer)) != 0)
+			failed += " SO_SNDBUF";
+
+		value = KeepIdle > 0 ? 1 : 0;
+		if (lwip_setsockopt(fd, SOL_SOCKET, SO_KEEPALIVE, &value, sizeof(value)) != 0)
+			failed += " SO_KEEPALIVE";
+		if (KeepIdle > 0)
+		{
+			if (lwip_setsockopt(fd, IPPROTO_TCP, TCP_KEEPIDLE, &KeepIdle, sizeof(KeepIdle)) != 0)
+				failed += " TCP_KEEPIDLE";
+			if (lwip_setsockopt(fd, IPPROTO_TCP, TCP_KEEPINTVL, &KeepInterval, sizeof(KeepInterval)) != 0)
+				failed += " TCP_KEEPINTVL";
+			if (lwip_setsockopt(fd, IPPROTO_TCP, TCP_KEEPCNT, &KeepCount, sizeof(KeepCount)) != 0)
+				failed += " TCP_KEEPCNT";
+		}
+
+		if (WriteTimeoutMs > 0)
+		{
+			struct timeval tv;
+			tv.tv_sec = WriteTimeoutMs / 1000;
+			tv.tv_usec = (WriteTimeoutMs % 1000) * 1000;
+			if (lwip_setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv)) != 0)
+				failed += " SO_SNDTIMEO";
+		}
+		return failed;
+	}
+};
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <WebServer.h>
+
+#include "WebRoutes.h"
+
+// Cache time for assets. The URL carries the ETag so a new build is a new URL
+#define WEB_ASSET_CACHE_CONTROL "public, max-age=31536000, immutable"
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief A file built into flash by Tools/MakeWebAssets.py
+struct WebAsset
+{
+	const char *Path;		 // Served as /a/Path
+	const char *ContentType; // MIME type
+	const char *ETag;		 // CRC32 of the stored bytes
+	const uint8_t *pData;	 // Stored bytes (Gzipped unless already compressed)
+	size_t Length;			 // Size of pData
+	bool Gzip;				 // pData is gzipped
+};
+
+#include "WebAssets.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Find a built in asset
+/// @return nullptr if the asset was not built in
+inline const WebAsset *FindWebAsset(const char *path)
+{
+	for (const WebAsset &asset : WEB_ASSETS)
+		if (strcmp(asset.Path, path) == 0)
+			return &asset;
+	return nullptr;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Send a built in asset straight from flash as stored
+/// .. The browser keeps it for a year. A request with a matching ETag gets
+/// .. an empty 304
+inline void ServeWebAsset(WebServer &server, const String &path)
+{
+	const WebAsset *pAsset = FindWebAsset(path.c_str());
+	if (pAsset == nullptr)
+	{
+		server.send(404, "text/plain", "Not found");
+		return;
+	}
+
+	char etag[12];
+	snprintf(etag, sizeof(etag), "\"%s\"", pAsset->ETag);
+	server.sendHeader("ETag", etag);
+	server.sendHeader("Cache-Control", WEB_ASSET_CACHE_CONTROL);
+	if (server.header("If-None-Match") == etag)
+	{
+		server.send(304);
+		return;
+	}
+	if (pAsset->Gzip)
+		server.sendHeader("Content-Encoding", "gzip");
+	_webRoutes.AddBytes(pAsset->Length);
+	server.send_P(200, pAsset->ContentType, (PGM_P)pAsset->pData, pAsset->Length);
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <WebServer.h>
+#include <stdarg.h>
+
+#include "WebRoutes.h"
+
+// Bytes gathered before each chunk is written to the socket
+#define WEB_CHUNK_SIZE 1024
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Send a reply of unknown length as HTTP chunks
+/// .. Text is formatted into a small fixed buffer so the heap used does not
+/// .. grow with the size of the reply. Once the route's budget is used the
+/// .. rest of the reply is dropped and the connection is closed without the
+/// .. closing chunk, so the client sees a failed transfer and never takes a
+/// .. cut short document as complete
+class ChunkedWriter
+{
+private:
+	WebServer &_server;
+	char _buffer[WEB_CHUNK_SIZE];
+	size_t _length = 0;
+	bool _stopped = false; // Over budget. Nothing more is sent
+
+public:
+	ChunkedWriter(WebServer &server) : _server(server)
+	{
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief Send the headers
+	void Begin(const char *contentType)
+	{
+		_server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+		_server.send(200, contentType, "");
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief Send what is left and the closing chunk. Returns the time taken (us)
+	unsigned long End()
+	{
+		Flush();
+		if (_stopped)
+			_server.client().stop();
+		else
+			_server.sendContent("");
+		return _webRoutes.Elapsed();
+	}
+
+	inline bool IsStopped() const { return _stopped; }
+
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief Add formatted text. The buffer is sent first if it will not fit
+	void Appendf(const char *format, ...)
+	{
+		for (int attempt = 0; attempt < 2; attempt++)
+		{
+			va_list args;
+			va_start(args, format);
+			int length = vsnprintf(_buffer + _length, sizeof(_buffer) - _length, format, args);
+			va_end(args);
+			if (length < 0)
+				return;
+			if (_length + length < sizeof(_buffer))
+			{
+				_length += length;
+				return;
+			}
+			Flush();
+		}
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief Add text of any length
+	void Append(const char *text)
+	{
+		size_t length = strlen(text);
+		while (length > 0)
+		{
+			if (_length == sizeof(_buffer))
+				Flush();
+			size_t part = min(length, sizeof(_buffer) - _length);
+			memcpy(_buffer + _length, text, part);
+			_length += part;
+			text += part;
+			length -= part;
+		}
+	}
+
+	inline void Append(char c)
+	{
+		if (_length == sizeof(_buffer))
+			Flush();
+		_buffer[_length++] = c;
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief Write the gathered text as one chunk
+	void Flush()
+	{
+		if (_length == 0)
+			return;
+		if (!_stopped)
+			_stopped = !_webRoutes.AddBytes(_length);
+		if (!_stopped)
+			_server.sendContent(_buffer, _length);
+		_length = 0;
+	}
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <WebServer.h>
+
+#include "History.h"
+#include "WebRoutes.h"
+
+extern History _history;
+
+///////////////////////////////////////////////////////////////////////////////
+// Graph data sent straight from the history buffers as little endian binary
+// .. (The ESP32 and browsers are both little endian). Nothing is formatted
+// .. and nothing is allocated. Web/chart.js FetchChart() draws them
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Start a binary reply of known length that is never cached
+inline void BeginHistoryReply(WebServer &server, size_t length)
+{
+	server.sendHeader("Cache-Control", "no-store");
+	server.setContentLength(length);
+	server.send(200, "application/octet-stream", "");
+	_webRoutes.AddBytes(length);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Mean send time (us) for each second as int32 (/api/history/send?caster=N)
+/// .. The casters keep writing the ring so it is copied under its lock first
+inline void ServeSendHistory(WebServer &server)
+{
+	int caster = server.arg("caster").toInt();
+	if (caster < 0 || caster >= RTK_SERVERS)
+	{
+		server.send(400, "text/plain", "Bad caster");
+		return;
+	}
+	int times[AVERAGE_SEND_TIMERS];
+	int count = _history.CopyNtripSendTimes(caster, times);
+	BeginHistoryReply(server, count * sizeof(int));
+	if (count > 0)
+		server.sendContent((const char *)times, count * sizeof(int));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Temperature (C) for each minute of the last day as int8 (/api/history/temp)
+inline void ServeTemperatureHistory(WebServer &server)
+{
+	BeginHistoryReply(server, TEMP_HISTORY_SIZE);
+	server.sendContent(_history.GetTemperatures(), TEMP_HISTORY_SIZE);
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <string>
+
+#include "ChunkedWriter.h"
+
+// Deepest nesting of objects and arrays
+#define JSON_MAX_DEPTH 16
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Streaming JSON writer
+/// .. Values are serialised straight into the chunk buffer as they are added.
+/// .. Only a bit per nesting level is kept to know when a comma is needed
+class JsonWriter : public ChunkedWriter
+{
+private:
+	uint16_t _hasItems = 0; // Bit set for each open level that has an item
+	int _depth = 0;			// Open objects and arrays
+
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief Comma and key in front of the next item. No key inside arrays
+	void Next(const char *key)
+	{
+		if (_depth > 0 && _depth <= JSON_MAX_DEPTH)
+		{
+			uint16_t bit = 1 << (_depth - 1);
+			if (_hasItems & bit)
+				Append(',');
+			_hasItems |= bit;
+		}
+		if (key != nullptr)
+		{
+			Quoted(key);
+			Append(':');
+		}
+	}
+
+	void Open(const char *key, char c)
+	{
+		Next(key);
+		Append(c);
+		if (_depth < JSON_MAX_DEPTH)
+			_hasItems &= ~(1 << _depth);
+		_depth++;
+	}
+
+	void Close(char c)
+	{
+		Append(c);
+		if (_depth > 0)
+			_depth--;
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief Quoted and escaped string
+	void Quoted(const char *text)
+	{
+		Append('"');
+		for (const char *p = text; *p; p++)
+		{
+			char c = *p;
+			if (c == '"' || c == '\\')
+			{
+				Append('\\');
+				Append(c);
+			}
+			else if ((uint8_t)c < 0x20)
+				Appendf("\\u%04x", c);
+			else
+				Append(c);
+		}
+		Append('"');
+	}
+
+public:
+	JsonWriter(WebServer &server) : ChunkedWriter(server)
+	{
+	}
+
+	inline void Begin() { ChunkedWriter::Begin("application/json"); }
+
+	inline void BeginObject(const char *key = nullptr) { Open(key, '{'); }
+	inline void EndObject() { Close('}'); }
+	inline void BeginArray(const char *key = nullptr) { Open(key, '['); }
+	inline void EndArray() { Close(']'); }
+
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief Add a value. Use a null key for array items
+	void Value(const char *key, const char *value)
+	{
+		Next(key);
+		Quoted(value);
+	}
+	inline void Value(const char *key, const std::string &value) { Value(key, value.c_str()); }
+	void Value(const char *key, bool value)
+	{
+		Next(key);
+		Append(value ? "true" : "false");
+	}
+	void Value(const char *key, int value)
+	{
+		Next(key);
+		Appendf("%d", value);
+	}
+	void Value(const char *key, unsigned int value)
+	{
+		Next(key);
+		Appendf("%u", value);
+	}
+	void Value(const char *key, long value)
+	{
+		Next(key);
+		Appendf("%ld", value);
+	}
+	void Value(const char *key, unsigned long value)
+	{
+		Next(key);
+		Appendf("%lu", value);
+	}
+	void Value(const char *key, unsigned long long value)
+	{
+		Next(key);
+		Appendf("%llu", value);
+	}
+	void Value(const char *key, double value)
+	{
+		Next(key);
+		Appendf("%.2f", value);
+	}
+};
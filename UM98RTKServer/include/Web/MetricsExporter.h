@@ -0,0 +1,104 @@
+#pragma once
+
+#include "ChunkedWriter.h"
+#include "Metrics.h"
+#include "LogLevel.h"
+
+// Longest a scrape should take (us). Slower ones are logged
+#define METRICS_SCRAPE_BUDGET_US 5000
+
+// Put in front of every exported name
+#define METRICS_PREFIX "rtk_"
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Write the metrics registry in the OpenMetrics text format
+/// .. The reply is streamed in chunks so a scrape never builds the whole
+/// .. reply on the heap
+class MetricsExporter
+{
+private:
+	ChunkedWriter _w;
+
+public:
+	MetricsExporter(WebServer &server) : _w(server)
+	{
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief Send every metric. The time taken is exported by the next scrape
+	void Send()
+	{
+		MetricSnapshot metrics;
+		_metrics.Snapshot(metrics);
+
+		_w.Begin("application/openmetrics-text; version=1.0.0; charset=utf-8");
+		for (int n = 0; n < (int)Metric::Count; n++)
+			WriteMetric(metrics, (Metric)n);
+		_w.Append("# EOF\n");
+		unsigned long time = _w.End();
+
+		_metrics.Set(Metric::MetricsScrapeTime, (int32_t)time);
+		if (time > METRICS_SCRAPE_BUDGET_US)
+			LogWarn(LogWeb, "W600 - Metrics scrape took %luus", time);
+	}
+
+private:
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief Write the family header and one sample set per caster
+	void WriteMetric(const MetricSnapshot &metrics, Metric metric)
+	{
+		const MetricInfo &info = Metrics::Info(metric);
+		const char *type = "histogram";
+		if (info.Kind == MetricKind::Counter)
+			type = "counter";
+		else if (info.Kind == MetricKind::Gauge)
+			type = "gauge";
+		_w.Appendf("# TYPE " METRICS_PREFIX "%s %s\n", info.Name, type);
+		_w.Appendf("# HELP " METRICS_PREFIX "%s %s\n", info.Name, info.Help);
+
+		int casters = info.PerCaster ? RTK_SERVERS : 1;
+		for (int caster = 0; caster < casters; caster++)
+		{
+			// Label set with braces, or nothing for a single value
+			char labels[24] = "";
+			if (info.PerCaster)
+				snprintf(labels, sizeof(labels), "{caster=\"%d\"}", caster);
+
+			switch (info.Kind)
+			{
+			case MetricKind::Counter:
+				_w.Appendf(METRICS_PREFIX "%s_total%s %u\n", info.Name, labels, metrics.Get(metric, caster));
+				break;
+
+			case MetricKind::Gauge:
+				_w.Appendf(METRICS_PREFIX "%s%s %d\n", info.Name, labels, metrics.GetGauge(metric, caster));
+				break;
+
+			case MetricKind::Histogram:
+				WriteHistogram(info.Name, labels, info.PerCaster ? caster : -1, metrics.GetHistogram(metric, caster));
+				break;
+			}
+		}
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief Registry buckets are counted separately. OpenMetrics wants them
+	/// .. cumulative with a final +Inf bucket equal to the count
+	void WriteHistogram(const char *name, const char *labels, int caster, const uint32_t *pSlots)
+	{
+		// Caster label to go in front of le
+		char prefix[24] = "";
+		if (caster >= 0)
+			snprintf(prefix, sizeof(prefix), "caster=\"%d\",", caster);
+
+		uint32_t total = 0;
+		for (size_t n = 0; n < METRIC_BUCKETS - 1; n++)
+		{
+			total += pSlots[n];
+			_w.Appendf(METRICS_PREFIX "%s_bucket{%sle=\"%u\"} %u\n", name, prefix, METRIC_BUCKET_EDGES[n], total);
+		}
+		_w.Appendf(METRICS_PREFIX "%s_bucket{%sle=\"+Inf\"} %u\n", name, prefix, pSlots[METRIC_BUCKETS]);
+		_w.Appendf(METRICS_PREFIX "%s_count%s %u\n", name, labels, pSlots[METRIC_BUCKETS]);
+		_w.Appendf(METRICS_PREFIX "%s_sum%s %u\n", name, labels, pSlots[METRIC_BUCKETS + 1]);
+	}
+};
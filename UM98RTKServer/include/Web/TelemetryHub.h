@@ -0,0 +1,233 @@
+#pragma once
+
+#include <WiFi.h>
+#include <lwip/sockets.h>
+#include <errno.h>
+#include <stdarg.h>
+
+#include "GpsParser.h"
+#include "Metrics.h"
+
+// Most live viewers at once
+#define TELEMETRY_MAX_CLIENTS 4
+
+// Largest single event
+#define TELEMETRY_EVENT_MAX 1024
+
+// Most RTCM message types tracked for the per type deltas
+#define TELEMETRY_MAX_TYPES 32
+
+// Time between events
+#define TELEMETRY_INTERVAL_MS 1000
+
+extern GpsParser _gpsParser;
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Push live telemetry to browsers with Server-Sent Events
+/// .. Once a second one compact JSON event is built from the metrics registry
+/// .. and the same bytes are written to every viewer. Counters are sent as
+/// .. the change since the last event and gauges only when they change, so
+/// .. the page merges each event into what it already shows. Writes never
+/// .. block. A viewer that takes part of an event gets the rest on the next
+/// .. loops and is only dropped if it is still behind when the next event is due
+class TelemetryHub
+{
+private:
+	WiFiClient _clients[TELEMETRY_MAX_CLIENTS]; // Open event streams (Holding the client keeps the socket open)
+	char _event[TELEMETRY_EVENT_MAX];			// Event being built
+	size_t _length = 0;							// Bytes in _event
+	size_t _sent[TELEMETRY_MAX_CLIENTS] = {};	// Bytes of _event each viewer has taken
+	MetricSnapshot _last;						// Registry at the last event
+	bool _sendAll = true;						// Next event includes every gauge (A viewer joined)
+	unsigned long _lastTick = 0;				// Time of the last event
+	int _types[TELEMETRY_MAX_TYPES];			// RTCM types seen
+	int _typeCounts[TELEMETRY_MAX_TYPES];		// Totals for _types at the last event
+	int _typeCount = 0;							// Entries used in _types
+
+public:
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief Take over the current request as an event stream
+	/// .. The web server lets go of the client when the handler returns. The
+	/// .. copy kept here holds the socket open
+	void Subscribe(WiFiClient client)
+	{
+		int slot = -1;
+		for (int n = 0; n < TELEMETRY_MAX_CLIENTS; n++)
+		{
+			if (!_clients[n].connected())
+			{
+				slot = n;
+				break;
+			}
+		}
+		if (slot < 0)
+		{
+			client.print("HTTP/1.1 503 Service Unavailable\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+			return;
+		}
+
+		client.print("HTTP/1.1 200 OK\r\n"
+					 "Content-Type: text/event-stream\r\n"
+					 "Cache-Control: no-cache\r\n"
+					 "Connection: keep-alive\r\n"
+					 "Access-Control-Allow-Origin: *\r\n\r\n"
+					 "retry: 3000\n\n");
+		_clients[slot] = client;
+		_sent[slot] = _length; // Starts with the next event
+		_sendAll = true;
+		Logf("Live viewer %d joined from %s", slot, client.remoteIP().toString().c_str());
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief Send an event if it is time and the rest of the last one. Call often
+	void Loop()
+	{
+		unsigned long now = millis();
+		if ((now - _lastTick) < TELEMETRY_INTERVAL_MS)
+		{
+			Flush();
+			return;
+		}
+		_lastTick = now;
+
+		int viewers = 0;
+		for (int n = 0; n < TELEMETRY_MAX_CLIENTS; n++)
+			if (_clients[n].connected())
+				viewers++;
+
+		// Keep the baseline moving so the first event for a viewer is a one second delta
+		MetricSnapshot metrics;
+		_metrics.Snapshot(metrics);
+		if (viewers > 0)
+		{
+			DropLagging();
+			BuildEvent(metrics);
+			for (auto &sent : _sent)
+				sent = 0;
+			Flush();
+			_sendAll = false;
+		}
+		else
+		{
+			UpdateTypeTotals(false);
+		}
+		_last = metrics;
+	}
+
+private:
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief Build the event from the change since the last one
+	void BuildEvent(const MetricSnapshot &metrics)
+	{
+		_length = 0;
+		Appendf("data: {\"t\":%lu", millis() / 1000);
+		AppendGauge("rssi", metrics, Metric::WifiRssi);
+		AppendGauge("heap", metrics, Metric::HeapFree);
+		AppendGauge("temp", metrics, Metric::Temperature);
+		Appendf(",\"gps\":%u", metrics.Get(Metric::GpsPackets) - _last.Get(Metric::GpsPackets));
+
+		// Packets of each type
+		Appendf(",\"types\":{");
+		UpdateTypeTotals(true);
+		Appendf("}");
+
+		// Casters as [queued bytes, packets sent, mean send time (us)]
+		Appendf(",\"c\":[");
+		for (int c = 0; c < RTK_SERVERS; c++)
+		{
+			const uint32_t *pNow = metrics.GetHistogram(Metric::CasterSendTime, c);
+			const uint32_t *pLast = _last.GetHistogram(Metric::CasterSendTime, c);
+			uint32_t sends = pNow[METRIC_BUCKETS] - pLast[METRIC_BUCKETS];
+			uint32_t sendTime = pNow[METRIC_BUCKETS + 1] - pLast[METRIC_BUCKETS + 1];
+			Appendf("%s[%d,%u,%u]", c == 0 ? "" : ",",
+					metrics.GetGauge(Metric::CasterQueueBytes, c),
+					metrics.Get(Metric::CasterPacketsSent, c) - _last.Get(Metric::CasterPacketsSent, c),
+					sends == 0 ? 0 : sendTime / sends);
+		}
+		Appendf("]}\n\n");
+	}
+
+	void AppendGauge(const char *name, const MetricSnapshot &metrics, Metric metric)
+	{
+		int32_t value = metrics.GetGauge(metric);
+		if (_sendAll || value != _last.GetGauge(metric))
+			Appendf(",\"%s\":%d", name, value);
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief Move the per type totals on. Writes the changes if asked
+	void UpdateTypeTotals(bool write)
+	{
+		GpsSnapshot gps;
+		_gpsParser.GetSnapshot(gps);
+		bool first = true;
+		for (int t = 0; t < gps.TypeCount; t++)
+		{
+			int n = 0;
+			while (n < _typeCount && _types[n] != gps.Types[t])
+				n++;
+			if (n == _typeCount)
+			{
+				if (_typeCount == TELEMETRY_MAX_TYPES)
+					continue;
+				_types[n] = gps.Types[t];
+				_typeCounts[n] = 0;
+				_typeCount++;
+			}
+			int delta = gps.Counts[t] - _typeCounts[n];
+			_typeCounts[n] = gps.Counts[t];
+			if (write && delta != 0)
+			{
+				Appendf("%s\"%d\":%d", first ? "" : ",", gps.Types[t], delta);
+				first = false;
+			}
+		}
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief Write what each viewer has not taken of the event without blocking
+	void Flush()
+	{
+		for (int n = 0; n < TELEMETRY_MAX_CLIENTS; n++)
+		{
+			WiFiClient &client = _clients[n];
+			if (_sent[n] >= _length || !client.connected())
+				continue;
+			int sent = lwip_send(client.fd(), _event + _sent[n], _length - _sent[n], MSG_DONTWAIT);
+			if (sent > 0)
+			{
+				_sent[n] += sent;
+			}
+			else if (sent < 0 && errno != EWOULDBLOCK && errno != EAGAIN)
+			{
+				Logf("Live viewer %d dropped (Error %d)", n, errno);
+				client.stop();
+			}
+		}
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief Drop viewers that have not taken the whole event before the next
+	void DropLagging()
+	{
+		for (int n = 0; n < TELEMETRY_MAX_CLIENTS; n++)
+		{
+			WiFiClient &client = _clients[n];
+			if (_sent[n] < _length && client.connected())
+			{
+				Logf("Live viewer %d dropped (Sent %d of %d)", n, (int)_sent[n], (int)_length);
+				client.stop();
+			}
+		}
+	}
+
+	void Appendf(const char *format, ...)
+	{
+		va_list args;
+		va_start(args, format);
+		int length = vsnprintf(_event + _length, sizeof(_event) - _length, format, args);
+		va_end(args);
+		if (length > 0)
+			_length = min(_length + length, sizeof(_event) - 1);
+	}
+};
@@ -0,0 +1,327 @@
+#pragma once
+
+#include <SPIFFS.h>
+
+#include "Global.h"
+#include "GpsParser.h"
+#include "History.h"
+#include "Metrics.h"
+#include "NTRIPServer.h"
+#include "JsonWriter.h"
+
+extern NTRIPServer _ntripServer0;
+extern NTRIPServer _ntripServer1;
+extern NTRIPServer _ntripServer2;
+extern GpsParser _gpsParser;
+extern History _history;
+extern std::string _mdnsHostName;
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief JSON status replies for dashboards
+/// .. Every reply is streamed through a JsonWriter and reads its counters
+/// .. from one registry snapshot, the same values the status page shows
+class WebApi
+{
+private:
+	JsonWriter _j;
+	MetricSnapshot _snapshot;
+
+public:
+	WebApi(WebServer &server) : _j(server)
+	{
+		_metrics.Snapshot(_snapshot);
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief Everything. System, GPS and casters (/api/status)
+	void StatusJson()
+	{
+		_j.Begin();
+		_j.BeginObject();
+		WriteSystem();
+		_j.BeginObject("gps");
+		WriteGps();
+		_j.EndObject();
+		WriteCasters();
+		_j.EndObject();
+		_j.End();
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief Just the casters (/api/casters)
+	void CastersJson()
+	{
+		_j.Begin();
+		_j.BeginObject();
+		WriteCasters();
+		_j.EndObject();
+		_j.End();
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief Just the GPS (/api/gps)
+	void GpsJson()
+	{
+		_j.Begin();
+		_j.BeginObject();
+		WriteGps();
+		_j.EndObject();
+		_j.End();
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief Enqueue to wire latency percentiles (us) for each caster (/api/latency)
+	/// .. Frames that expired or were dropped are included at their age
+	void LatencyJson()
+	{
+		_j.Begin();
+		_j.BeginArray();
+		for (auto pServer : {&_ntripServer0, &_ntripServer1, &_ntripServer2})
+		{
+			_j.BeginObject();
+			_j.Value("index", pServer->GetIndex());
+			_j.Value("address", pServer->GetAddress());
+			WriteLatency(*pServer);
+			_j.EndObject();
+		}
+		_j.EndArray();
+		_j.End();
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief Time and size of each route (/api/routes)
+	void RoutesJson()
+	{
+		_j.Begin();
+		_j.BeginArray();
+		for (int n = 0; n < _webRoutes.GetCount(); n++)
+		{
+			const WebRoute &route = _webRoutes.Get(n);
+			_j.BeginObject();
+			_j.Value("name", route.Name);
+			_j.Value("count", route.Count);
+			_j.Value("overBudget", route.OverBudget);
+			_j.Value("lastUs", route.LastUs);
+			_j.Value("meanUs", route.Count ? (unsigned long long)(route.TotalUs / route.Count) : 0ULL);
+			_j.Value("maxUs", route.MaxUs);
+			_j.Value("maxBytes", route.MaxBytes);
+			_j.Value("maxHeapUsed", route.MaxHeapUsed);
+			_j.Value("budgetMs", route.BudgetMs);
+			_j.Value("budgetBytes", (unsigned long)route.BudgetBytes);
+			_j.EndObject();
+		}
+		_j.EndArray();
+		_j.End();
+	}
+
+private:
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief Device, WiFi, memory and storage
+	void WriteSystem()
+	{
+		_j.Value("version", APP_VERSION);
+		_j.Value("uptimeMs", millis());
+		_j.Value("time", _handyTime.LongString());
+		_j.Value("temperature", _snapshot.GetGauge(Metric::Temperature));
+
+		_j.BeginObject("wifi");
+		_j.Value("connected", WiFi.status() == WL_CONNECTED);
+		_j.Value("rssi", (int)WiFi.RSSI());
+		_j.Value("mac", WiFi.macAddress().c_str());
+		_j.Value("ip", WiFi.localIP().toString().c_str());
+		_j.Value("host", _mdnsHostName);
+		_j.Value("mode", WiFi.getMode() == WIFI_STA ? "STA" : (WiFi.getMode() == WIFI_AP ? "AP" : (WiFi.getMode() == WIFI_AP_STA ? "AP_STA" : "Unknown")));
+		_j.EndObject();
+
+		_j.BeginObject("heap");
+		_j.Value("free", ESP.getFreeHeap());
+		_j.Value("minFree", ESP.getMinFreeHeap());
+		_j.Value("maxAlloc", ESP.getMaxAllocHeap());
+		_j.Value("total", ESP.getHeapSize());
+		_j.Value("stackHigh", uxTaskGetStackHighWaterMark(nullptr));
+		_j.EndObject();
+
+		_j.BeginObject("spiffs");
+		_j.Value("used", SPIFFS.usedBytes());
+		_j.Value("total", SPIFFS.totalBytes());
+		_j.EndObject();
+
+		_j.BeginObject("web");
+		_j.Value("renders", _snapshot.GetHistogram(Metric::WebRenderTime)[METRIC_BUCKETS]);
+		_j.Value("lastHeapUsed", _snapshot.GetGauge(Metric::WebHeapUsed));
+		_j.EndObject();
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief GPS device and receive counters
+	void WriteGps()
+	{
+		GpsSnapshot gps;
+		_gpsParser.GetSnapshot(gps);
+		_j.Value("deviceType", gps.DeviceType);
+		_j.Value("firmware", gps.DeviceFirmware);
+		_j.Value("serial", gps.DeviceSerial);
+		_j.Value("bytes", _snapshot.Get(Metric::GpsBytes));
+		_j.Value("rtcmPackets", _snapshot.Get(Metric::GpsPackets));
+		_j.Value("asciiPackets", _snapshot.Get(Metric::GpsAsciiPackets));
+		_j.Value("readErrors", _snapshot.Get(Metric::GpsReadErrors));
+		_j.Value("timeouts", _snapshot.Get(Metric::GpsTimeouts));
+		_j.Value("resets", _snapshot.Get(Metric::GpsResets));
+		_j.Value("reinitialise", _snapshot.Get(Metric::GpsReinitialise));
+		_j.Value("maxBuffer", gps.MaxBufferSize);
+
+		// Message type totals keyed by type number
+		_j.BeginObject("messages");
+		char key[12];
+		for (int n = 0; n < gps.TypeCount; n++)
+		{
+			snprintf(key, sizeof(key), "%d", gps.Types[n]);
+			_j.Value(key, gps.Counts[n]);
+		}
+		_j.EndObject();
+	}
+
+	void WriteCasters()
+	{
+		_j.BeginArray("casters");
+		for (auto pServer : {&_ntripServer0, &_ntripServer1, &_ntripServer2})
+			WriteCaster(*pServer);
+		_j.EndArray();
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief One caster. Passwords are never included
+	void WriteCaster(NTRIPServer &server)
+	{
+		int index = server.GetIndex();
+		CasterSnapshot caster;
+		server.GetSnapshot(caster);
+		_j.BeginObject();
+		_j.Value("index", index);
+		_j.Value("enabled", server.IsEnabled());
+		_j.Value("address", server.GetAddress());
+		_j.Value("port", server.GetPort());
+		_j.Value("mountPoint", server.GetCredential());
+		_j.Value("protocol", server.GetNtripVersion());
+		_j.Value("tls", server.IsTls());
+		_j.Value("status", caster.Status);
+		_j.Value("reconnects", _snapshot.Get(Metric::CasterReconnects, index));
+		_j.Value("packetsSent", _snapshot.Get(Metric::CasterPacketsSent, index));
+		_j.Value("queueOverflows", _snapshot.Get(Metric::CasterQueueOverflows, index));
+		_j.Value("expiredPackets", _snapshot.Get(Metric::CasterExpiredPackets, index));
+		_j.Value("queuedBytes", _snapshot.GetGauge(Metric::CasterQueueBytes, index));
+		_j.Value("sendTimeouts", caster.TotalTimeouts);
+
+		_j.BeginObject("health");
+		_j.Value("score", caster.HealthScore);
+		_j.Value("breaker", caster.Breaker);
+		_j.Value("nextRetryMs", caster.NextRetryMs);
+		_j.EndObject();
+
+		if (caster.RejectedAt != 0)
+		{
+			_j.BeginObject("refusal");
+			_j.Value("reason", caster.RejectReason);
+			_j.Value("agoMs", millis() - caster.RejectedAt);
+			_j.Value("suspended", caster.Rejected);
+			_j.EndObject();
+		}
+
+		_j.BeginObject("drops");
+		_j.Value("station", caster.ClassDrops[RtcmClassStation]);
+		_j.Value("msm", caster.ClassDrops[RtcmClassMsm]);
+		_j.Value("other", caster.ClassDrops[RtcmClassOther]);
+		_j.EndObject();
+
+		_j.BeginObject("expired");
+		_j.Value("station", caster.Expired[RtcmClassStation]);
+		_j.Value("msm", caster.Expired[RtcmClassMsm]);
+		_j.Value("other", caster.Expired[RtcmClassOther]);
+		_j.EndObject();
+
+		_j.BeginObject("send");
+		_j.Value("medianUs", _history.MedianSendTime(index));
+		_j.Value("maxUs", caster.MaxSendTime);
+		_j.Value("writes", caster.TotalWrites);
+		_j.Value("writesPerSecond", caster.WritesPerSecond);
+		_j.Value("bytesPerWrite", caster.BytesPerWrite);
+		_j.Value("catchUpMs", caster.LastCatchUpTime);
+		_j.Value("maxCatchUpMs", caster.MaxCatchUpTime);
+		_j.Value("wouldBlocks", caster.WouldBlocks);
+		_j.Value("blockedMs", caster.BlockedTime);
+		_j.Value("sendBuffer", caster.SendBufferSize);
+		_j.EndObject();
+
+		_j.BeginObject("latencyUs");
+		WriteLatency(server);
+		_j.EndObject();
+
+		_j.BeginObject("stackHigh");
+		_j.Value("task", caster.MaxStackHeight);
+		_j.Value("standby", caster.StandbyStackHeight);
+		_j.EndObject();
+
+		if (!server.GetStandbyAddress().empty())
+		{
+			_j.BeginObject("standby");
+			_j.Value("address", server.GetStandbyAddress());
+			_j.Value("activeHost", caster.ActiveHost);
+			_j.Value("ready", caster.StandbyReady);
+			_j.Value("failovers", caster.Failovers);
+			_j.Value("lastFailoverMs", caster.LastFailoverTime);
+			_j.EndObject();
+		}
+
+		if (server.IsTls())
+		{
+			_j.BeginObject("tls");
+			_j.Value("handshakeMs", caster.HandshakeTime);
+			_j.Value("resumed", caster.ResumedHandshakes);
+			_j.Value("full", caster.FullHandshakes);
+			_j.Value("heapUsed", caster.TlsHeapUsed);
+			_j.Value("encryptUsPerKb", caster.EncryptMicrosPerKb);
+			_j.Value("fingerprint", caster.TlsFingerprint);
+			_j.EndObject();
+		}
+
+		_j.BeginObject("bandwidth");
+		_j.Value("sent", (unsigned long long)caster.TotalSent);
+		_j.Value("received", (unsigned long long)caster.TotalReceived);
+		_j.Value("today", (unsigned long long)caster.DaySent);
+		_j.Value("month", (unsigned long long)caster.MonthSent);
+		_j.Value("rate1s", caster.Rate1s);
+		_j.Value("rate1m", caster.Rate1m);
+		_j.Value("rate1h", caster.Rate1h);
+		_j.EndObject();
+
+		_j.BeginObject("quota");
+		_j.Value("state", caster.QuotaStatus);
+		_j.Value("dailyMB", server.GetQuota().DailyMB);
+		_j.Value("monthlyMB", server.GetQuota().MonthlyMB);
+		_j.Value("msmSkipped", caster.QuotaDrops);
+		_j.EndObject();
+
+		_j.Value("snapshotAgeMs", millis() - caster.Time);
+		_j.EndObject();
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief Enqueue to wire percentiles for the last window and the lifetime
+	void WriteLatency(const NTRIPServer &server)
+	{
+		for (bool window : {true, false})
+		{
+			LatencySummary latency;
+			server.GetQueueLatency().Summarise(latency, window);
+			_j.BeginObject(window ? "window" : "lifetime");
+			_j.Value("count", latency.Count);
+			_j.Value("p50", latency.P50);
+			_j.Value("p90", latency.P90);
+			_j.Value("p99", latency.P99);
+			_j.Value("max", latency.Max);
+			_j.Value("expired", latency.Expired);
+			_j.Value("dropped", latency.Dropped);
+			_j.EndObject();
+		}
+	}
+};
@@ -0,0 +1,295 @@
+#pragma once
+
+// Generated by Tools/MakeWebAssets.py from the files in Web/. Do not edit
+
+#include <Arduino.h>
+
+// chart.js (3126 bytes before gzip)
+static const uint8_t WEB_ASSET_0[] PROGMEM = {
+	0x1f,0x8b,0x08,0x00,0x00,0x00,0x00,0x00,0x02,0x03,0x8d,0x56,0x59,0x8f,0xdb,0x36,0x10,0x7e,0xf6,0xfe,
+	0x8a,0x29,0x16,0xa8,0xa8,0xac,0x57,0x3e,0xf6,0xc8,0xc2,0x8e,0x13,0x34,0x69,0xd2,0x06,0x4d,0x80,0x20,
+	0x1b,0x24,0x01,0x82,0x7d,0xa0,0x25,0xca,0x22,0x42,0x53,0x02,0x49,0x1f,0xea,0x66,0xff,0x53,0x5f,0xfa,
+	0x07,0xfa,0xcb,0x3a,0x43,0x4a,0xb6,0xf6,0x48,0x90,0x17,0x1d,0x73,0x71,0x66,0xbe,0x99,0xe1,0x0c,0x06,
+	0x70,0xb9,0xe4,0x4a,0x81,0x92,0x5a,0x40,0x5a,0x70,0xe3,0x20,0x2f,0x0d,0xb8,0x42,0xc0,0xfb,0x0f,0x7f,
+	0xc1,0xa5,0x30,0x6b,0x61,0xa0,0xe2,0x0b,0x61,0x81,0x5d,0x3a,0xae,0x33,0x0b,0x52,0x7b,0x99,0x77,0xaa,
+	0x74,0xaa,0x8e,0x0f,0x06,0x03,0x48,0x12,0x78,0x83,0x06,0x5e,0x90,0x3e,0xcb,0xe4,0xfa,0x75,0xd6,0x07,
+	0x27,0x9d,0x12,0x7d,0xa8,0x3f,0x72,0xb5,0x42,0xe5,0x2f,0x7d,0xd8,0x86,0xcf,0xab,0x56,0xe5,0x95,0x70,
+	0x69,0xf1,0x90,0xce,0xca,0x28,0xfc,0xae,0x2b,0x11,0x43,0x66,0xf8,0xc6,0x02,0x87,0xb9,0xd4,0xdc,0xd4,
+	0x60,0x85,0x91,0x68,0x2c,0x37,0xe5,0x12,0x06,0xbc,0x92,0x83,0x42,0x5a,0x57,0x9a,0xba,0xb1,0xf8,0x19,
+	0x32,0x91,0xf3,0x95,0x72,0x16,0x5c,0xe9,0x83,0xb0,0x7c,0x59,0x29,0x81,0x2e,0x67,0x62,0x9b,0xc0,0x9f,
+	0x25,0x45,0x63,0x8b,0x12,0x6d,0x12,0x57,0x0b,0x6e,0x84,0x75,0x50,0x95,0x52,0xbb,0x83,0x7c,0xa5,0x53,
+	0x27,0x4b,0xfd,0xfd,0x58,0x2c,0x06,0x61,0x63,0xb8,0x3e,0xe8,0xa5,0xa5,0x46,0x3d,0x64,0xc3,0x0c,0xb2,
+	0x32,0x5d,0x2d,0x85,0x76,0xc9,0x42,0xb8,0x97,0x4a,0xd0,0xe7,0xf3,0xfa,0x75,0x16,0x94,0xe3,0xe9,0x41,
+	0x4f,0xe6,0xc0,0x7e,0xc1,0xbf,0x18,0x8c,0x70,0x2b,0xa3,0x91,0xb4,0xb5,0xa8,0x88,0x8f,0x6f,0xdf,0xd0,
+	0x6a,0xb2,0xe4,0x15,0x63,0xeb,0x3e,0xc8,0x18,0x66,0x4f,0xf1,0x39,0x6d,0x0f,0x48,0xb9,0x5e,0x73,0xdb,
+	0x3d,0x23,0x35,0x82,0x3b,0xd1,0x1c,0xc3,0xa2,0x20,0x10,0xed,0x35,0x9c,0xac,0x7e,0x20,0x8e,0x4e,0x78,
+	0x59,0x94,0x4a,0xac,0xab,0x95,0x48,0x52,0x6b,0x3f,0x88,0xad,0x43,0x9d,0xa8,0x2a,0xad,0xa4,0xf8,0x27,
+	0x7c,0x6e,0x4b,0xb5,0x72,0x62,0x9a,0x49,0x5b,0x29,0x5e,0x4f,0x74,0xa9,0xc5,0x74,0xce,0xd3,0xaf,0x0b,
+	0x53,0xae,0x74,0x36,0x39,0x1c,0x0e,0x87,0xe9,0x34,0x2d,0x55,0x69,0x26,0x87,0x79,0x9e,0x4f,0x2b,0x9e,
+	0x65,0x52,0x2f,0x26,0xe3,0x6a,0x0b,0xe7,0xd5,0x76,0x3a,0x2f,0x4d,0x26,0xcc,0xb1,0xe1,0x99,0x5c,0xd9,
+	0xc9,0x29,0x52,0xf2,0x52,0xbb,0xc9,0x88,0xf8,0x96,0x6b,0x7b,0x4c,0x40,0xa2,0x1a,0xe5,0x1d,0xe5,0xc4,
+	0x1a,0xbd,0xb3,0xfe,0x98,0x08,0xbd,0x43,0x2f,0x1b,0xef,0x5a,0x97,0xc8,0x3d,0x23,0x14,0x77,0x72,0xbd,
+	0x93,0x30,0x02,0x7d,0x4b,0x11,0x28,0xa9,0x32,0x23,0x34,0x0b,0xa9,0x20,0xb0,0x2a,0x0c,0xb1,0xcd,0x07,
+	0x7a,0x86,0xca,0xd7,0xa0,0x26,0x70,0x3e,0xec,0x83,0x99,0xc0,0xe8,0x1c,0x65,0x26,0x70,0x82,0xaf,0xf9,
+	0x04,0xc6,0x17,0x70,0x83,0x06,0x95,0x70,0xb0,0xe9,0x43,0x81,0x00,0xbf,0x95,0x9a,0x9e,0x7c,0x8b,0x80,
+	0xfb,0xef,0x1a,0xbf,0x77,0xf9,0xc5,0x00,0x10,0x38,0x82,0x09,0x2d,0x27,0x0a,0x8e,0x80,0x6d,0xe1,0xd8,
+	0x6b,0xc5,0x30,0xc0,0x1f,0x14,0x6e,0xfe,0x09,0xdc,0x51,0x0c,0x8f,0x80,0x6d,0x90,0x12,0xc4,0xc3,0xdb,
+	0xec,0xf1,0xaa,0x6a,0xb4,0x57,0x93,0xbd,0xa2,0x61,0xce,0xf1,0xcd,0x6a,0x7c,0xd4,0xad,0xcd,0x3a,0xd8,
+	0xac,0x6f,0xd9,0x6c,0xc5,0x5d,0xab,0xe6,0x83,0xde,0xd5,0x30,0x35,0x0e,0xf3,0xa5,0xda,0xd6,0x6a,0x65,
+	0xf0,0xa4,0x0d,0x76,0x42,0xb9,0x49,0x32,0xb1,0x96,0xa9,0x78,0x27,0xb7,0x42,0xbd,0xc7,0xa4,0x96,0xde,
+	0x2c,0xfa,0xd4,0xdb,0x50,0xf1,0x60,0x72,0x53,0x25,0x11,0x92,0x4f,0x32,0x73,0x05,0xf1,0x1e,0x0f,0x87,
+	0xc4,0x2d,0x90,0x7b,0x32,0xf6,0x9f,0x21,0xdb,0xc9,0xc6,0x4b,0xa0,0x5d,0x74,0x09,0x4f,0xe8,0x70,0x0a,
+	0x21,0x17,0x05,0xd5,0x55,0x71,0x8f,0x15,0xb0,0xdd,0xab,0x1e,0x61,0xed,0x6d,0xa3,0x7b,0x02,0x1d,0x0b,
+	0x1d,0x89,0xd0,0x17,0x48,0x6d,0x64,0xb1,0xe9,0x5e,0x60,0x6d,0x61,0x0d,0xb3,0x68,0x9c,0xf9,0xea,0xee,
+	0xa5,0x89,0x4d,0xb9,0x12,0x0c,0x8f,0xed,0xd3,0xd9,0x3e,0x35,0x3d,0x8f,0xc9,0x0c,0xde,0x72,0x57,0x24,
+	0x4b,0xa9,0x59,0x92,0x24,0xd8,0xcd,0x53,0x8f,0xf5,0x8e,0xce,0xb7,0x2d,0x1d,0x35,0xea,0x3b,0x1a,0x58,
+	0x40,0xc8,0xac,0x49,0xa9,0xbe,0xaf,0x54,0x07,0x25,0xdf,0xed,0xd2,0xbe,0x92,0x5a,0x3a,0xe1,0xb1,0x8b,
+	0x11,0x07,0x68,0x6c,0x0d,0x77,0xaa,0xa3,0x29,0xdc,0x1c,0x78,0x67,0xa9,0x37,0xa8,0xc2,0xef,0xb4,0x47,
+	0x88,0x37,0xc9,0xa5,0x52,0x97,0x94,0x10,0x12,0x39,0x3c,0x39,0x39,0x69,0xe8,0x14,0xf2,0x6f,0x4a,0x2e,
+	0x7c,0x73,0xa4,0x82,0x1a,0xa9,0xa3,0x41,0x4d,0xcd,0xfc,0xdc,0x6a,0x1b,0x85,0x0d,0x7e,0x3d,0x1c,0x5d,
+	0x8c,0xa6,0x83,0x45,0x1f,0xa2,0xff,0xfe,0x8d,0xe2,0x0e,0x23,0x13,0x8b,0x86,0xfe,0x4f,0x14,0xf7,0x11,
+	0x92,0x01,0x8c,0xfb,0x30,0x1e,0x86,0xc4,0xe1,0x70,0xfd,0xc3,0xc8,0x0c,0x8b,0x07,0x01,0x3b,0x03,0xeb,
+	0x44,0x65,0x01,0x6b,0xac,0x0e,0xa9,0x76,0xa6,0xfc,0x2a,0xf6,0x1e,0x66,0x59,0xf6,0x90,0x87,0x86,0xc0,
+	0xf4,0x0c,0xba,0x3c,0x18,0x35,0x9c,0x0c,0xf9,0x90,0xf0,0x64,0x06,0x67,0xf8,0x3e,0x3a,0x0a,0x05,0xdb,
+	0x80,0xec,0x3b,0x83,0xb2,0x76,0x74,0xab,0x05,0xa8,0xfa,0x25,0x3a,0x78,0x36,0xf5,0xa2,0xc9,0x5c,0x2c,
+	0xa4,0x7e,0x87,0x38,0x30,0x84,0x25,0x4d,0x96,0x38,0xe3,0x3f,0x94,0xcc,0xb7,0x5b,0x1f,0xdb,0x8b,0xd5,
+	0xb1,0xa7,0xd3,0x0d,0x87,0xf4,0xb6,0x15,0x4d,0x97,0x17,0x42,0x60,0x71,0x63,0x71,0x97,0x3f,0x8f,0xae,
+	0x1f,0x79,0xd8,0x90,0x8f,0x60,0x34,0xa4,0x76,0x1c,0x61,0x15,0xb4,0xcd,0x7c,0xde,0x58,0x41,0x17,0x4f,
+	0xbd,0xf6,0xcd,0x0f,0xa1,0xf9,0xd9,0xc8,0xfd,0x8c,0x69,0x22,0xef,0x0c,0x94,0xbb,0x91,0x3f,0xe4,0xe7,
+	0x16,0xe1,0xab,0xb6,0xfe,0x45,0x13,0xe2,0xa2,0xf1,0xea,0x41,0xa4,0x46,0xf9,0xe3,0xc7,0xf3,0xd3,0x06,
+	0x2c,0xca,0xcf,0xa7,0xa6,0x25,0x47,0xc9,0x59,0x20,0x76,0x73,0x4b,0xfd,0x60,0xb1,0x56,0xcd,0x4b,0x9e,
+	0x16,0x8c,0xd5,0xbb,0xeb,0x0a,0x9e,0xed,0xd3,0x4b,0x47,0xdb,0x2f,0xf2,0x2a,0x6e,0xd3,0x0b,0x93,0x0e,
+	0x26,0x77,0x99,0x6d,0xb3,0xee,0xd3,0x4f,0x9e,0x36,0x8d,0x5d,0xea,0x65,0xb9,0xb2,0x82,0x74,0xd1,0x25,
+	0x41,0x47,0x5d,0xb7,0xed,0x85,0x8e,0x28,0xa1,0x17,0xae,0xe8,0x5c,0xa9,0x4d,0xee,0xcc,0xad,0xd1,0xf0,
+	0x9c,0x92,0x82,0x37,0xd3,0x0b,0x3f,0xcf,0xde,0x8b,0xd4,0x85,0x48,0xee,0xe7,0x59,0x34,0x33,0xef,0x33,
+	0x66,0xcd,0xa0,0xf5,0xbc,0x1d,0xac,0xca,0xcf,0xe0,0xfb,0x23,0x9c,0x86,0x70,0x17,0x1c,0x32,0x4b,0xd8,
+	0x86,0x2e,0xa7,0x79,0xd3,0xc9,0xd6,0xee,0x72,0xbf,0x06,0x0a,0xc0,0x03,0x86,0xd7,0x2c,0x5b,0x93,0x76,
+	0x0c,0x4f,0x60,0x47,0xc1,0x0c,0xe9,0x2b,0x4f,0x8d,0xbd,0x29,0x89,0x63,0xc2,0xdb,0xa6,0x3b,0x9b,0x0a,
+	0xcb,0x4f,0x3b,0x3f,0x30,0x82,0x28,0xce,0x46,0x4c,0x72,0x84,0xef,0x9a,0xfe,0x5b,0xd1,0x30,0x43,0x7d,
+	0x1c,0x33,0x08,0x99,0xd7,0x57,0x54,0xa8,0x17,0x9d,0x69,0xba,0x17,0x74,0x25,0xed,0x0d,0x04,0x4b,0x90,
+	0x3b,0x86,0xf1,0xe9,0x83,0x82,0xcd,0x4e,0x40,0x05,0x34,0x57,0x65,0xfa,0x95,0xd8,0x74,0x83,0xde,0x46,
+	0x4d,0x09,0xee,0x61,0x63,0x3e,0xe8,0x07,0xb5,0xdb,0xdb,0xbe,0xb9,0x92,0x70,0x83,0x78,0x49,0x6b,0xc0,
+	0x1b,0xdc,0xe8,0x84,0x16,0x86,0xe1,0x85,0x6f,0xe5,0xdf,0x22,0xea,0xfb,0xbb,0x8c,0x52,0x10,0xee,0xb4,
+	0xe9,0x01,0x16,0x09,0x8e,0x24,0xbf,0x3e,0xe2,0x6a,0xa8,0xa4,0xc3,0x29,0x07,0x02,0x71,0xe6,0xba,0xdd,
+	0x10,0x59,0x24,0x4f,0xc6,0x11,0x60,0xbf,0x45,0xf2,0x22,0x8a,0x01,0x17,0xd7,0x66,0xbd,0x95,0x9d,0x45,
+	0xef,0x67,0x36,0x50,0xac,0xb9,0x9c,0xc4,0x18,0xd2,0x62,0xcc,0x44,0x82,0x8b,0xa3,0x66,0x86,0xc2,0x32,
+	0x09,0x37,0x86,0xd7,0xcf,0x57,0x79,0x8e,0xfe,0xc6,0x7b,0xee,0xbc,0x2d,0xd6,0xa6,0xce,0x68,0x4b,0xd4,
+	0x62,0x03,0xbf,0x73,0xc7,0x3f,0x4a,0xb1,0x61,0xf3,0x66,0xd4,0x84,0x39,0x47,0x0b,0x1e,0x1d,0x06,0xb3,
+	0x99,0x77,0x97,0x58,0xbd,0x67,0xf0,0x1b,0x19,0x4f,0x68,0xd7,0x65,0xa4,0xfc,0x5a,0xbb,0x0b,0x4f,0x42,
+	0xed,0xd8,0x8b,0x4c,0xba,0x22,0xb8,0xe2,0xf8,0x8e,0x98,0xc0,0x3c,0x99,0xd7,0x4e,0xbc,0xf1,0x7f,0xf0,
+	0xf4,0x29,0x8c,0xe1,0xa6,0x8f,0xa5,0xda,0x56,0xe0,0x9a,0xfa,0x02,0x8d,0x9d,0x8c,0x99,0xc4,0x1a,0x3e,
+	0xc5,0x40,0xcd,0x4a,0x84,0x5e,0xec,0x7d,0x7f,0xf5,0x0d,0x83,0xc4,0x67,0xff,0x7f,0xa3,0x7e,0xfa,0xeb,
+	0x36,0x0c,0x00,0x00,
+};
+
+// portal.css (10823 bytes before gzip)
+static const uint8_t WEB_ASSET_1[] PROGMEM = {
+	0x1f,0x8b,0x08,0x00,0x00,0x00,0x00,0x00,0x02,0x03,0xe5,0x5a,0xed,0x6f,0xdb,0xbc,0x11,0xff,0xdc,0xfc,
+	0x15,0x5c,0x8a,0xc2,0x71,0x6b,0x2a,0x7a,0xb1,0x6c,0xd7,0x41,0x1e,0xe0,0x69,0xd1,0xa1,0xc5,0x90,0x6d,
+	0x78,0xfa,0xac,0x5f,0xb6,0x7d,0xa0,0x24,0xda,0x52,0x23,0x4b,0x7a,0x24,0xda,0x8e,0x13,0xf4,0x7f,0xdf,
+	0x1d,0xa9,0x77,0x51,0x49,0x83,0x62,0x40,0x87,0x21,0xb1,0x43,0x1d,0x8f,0xc7,0xe3,0xdd,0xf1,0x77,0x47,
+	0x2a,0x97,0xaf,0xc9,0x67,0x71,0x8a,0x79,0x41,0x36,0x69,0x4e,0x44,0xc8,0xc9,0x6f,0xbf,0xff,0x85,0x7c,
+	0xe6,0xf9,0x81,0xe7,0x24,0x4b,0x73,0xc1,0x62,0x72,0xf1,0x59,0xb0,0x24,0x28,0x48,0x94,0x48,0xa6,0x77,
+	0x69,0x2a,0x0a,0x91,0xb3,0x8c,0x00,0xb5,0xf5,0xf4,0xc9,0x4f,0x93,0x62,0x7a,0x46,0x5e,0x13,0xc3,0x20,
+	0x7f,0x4b,0xe2,0x93,0x14,0xd7,0xf4,0xbb,0xc4,0x8f,0x59,0x51,0xc0,0x54,0x48,0xcf,0xd8,0x16,0x5a,0xfb,
+	0x82,0xcf,0xc8,0x31,0x12,0xa1,0xa4,0x15,0x6c,0xc7,0x49,0x02,0x5f,0x45,0x29,0xe5,0xdd,0x3e,0x8a,0x05,
+	0xcc,0x2b,0x52,0xd9,0xbf,0x89,0xf2,0xdd,0x91,0xe5,0xc0,0x98,0xb6,0x64,0x1c,0xd3,0xfc,0x56,0xc9,0x48,
+	0x52,0xf2,0x29,0x11,0x3c,0x4f,0xb8,0x20,0x17,0xbf,0xfa,0x3e,0x2f,0x0a,0x58,0x03,0x0c,0x27,0xbb,0x34,
+	0xe0,0x95,0x6a,0x52,0x4f,0x82,0x62,0x76,0xac,0xb8,0x2d,0x48,0x8a,0x4b,0x45,0x71,0x82,0xdf,0x09,0xe2,
+	0xa7,0x71,0xba,0xcf,0x71,0x06,0x90,0xb6,0x49,0x61,0x6c,0x54,0x90,0x84,0xf3,0x80,0x07,0x30,0xfe,0xf2,
+	0x6c,0x9d,0xc3,0x82,0xc8,0xc3,0xd9,0x0b,0x4a,0xbd,0x82,0x66,0x79,0xb4,0x63,0xf9,0x69,0x4d,0x5e,0x9a,
+	0xc1,0x82,0x6f,0x82,0xab,0x92,0x5e,0x70,0x98,0x24,0x50,0x3d,0x0b,0x7f,0xe9,0x2e,0xeb,0x9e,0x63,0x18,
+	0x09,0x0e,0xd4,0xcd,0x66,0x53,0x91,0xbc,0x34,0x0f,0x78,0x0e,0xb4,0x80,0x73,0x9b,0x2f,0x2a,0x72,0xce,
+	0x82,0x68,0x5f,0xac,0x89,0xe1,0x2c,0xdd,0x9c,0xef,0xae,0xce,0xbe,0x9d,0x9d,0xbd,0x9e,0x9d,0xbd,0x5e,
+	0xaf,0x3d,0x0e,0x7e,0xe0,0xb2,0xc9,0x36,0xb0,0x5e,0x54,0xc7,0x4b,0xef,0x68,0x11,0xdd,0x47,0xc9,0x76,
+	0x4d,0x94,0x40,0x90,0x7b,0x27,0x07,0x79,0x69,0x70,0x42,0x16,0xd0,0x74,0x1b,0x25,0x6b,0x62,0xc2,0x0c,
+	0xb8,0x32,0xba,0x61,0xbb,0x28,0x06,0x15,0x8b,0x53,0x21,0xf8,0x8e,0xee,0xa3,0x19,0xa1,0x2c,0xcb,0x62,
+	0x4e,0x15,0x65,0x46,0xce,0x3f,0xf3,0x6d,0xca,0xc9,0x3f,0x3e,0x9d,0xcf,0xc8,0x6f,0xa9,0x97,0x8a,0x14,
+	0x68,0x1f,0x79,0x7c,0xe0,0x22,0xf2,0x19,0xf9,0x2b,0xdf,0x73,0xe8,0xf9,0x35,0x8f,0x58,0x3c,0x03,0xf7,
+	0x25,0xb8,0xf2,0x3c,0xda,0x54,0x13,0x80,0x42,0xb0,0x56,0x4b,0x6a,0xff,0x22,0x8e,0x12,0x4e,0x43,0x1e,
+	0x6d,0x43,0x01,0x34,0xc3,0x05,0x12,0x1a,0x1b,0x17,0x6e,0x5b,0xb6,0x6b,0xbf,0x05,0x82,0xc7,0xfc,0xdb,
+	0x6d,0x9e,0xee,0x93,0xa0,0x32,0x11,0xe8,0x1f,0x5a,0x33,0x12,0xda,0xf0,0x71,0xe0,0x33,0x87,0x8f,0xdb,
+	0x59,0x0d,0xfc,0x18,0xca,0x40,0x6a,0xd2,0x63,0x39,0x85,0x6b,0x9a,0xc3,0x59,0x6d,0x25,0xd1,0x41,0x09,
+	0x6d,0x15,0x8d,0xc6,0xc6,0x59,0x5f,0xba,0x55,0xf5,0x30,0xec,0x29,0x75,0x3e,0xb0,0xfc,0xa2,0x1d,0x02,
+	0x53,0xc9,0x61,0x14,0x3b,0x16,0xc7,0x3d,0xe1,0xc6,0x6a,0xe9,0x96,0x12,0x2e,0x61,0xbb,0x65,0xcc,0x07,
+	0x2f,0xc9,0xcd,0x13,0xb3,0x53,0xba,0x17,0x18,0x56,0xc6,0x8e,0x9a,0xe4,0x81,0x34,0xd3,0xfe,0x29,0xda,
+	0xc9,0xed,0x97,0x88,0x2b,0xf2,0x0d,0xba,0x3d,0x6a,0xd7,0xfd,0xe0,0x59,0x21,0xd2,0xdd,0x5a,0xad,0x5b,
+	0xc3,0xea,0x0c,0x59,0x2d,0x1d,0xa7,0xa0,0xf3,0x86,0x53,0xa4,0x99,0xf4,0x8b,0x86,0x31,0x93,0xca,0x65,
+	0x2c,0x08,0x64,0x7c,0x99,0xc3,0x7e,0xab,0xdd,0x6f,0xd8,0x7a,0x21,0xf3,0x36,0xd3,0xc8,0x4c,0xa7,0x36,
+	0xd7,0xa8,0x4e,0x55,0x7f,0xbd,0x3a,0xad,0xb0,0x2d,0xcb,0xa4,0xd5,0xe0,0xef,0x88,0xad,0x8e,0x94,0xed,
+	0x01,0x5c,0x1e,0x00,0x3f,0x02,0x11,0xae,0x89,0x7c,0x1a,0xf0,0x58,0xa6,0xd9,0xb0,0xc0,0xc3,0xab,0x3e,
+	0x4b,0x58,0xb2,0xd4,0x71,0xa6,0xe1,0x09,0xe8,0x26,0xe6,0x77,0xc0,0x14,0x44,0x45,0x06,0x8e,0x5f,0x13,
+	0xf9,0xdc,0xe3,0x42,0x1a,0x3d,0x22,0x5c,0x3e,0x90,0xba,0xbd,0x26,0x92,0xd2,0x63,0xfd,0xba,0x2f,0x44,
+	0xb4,0x39,0x51,0x40,0x1a,0xc1,0x21,0xd8,0x7c,0x9e,0x48,0x2c,0x20,0xbd,0x8e,0x35,0x29,0x7b,0x7a,0xe3,
+	0x59,0x1c,0x6d,0x13,0x0a,0x68,0xb4,0x2b,0x9a,0xb1,0x2d,0xe2,0xd8,0xb8,0x2c,0x2d,0x22,0x11,0xa5,0x09,
+	0xdd,0x44,0x77,0x3c,0x40,0x67,0x95,0x04,0x58,0x91,0xa4,0xf4,0xf8,0xc1,0x87,0x32,0x7c,0xa4,0x2f,0x07,
+	0xa1,0x53,0x08,0x96,0x0b,0xd9,0x1f,0xf3,0x8d,0xd0,0x30,0x20,0x2a,0x37,0xfa,0xc9,0x27,0xa9,0xe4,0x98,
+	0x7a,0x92,0x43,0xa2,0x2c,0xb0,0x57,0x00,0x03,0x50,0xa2,0xe5,0xdb,0xed,0x85,0x5c,0x42,0x7f,0x53,0xd7,
+	0xf8,0x3d,0xed,0x0f,0xf3,0xb6,0xd5,0x8e,0x87,0x61,0x0d,0x5c,0xd1,0x31,0x58,0xd0,0x8c,0xaf,0x85,0x3f,
+	0x2e,0xe1,0x51,0x1d,0x80,0x7e,0xab,0x1d,0x5e,0x62,0xe9,0xc8,0x10,0xfc,0x9b,0x22,0x00,0x89,0x13,0x5d,
+	0xba,0x5a,0x01,0xf9,0xd6,0x63,0x17,0x0e,0x40,0xad,0xb3,0x9c,0x91,0x39,0x40,0x2f,0x40,0xe3,0x40,0x03,
+	0x39,0x42,0x5a,0xae,0xcc,0x35,0x55,0xb2,0xaa,0xb5,0x57,0x84,0xb1,0x81,0xd4,0x1d,0x0e,0xb5,0x35,0xfb,
+	0xb3,0x08,0x59,0x90,0x1e,0x25,0x2f,0xa4,0x37,0xf9,0xb0,0xae,0xf0,0x5e,0x41,0x9a,0x54,0xd7,0x9c,0x11,
+	0xf5,0x6b,0x58,0x43,0x5d,0xd5,0x30,0x5a,0xec,0x86,0x62,0x2c,0x05,0x54,0x25,0x5e,0xf5,0x44,0x99,0xc3,
+	0x75,0x9f,0x19,0xb8,0xa7,0x18,0xa4,0x14,0x99,0x73,0x5b,0x88,0x70,0x85,0x29,0x03,0x76,0x6b,0x49,0xb1,
+	0xe6,0x66,0x76,0x77,0x55,0xa5,0x11,0x9a,0x2b,0x58,0x40,0x74,0x69,0x88,0x2a,0xde,0x4b,0x5a,0x05,0x68,
+	0x25,0x67,0x95,0x8e,0x6a,0xba,0x62,0x6e,0x65,0x29,0xc8,0x24,0xbf,0x33,0x0f,0x0b,0x37,0xcc,0x1e,0x02,
+	0x9b,0x3a,0x95,0x06,0x39,0x00,0x93,0xac,0xb2,0x3b,0xf8,0x3b,0x66,0x59,0x01,0x09,0xaa,0x6a,0x41,0x1f,
+	0xd4,0x42,0x98,0xd9,0xe3,0x6a,0x8f,0xc1,0xa6,0x55,0x89,0x4d,0xce,0x50,0xe3,0x65,0x3d,0x91,0x52,0xbf,
+	0x66,0x80,0x3a,0x6a,0x56,0x37,0x03,0xe4,0x6b,0x92,0x82,0xdb,0x99,0xbd,0xd6,0x29,0xbb,0x83,0x62,0x2b,
+	0x8e,0x82,0x26,0x74,0x14,0xc7,0xb4,0x25,0x96,0x42,0x05,0x19,0x65,0x10,0x6f,0xbf,0x10,0x21,0xab,0x19,
+	0xf8,0x9b,0xaf,0x13,0x11,0xd2,0x74,0x43,0xc5,0x29,0xe3,0x17,0x69,0x10,0x4c,0x81,0xfa,0x5a,0x96,0x42,
+	0xfa,0x98,0x6e,0x79,0xd6,0x9d,0x56,0x36,0x7c,0xb7,0x07,0x35,0x12,0x65,0x44,0x4f,0x24,0x38,0xbc,0xc6,
+	0xe7,0x28,0x91,0xc5,0x83,0x17,0xa7,0xfe,0xed,0x55,0x7b,0x25,0xaa,0x20,0x6b,0x9c,0xf4,0x5d,0xb5,0xce,
+	0x10,0xb9,0x2a,0x62,0x00,0x1b,0x3d,0x67,0x0a,0x41,0x93,0x34,0xd1,0xb9,0x61,0x17,0x05,0x41,0x8c,0x1d,
+	0xfe,0x3e,0x2f,0x70,0x45,0xb2,0xac,0x95,0x22,0xa0,0x84,0xce,0x01,0x2b,0x62,0xee,0x8b,0x7a,0x78,0x55,
+	0x51,0x36,0xc6,0x85,0x0a,0x3c,0x29,0x32,0x28,0x7a,0x21,0x90,0x6b,0x1f,0x8c,0x6d,0xda,0xa7,0x2a,0xb3,
+	0x8e,0x30,0x74,0x12,0x58,0x8e,0xc6,0xdb,0xa1,0xbb,0x2b,0x73,0x74,0x2a,0x2d,0xbb,0x1b,0x08,0x75,0x99,
+	0x5b,0x87,0xb6,0x14,0xd7,0x80,0x6c,0x0b,0xc3,0xaf,0x48,0x5b,0x8d,0x61,0x09,0x46,0x9a,0xd0,0xd6,0xd7,
+	0x68,0x12,0x0a,0x1b,0xe9,0xeb,0x50,0x16,0xff,0x0f,0x1d,0xb1,0x2f,0x4d,0xcf,0xe5,0xc1,0xb2,0xe6,0x6d,
+	0xc3,0xf5,0xd3,0xba,0x34,0xa8,0x3d,0xaa,0x4d,0x9b,0xa5,0x3f,0x87,0x5e,0x23,0xd7,0x5f,0x38,0x0b,0x56,
+	0x73,0xc3,0x19,0x28,0xc1,0x12,0xb2,0xd1,0xc7,0x84,0x5a,0x97,0xf4,0x8a,0x67,0xdf,0x32,0x97,0x7d,0x1d,
+	0x6a,0x72,0x57,0x92,0x7e,0x56,0xe0,0x65,0xb6,0x5f,0xf3,0x06,0x2c,0xd9,0x4a,0xa6,0x51,0x23,0xbc,0x0c,
+	0x7c,0xc7,0x9d,0xbb,0x83,0x49,0x2b,0x72,0x47,0x90,0x7e,0x4e,0xcf,0xb3,0x03,0xc7,0xab,0x59,0xa1,0x3a,
+	0x96,0x5b,0x69,0x10,0x0d,0x3f,0xe0,0xfb,0x9e,0xcc,0x5a,0x8f,0xe7,0xc4,0x59,0x4f,0x94,0x26,0x44,0x7e,
+	0x30,0x20,0x06,0x92,0x9f,0xa1,0x66,0x57,0x1c,0xa2,0xdc,0x9f,0xd3,0x7c,0xa7,0x30,0x0e,0x0e,0x8e,0x3b,
+	0x1a,0x33,0x8f,0xc7,0x8f,0x41,0x9d,0xee,0x98,0xa1,0xb6,0xa6,0x1c,0x8f,0x49,0x30,0x4f,0xe3,0x59,0xf9,
+	0xa8,0xc0,0xa7,0x23,0xaf,0x12,0xd4,0x4d,0x47,0x8f,0x23,0x28,0x6a,0x11,0xc2,0xe9,0x51,0x3c,0x0e,0x3f,
+	0xb4,0x6d,0x00,0x1d,0xd4,0x0d,0xf3,0xc8,0xd3,0x78,0xd7,0x5f,0xda,0x7a,0x93,0xfa,0xfb,0xa2,0xbb,0x40,
+	0x45,0x53,0x67,0xed,0x4e,0x78,0xaf,0x16,0xde,0x72,0x83,0xb0,0x5b,0x3a,0x4d,0x9d,0xb0,0xbb,0xa5,0x86,
+	0x3c,0xa5,0xb6,0xca,0x0c,0x0b,0x0a,0x2c,0xcb,0x82,0x64,0x64,0xbb,0xd0,0x82,0x1e,0x8d,0x12,0x65,0xb6,
+	0xed,0x6a,0xd1,0x4a,0xc1,0x23,0xde,0xab,0xc5,0x6c,0xe2,0x14,0xb2,0x4a,0xa2,0x70,0xb9,0xae,0xd1,0x73,
+	0x1e,0x03,0xf5,0x80,0xfa,0xe2,0x01,0x03,0x2c,0x07,0x3f,0x4d,0x1a,0xef,0x8e,0xfc,0x85,0x74,0x34,0x42,
+	0x49,0x55,0x56,0x83,0xec,0xe4,0x5f,0x38,0x0a,0xe6,0xdf,0x10,0x3b,0xbb,0x9b,0xb6,0x3d,0x6c,0x19,0x0b,
+	0xbb,0xe5,0x62,0x52,0x3e,0xea,0xe7,0xa8,0xe3,0xb1,0xd1,0x92,0x79,0xe0,0x4c,0x28,0xce,0x31,0x47,0xca,
+	0x73,0x03,0x26,0x55,0x75,0x40,0xb8,0x1a,0x64,0x19,0x5d,0x22,0x36,0x56,0xf2,0xcc,0xfd,0xe2,0x91,0xbd,
+	0x86,0xf3,0xc9,0x2c,0x4a,0xf9,0x01,0x52,0x59,0x51,0xa5,0x4f,0x54,0x31,0x4a,0xb2,0xbd,0xa0,0x18,0x71,
+	0x59,0xc7,0xd4,0x68,0xb2,0xd2,0x72,0xad,0xa3,0x19,0x50,0x3a,0x07,0x27,0x28,0x57,0xb8,0xf0,0xc3,0xfe,
+	0x06,0xe8,0x0b,0xee,0x59,0x77,0xa6,0xef,0x55,0x7e,0x1f,0xe9,0x6c,0xfb,0xb8,0xef,0xce,0x7a,0x72,0x59,
+	0x0a,0xc2,0x7e,0x2e,0x9f,0xcd,0x81,0x26,0x78,0xeb,0xc3,0x93,0x40,0xb3,0x52,0x64,0xcc,0x58,0x51,0x1c,
+	0x21,0xe4,0xe5,0x82,0x33,0x55,0xfa,0xea,0xe2,0x49,0x96,0x6b,0xe9,0x76,0x0b,0xf5,0x5a,0x35,0x44,0x5e,
+	0x98,0xf4,0x4b,0x16,0x85,0x49,0xbf,0xc6,0x50,0xe3,0x28,0x50,0x62,0xd8,0xec,0x54,0x0f,0x65,0xdd,0xf0,
+	0x58,0xfd,0xfa,0x03,0xd5,0x0d,0x2a,0x2a,0xe7,0xa4,0xc5,0x5e,0xdd,0x12,0xb6,0x32,0x29,0x73,0x16,0xb6,
+	0xdd,0xcf,0x6b,0x16,0x5f,0x06,0xc1,0x20,0xaf,0x31,0xc7,0xdf,0x78,0x5e,0x79,0x98,0x46,0x71,0x83,0x14,
+	0xe9,0xae,0x2c,0xd7,0xf2,0xfb,0xa9,0x79,0x15,0x2c,0x03,0x36,0x4c,0xcd,0x16,0xe3,0x9e,0x5b,0x41,0xf6,
+	0x7b,0x96,0x07,0xca,0x3a,0x3e,0xcb,0x83,0xd1,0x18,0x0c,0xa2,0x1c,0x82,0x43,0x3a,0x02,0xe4,0xec,0x77,
+	0xc9,0xc0,0xd5,0xcf,0x81,0xce,0xfe,0x61,0x6a,0xe9,0x7e,0x17,0x7a,0xbe,0xe8,0xdc,0x20,0xd5,0xdb,0x1c,
+	0x15,0x87,0x22,0x98,0x05,0x65,0xc8,0x68,0x4b,0xc3,0xa7,0x8b,0x75,0x67,0xfa,0xd8,0xa9,0x41,0xab,0x72,
+	0x3d,0x7b,0x75,0xf5,0x39,0xd8,0x1a,0xbd,0x48,0x53,0x36,0xbf,0xe1,0xc9,0x1e,0x5c,0x95,0x4b,0xb3,0x27,
+	0xec,0xf0,0x7d,0x3b,0xbf,0x7b,0x44,0x33,0xaf,0xba,0x17,0xad,0x71,0x54,0x40,0x98,0xe1,0x15,0x7b,0x1b,
+	0x5e,0x40,0x38,0xdd,0x44,0x71,0x8c,0xfb,0x18,0xdb,0x88,0x1b,0x5a,0x3d,0x75,0xa7,0x86,0x4a,0x00,0x80,
+	0xfe,0xed,0xb3,0xb2,0x6e,0xbf,0x24,0xd7,0x64,0xdc,0xda,0xb9,0xd5,0x04,0xca,0x2b,0xb3,0x61,0x11,0x84,
+	0x5e,0x91,0xd7,0x2c,0x14,0x76,0x9e,0x2f,0x57,0x57,0x1a,0xa4,0x1d,0xec,0xbd,0x03,0x89,0x79,0xa5,0xc7,
+	0x03,0xb9,0x9e,0x0c,0x0c,0x52,0x90,0x7a,0x69,0x06,0xf3,0x11,0x57,0x74,0x77,0xae,0x35,0xb7,0x52,0x51,
+	0x31,0x56,0x9a,0x62,0x74,0x4f,0xb5,0x91,0xf5,0xc4,0x78,0x6f,0xab,0x5f,0x66,0x89,0x57,0x3e,0x9c,0xd2,
+	0x02,0xd8,0x69,0x46,0xf9,0x5e,0xc4,0xf8,0x5a,0x10,0x05,0x77,0xa0,0x74,0x75,0x84,0x0e,0x48,0x9a,0xc8,
+	0x97,0x09,0x9e,0x3c,0x58,0xca,0x5b,0x5e,0xa3,0x08,0xd3,0x63,0x45,0xcf,0x58,0x02,0xb9,0x4e,0xa2,0x5e,
+	0x25,0x50,0x79,0xff,0x0d,0xe9,0x53,0x9a,0x4a,0x43,0x6d,0xac,0x27,0x4e,0xca,0xcd,0xe8,0x66,0xcf,0xb5,
+	0x22,0xb1,0xcb,0x52,0xaa,0xa7,0x09,0x70,0xcd,0x0d,0xe0,0x78,0x48,0xc9,0x2b,0x98,0xe6,0x48,0x37,0x56,
+	0xc6,0x99,0xae,0xed,0x2f,0xfa,0x87,0x60,0xdc,0x2f,0x7a,0x78,0xf2,0x37,0xdc,0xee,0x20,0xd4,0x68,0xd8,
+	0xf4,0x17,0xd4,0xf2,0xc3,0xc3,0x33,0xaa,0x48,0x9d,0xa8,0xd6,0xbb,0x95,0xfa,0x22,0xf5,0xfc,0x5f,0xb6,
+	0xfb,0xee,0xc3,0xf9,0xc8,0x1d,0x8e,0xcc,0x42,0x65,0x56,0x94,0x6d,0xcc,0xd0,0x50,0xdb,0x15,0x23,0x13,
+	0x24,0xa9,0xb8,0x68,0x14,0x9e,0xb6,0x26,0xac,0x47,0x03,0x1a,0xa6,0x82,0x09,0x7e,0x61,0xad,0xcc,0x80,
+	0x6f,0x07,0x9e,0xae,0xf0,0x6d,0xc4,0x21,0xea,0xc6,0xaa,0xbc,0xe6,0x91,0xd3,0x61,0x28,0x4e,0x3b,0x6e,
+	0xaf,0x41,0x09,0x62,0xfc,0xef,0x69,0x26,0x4f,0x19,0x3b,0x88,0x1f,0xe2,0x9d,0x5a,0x81,0x5e,0xbd,0x1d,
+	0x0c,0x79,0x9c,0x95,0xb1,0xad,0xb2,0x53,0x56,0x0e,0x19,0xab,0xde,0xee,0x69,0x94,0x04,0x12,0xd4,0xcc,
+	0xa5,0xd9,0xbd,0x25,0xb3,0x97,0x0b,0x79,0x49,0xd6,0x7b,0x55,0xd2,0xcf,0x0b,0x3f,0x9a,0xaf,0x9a,0x8b,
+	0xa7,0xef,0xbe,0x42,0x2c,0xeb,0x1e,0xb5,0x34,0xfd,0x76,0xfa,0x8e,0x9b,0x0e,0xdd,0x42,0x56,0x9b,0xb7,
+	0x1b,0xf6,0xec,0x7c,0xa6,0x5d,0x52,0xf9,0x6d,0x56,0x9b,0xbb,0x52,0x57,0x1b,0x13,0x95,0x87,0xe5,0xcb,
+	0x4f,0x83,0x7c,0x60,0x7e,0x88,0x2f,0x36,0x99,0x7c,0x07,0x3a,0xfa,0x0a,0x14,0x48,0x27,0x70,0x7d,0x1c,
+	0x03,0x7e,0xb5,0x40,0x4d,0x5e,0x96,0x45,0x8f,0x1d,0x20,0x2b,0xb8,0x90,0x16,0xa8,0xef,0xc1,0xe4,0x53,
+	0xff,0x6a,0x8b,0xe2,0x2d,0xec,0x48,0x29,0x00,0x7b,0x1e,0x6b,0xba,0xf7,0xf8,0x84,0xaf,0x45,0x8f,0xdc,
+	0xbb,0x8d,0x04,0x45,0x9d,0x31,0x70,0x69,0xce,0x33,0xce,0x44,0xf5,0x22,0xe0,0x92,0x94,0xb7,0xb3,0x32,
+	0xcc,0x9e,0x62,0x91,0x17,0x4d,0x91,0xc2,0xfe,0x48,0x9c,0xd4,0x2b,0xdd,0xc8,0xc7,0xf0,0xdd,0xe7,0xf1,
+	0xc5,0x79,0xc0,0x04,0x5b,0x43,0x0e,0xd8,0xf2,0xcb,0xe2,0xb0,0x7d,0x73,0xb7,0x8b,0x67,0xaf,0x9c,0xf7,
+	0xd0,0x24,0xd0,0x4c,0x8a,0xeb,0x49,0x28,0x44,0xb6,0xbe,0xbc,0x3c,0x1e,0x8f,0xc6,0xd1,0x31,0xd2,0x7c,
+	0x7b,0x69,0x9b,0xa6,0x89,0xcc,0x13,0x72,0x88,0xf8,0xf1,0x5d,0x7a,0x77,0x3d,0x91,0xef,0x0f,0x17,0xf0,
+	0x3b,0x21,0x98,0xef,0xaf,0x27,0xb8,0xdd,0x26,0x78,0x40,0x48,0x6f,0xf9,0xf5,0xe4,0x95,0xed,0xc0,0x98,
+	0xea,0x59,0x6d,0x8c,0xeb,0x89,0x65,0xb8,0x35,0x09,0xcd,0xea,0xb3,0xec,0x7a,0x22,0x0d,0xd3,0x21,0x7f,
+	0x05,0x24,0xac,0xe8,0xaf,0x9c,0x0f,0xa0,0x5d,0xc6,0x44,0x48,0x82,0xeb,0xc9,0x8d,0x45,0x56,0xa1,0x13,
+	0xdb,0xd4,0x25,0x73,0xd8,0x78,0x04,0x1a,0xa1,0x33,0xb9,0x54,0x4c,0xa8,0x21,0xb4,0xce,0xa7,0xb5,0x0d,
+	0xf8,0x89,0xff,0x5c,0xcb,0x77,0x34,0xeb,0x29,0x6c,0xc3,0x85,0xf5,0x2c,0xf1,0x43,0xe4,0x87,0x02,0x05,
+	0xbe,0xb1,0x05,0x54,0xfc,0xdc,0x57,0x6b,0xf4,0xa3,0xdc,0x8f,0x39,0xf1,0x41,0x85,0xd5,0x84,0xf8,0x27,
+	0xf9,0x27,0xbf,0x9e,0xc0,0x88,0x47,0xcd,0x40,0x8b,0x98,0x15,0xe1,0xff,0x9f,0x31,0x6a,0xd9,0x36,0xb1,
+	0x63,0xcb,0x26,0x96,0x3d,0x16,0x80,0xa3,0xd6,0x03,0x98,0x28,0x51,0xf2,0x67,0x32,0xdd,0xf7,0xee,0x17,
+	0x30,0x9e,0x63,0xb8,0xe1,0x3c,0xc6,0x16,0x7c,0xc2,0xa5,0xe1,0x1e,0x56,0x21,0xb5,0x9c,0xfb,0xf1,0x25,
+	0x6f,0x39,0xcb,0x7f,0xce,0x58,0x19,0x77,0xb9,0x3d,0x70,0xf9,0x8a,0x58,0x07,0xa0,0xe3,0x5f,0xdb,0x58,
+	0x7d,0xb1,0x5c,0x89,0x1e,0x48,0xc1,0x67,0xb2,0xfa,0x08,0x14,0x87,0x38,0x60,0x99,0x05,0x5e,0xeb,0xdc,
+	0x58,0x96,0x01,0xa0,0x22,0xbf,0x1c,0xf8,0xbd,0xc1,0x2f,0xec,0xa4,0x75,0xe7,0x1c,0x39,0x61,0xc8,0x13,
+	0x31,0x34,0xa6,0xe4,0xdc,0x58,0x8d,0xdb,0x3c,0x4a,0x36,0x29,0x2d,0xfe,0xd8,0xe3,0xff,0xef,0xfc,0x94,
+	0xa6,0xc7,0xf3,0x38,0xb9,0x2b,0x41,0xfc,0x54,0xfe,0xad,0xb8,0xc0,0x24,0x2a,0x1b,0xaa,0x76,0x0e,0x7c,
+	0x3a,0x87,0x2c,0x0f,0xf3,0x56,0x0a,0xa8,0xa7,0x58,0x3c,0xdb,0xa0,0x73,0x1c,0x03,0x26,0x35,0xea,0xc5,
+	0x94,0xea,0x8f,0xda,0xf7,0x8f,0x3d,0x2f,0xe4,0xdb,0xfd,0x52,0xd8,0xff,0x54,0x78,0x2f,0x34,0x88,0xb6,
+	0x20,0x0b,0xc3,0x66,0x80,0x6b,0x38,0x25,0xfc,0xd8,0x32,0x8c,0xdf,0xfa,0xd4,0x98,0x1b,0x36,0x35,0x60,
+	0x08,0x7e,0xbd,0x3d,0x18,0xcb,0x67,0x5b,0xd7,0xb2,0x9e,0x6d,0x5e,0xa8,0xa2,0xf2,0x5d,0xba,0xe3,0x78,
+	0xeb,0x58,0xec,0x93,0x9f,0x19,0x2e,0x5b,0x16,0xe8,0xa3,0x25,0x54,0x14,0x86,0xcb,0x4a,0xa8,0x54,0xff,
+	0x23,0x45,0x1c,0x62,0x1e,0x96,0x0c,0xad,0x8b,0x1f,0x69,0x6b,0x0a,0xb4,0xfb,0x81,0x43,0x2c,0x1c,0xb3,
+	0x38,0xb8,0x1a,0xbb,0xca,0xa8,0x47,0xcb,0x2a,0xb3,0x5a,0x0d,0x10,0xd4,0xa3,0xe7,0x6a,0xd2,0x83,0x25,
+	0x5b,0x6f,0x65,0xcb,0x22,0x8b,0xd0,0xba,0x59,0xca,0x6f,0x1b,0x71,0x3c,0x36,0x96,0xc6,0xf2,0x66,0x61,
+	0x38,0x64,0x69,0xac,0xd4,0x83,0x4d,0x56,0x92,0x4e,0xcb,0x0e,0x70,0xbe,0x7a,0x7a,0xc4,0x57,0x39,0xd4,
+	0x02,0x8e,0xba,0xa7,0xf9,0x6f,0xfb,0x69,0x10,0xb4,0x56,0x38,0x3f,0x60,0x1e,0x9a,0x7f,0x99,0x7f,0xb4,
+	0xbf,0xd8,0xd8,0xba,0x07,0xa8,0x75,0x43,0xcb,0x8c,0x29,0xc0,0xf2,0x5b,0x08,0x6a,0x0c,0x67,0x29,0x82,
+	0x5a,0x70,0x72,0xfa,0x08,0xb8,0xd9,0x26,0x01,0xd7,0x78,0xee,0xfa,0xa7,0xfc,0x5f,0xcc,0xd7,0xd7,0xe7,
+	0xb0,0xce,0xf3,0x7f,0xcb,0xe5,0xb5,0x8a,0x6b,0x2a,0x57,0x56,0x5d,0x98,0xe0,0xb2,0xa7,0x65,0x4d,0xad,
+	0xed,0xf9,0x76,0xf6,0x1f,0x9e,0x60,0xfc,0x26,0x47,0x2a,0x00,0x00,
+};
+
+// portal.js (2771 bytes before gzip)
+static const uint8_t WEB_ASSET_2[] PROGMEM = {
+	0x1f,0x8b,0x08,0x00,0x00,0x00,0x00,0x00,0x02,0x03,0xb5,0x56,0xdb,0x6e,0xdc,0x36,0x10,0x7d,0xde,0xfd,
+	0x8a,0xb1,0x1f,0x42,0x09,0x5d,0xc9,0x0f,0x05,0x8a,0xa0,0xc1,0xa2,0x70,0x52,0x03,0x05,0x92,0xb4,0x4e,
+	0x1c,0xa0,0x09,0x82,0x3c,0x70,0xa5,0xd9,0x15,0x5b,0xae,0xa8,0x92,0x94,0xd7,0x8b,0xc4,0xff,0x9e,0xe1,
+	0x45,0x57,0x6f,0x8c,0x14,0x68,0x1f,0x6c,0x8b,0xe4,0x99,0x99,0x33,0x17,0x1e,0xfa,0xe2,0x02,0xae,0xf9,
+	0x0e,0x61,0x83,0x15,0xbf,0x15,0xaa,0xd5,0xb0,0x55,0x1a,0x6c,0x85,0xf0,0xf6,0xdd,0x4b,0xb8,0x41,0x7d,
+	0x8b,0x1a,0x1a,0xa5,0x2d,0x97,0x90,0xdc,0x58,0x5e,0x97,0x06,0x44,0xed,0x41,0xcf,0x95,0xb2,0xc6,0x6a,
+	0xde,0x30,0x03,0xa6,0xd0,0xa2,0xb1,0x40,0xc7,0xf0,0xd7,0x9b,0x16,0xf5,0x31,0x5d,0x5e,0x5c,0x40,0x9e,
+	0xc3,0x6f,0x28,0x1b,0xd8,0xb4,0xd6,0xaa,0xda,0x40,0x52,0x72,0xcb,0xb3,0x8d,0xc9,0xac,0xda,0xed,0x24,
+	0xae,0x59,0xa3,0x1a,0x45,0x01,0x58,0x0a,0xa6,0x52,0x07,0x17,0x56,0x50,0x70,0x61,0x25,0x7a,0x57,0x1d,
+	0xbc,0x50,0xb5,0xc5,0xda,0x46,0x97,0x97,0x45,0xa1,0x74,0x29,0x54,0xfd,0x6d,0xbf,0x85,0x92,0x92,0x37,
+	0x06,0xc9,0xb1,0x6a,0xb0,0xf6,0xce,0x0a,0xa9,0x0c,0xf6,0x2e,0x2d,0xd7,0x3b,0xec,0x3c,0x5e,0x1d,0x71,
+	0xf0,0x95,0x07,0x27,0x59,0xc3,0x8d,0x39,0x50,0xa0,0xc8,0x8d,0x12,0xae,0x44,0x89,0xbe,0x34,0xdd,0x11,
+	0x55,0xcd,0xc4,0xbd,0xfd,0xb2,0x54,0x45,0xbb,0x27,0x96,0x39,0x2f,0xcb,0xab,0x5b,0xfa,0x78,0x25,0x0c,
+	0xb1,0x46,0x9d,0xb0,0x5f,0xff,0x78,0xfd,0x22,0xa4,0xf0,0x4a,0xf1,0x12,0x4b,0xb6,0x82,0x6d,0x5b,0x17,
+	0xd6,0xe5,0x90,0xa4,0xf0,0x79,0xb9,0x90,0x68,0x03,0xd3,0x35,0xd4,0xad,0x94,0xcf,0x96,0xcb,0x45,0x8f,
+	0xf0,0xc4,0xaf,0x43,0xa5,0x02,0x7a,0x21,0xb6,0x90,0x38,0x78,0x48,0x2f,0xd7,0xb8,0xa7,0xc3,0x24,0x7d,
+	0x46,0x47,0x13,0x2f,0x8b,0x7b,0x72,0xd4,0x13,0xfb,0xc7,0x35,0xe6,0x06,0x25,0x16,0x56,0xe9,0x4b,0x29,
+	0x13,0xf6,0x71,0x56,0xb8,0xf3,0xd8,0x90,0xf3,0x4f,0x2c,0xcd,0xa9,0xc7,0x57,0xbc,0xa8,0x92,0x81,0x6a,
+	0xa8,0x51,0xa0,0x10,0xbe,0x4f,0x24,0x5b,0x48,0x51,0xfc,0x3d,0xc9,0x10,0x83,0xc5,0x02,0x73,0x63,0x55,
+	0x73,0xad,0x55,0xc3,0x77,0xdc,0x1d,0x05,0xc6,0x0b,0x6a,0xaf,0xb1,0x60,0xf8,0x1e,0x89,0xb8,0xe7,0xff,
+	0xe4,0x49,0x48,0x4c,0x1d,0xc8,0x25,0xac,0xd7,0xeb,0xd8,0x9e,0x00,0x9f,0xd4,0xc3,0x6f,0xb9,0x7a,0x38,
+	0xfb,0x14,0x34,0xda,0x56,0x07,0x5c,0xac,0x44,0x9f,0x7e,0xa1,0x91,0x5b,0xbc,0x92,0xe8,0x56,0x09,0x2b,
+	0xc5,0x2d,0x4b,0x7b,0x60,0x17,0x6a,0x1c,0xc8,0xef,0x17,0x92,0x9a,0xfd,0x7b,0xe0,0xd6,0xcf,0xeb,0x88,
+	0x76,0x85,0xd4,0x51,0xfd,0x48,0x9c,0xea,0xc7,0x18,0x26,0x20,0x4f,0x3a,0xcc,0xc2,0x19,0x1b,0xe3,0x2c,
+	0xde,0xd9,0x38,0x35,0x3d,0xad,0xdc,0xf5,0xcb,0xa0,0xcd,0xfd,0x1d,0x19,0xb1,0xd8,0xa8,0xf2,0xf8,0x5d,
+	0xb9,0x3a,0xe0,0x69,0x0a,0xee,0x84,0x0d,0x98,0x93,0xe1,0xe9,0xca,0x5c,0x5a,0xab,0x05,0x2d,0x91,0xbc,
+	0x4e,0xaf,0x27,0x5d,0xb6,0x2f,0x5f,0x80,0xb1,0xa1,0x76,0xbc,0xa1,0xdf,0x65,0x12,0x12,0x5a,0x79,0x92,
+	0x81,0x45,0xcf,0xd3,0x87,0x8a,0x30,0x3f,0xd0,0xa3,0x9c,0xf4,0x24,0xee,0x73,0xd5,0xd6,0xa5,0xa8,0x77,
+	0x2f,0xa4,0x20,0xc3,0xb7,0x34,0xc3,0x93,0xe9,0x91,0xb8,0x75,0x3c,0x5f,0x73,0x5b,0xe5,0x7b,0x51,0x27,
+	0x3a,0xf7,0x3b,0x3f,0xc0,0x41,0xd4,0xa5,0x3a,0xe4,0x24,0x50,0xa4,0x09,0xef,0x57,0xb3,0x35,0x01,0x7a,
+	0x2e,0xdd,0x47,0xac,0x1a,0x55,0xc9,0x45,0xfa,0x53,0x94,0xb6,0x82,0x2c,0xce,0xe3,0x76,0x4b,0xd5,0xef,
+	0xb6,0x9e,0x8e,0xc6,0xc7,0xd8,0xa3,0xc4,0x7c,0xc2,0x82,0xdf,0x25,0x4f,0x57,0x9e,0x58,0x4a,0x61,0x58,
+	0x73,0xc7,0xe6,0x70,0xba,0x0d,0x84,0x26,0xae,0x1b,0x45,0x69,0xee,0xe7,0x6c,0x3f,0xd0,0xc6,0x4f,0x63,
+	0xdb,0x7b,0x1f,0x90,0x34,0xeb,0x25,0x62,0xe3,0x95,0x28,0x68,0x65,0x27,0xd9,0xb1,0x95,0x60,0x94,0x5f,
+	0x6e,0xb4,0x3a,0x18,0x5a,0x96,0x0a,0x0d,0xd4,0xca,0x06,0x21,0x13,0x24,0xd3,0x06,0x38,0x58,0xa5,0xa4,
+	0x15,0x8d,0xfb,0x3b,0x5c,0xe7,0xc9,0x7c,0x0d,0xf5,0xef,0xc7,0x2d,0xae,0xcd,0x64,0x0e,0xb8,0x16,0x3c,
+	0x93,0x7c,0x83,0x92,0xae,0xfd,0xd8,0x22,0x1d,0x99,0x04,0x8d,0x1a,0x59,0x79,0x84,0x9f,0x4a,0x9f,0xd6,
+	0x23,0xf2,0xf9,0x4d,0x45,0xe9,0x64,0xd0,0xe9,0xc5,0x59,0xb8,0xad,0x34,0x8a,0x5c,0xd4,0x26,0xa1,0xe2,
+	0x7a,0x85,0x4f,0x53,0x78,0xa0,0x17,0x2e,0xde,0xbf,0x93,0xc5,0xee,0x3d,0xf9,0x6f,0x75,0x31,0xca,0x62,
+	0x18,0xe0,0x86,0xd7,0x28,0xc7,0x57,0x78,0x42,0x2b,0x79,0xf4,0x02,0x86,0x54,0x59,0x3a,0x88,0xe1,0x99,
+	0x77,0x37,0x91,0xc3,0xa8,0xb2,0x6e,0x04,0xd6,0x10,0xce,0x83,0x10,0x38,0x8a,0x43,0xe1,0x98,0x43,0x44,
+	0xb1,0x98,0x83,0x42,0x39,0x22,0x64,0xe5,0x7d,0x45,0x55,0x09,0xec,0x1e,0x22,0xbb,0xc2,0xb9,0x27,0xef,
+	0xec,0x01,0xfe,0xc4,0x18,0xe1,0x1d,0x05,0x0d,0x4f,0x64,0x0f,0xbf,0xff,0xae,0xa6,0xcd,0xdf,0xed,0xff,
+	0xad,0x53,0x07,0xed,0x04,0x6b,0xa4,0x4e,0x7e,0xc0,0x0c,0xc9,0x6c,0xde,0xc5,0xce,0x22,0x86,0x8d,0x25,
+	0x4a,0xd4,0x4d,0xeb,0xd4,0xa1,0xb3,0xa7,0xa1,0x8d,0x9f,0xb3,0x5e,0x33,0x8f,0xfc,0x68,0x8f,0x8d,0x7b,
+	0x91,0xa3,0xcb,0xf3,0x4f,0x2b,0x18,0xef,0x3b,0x7d,0x76,0xe3,0x38,0xb4,0xdc,0x9f,0x9e,0x68,0x39,0xfd,
+	0xdb,0x52,0xfa,0x97,0xd0,0x03,0x72,0x67,0xee,0x9f,0x54,0xd6,0x57,0x2a,0xf8,0x18,0x9d,0x76,0x36,0xbf,
+	0x00,0x73,0x71,0x18,0xfc,0x3c,0x47,0xc7,0x94,0xe8,0xcf,0x50,0x87,0x79,0x16,0x23,0x72,0x0e,0x18,0x8b,
+	0xb8,0x70,0xdf,0x27,0x46,0x65,0x23,0x32,0x3c,0x62,0xb4,0x79,0x1c,0x94,0x19,0x3a,0xa8,0x22,0xf4,0x7e,
+	0x3c,0x21,0xee,0xe7,0x2b,0x85,0x9d,0x08,0xf8,0xd3,0x0a,0x00,0x00,
+};
+
+static const WebAsset WEB_ASSETS[] = {
+	{"chart.js", "application/javascript", "04ad4292", WEB_ASSET_0, sizeof(WEB_ASSET_0), true},
+	{"portal.css", "text/css", "a42b78f0", WEB_ASSET_1, sizeof(WEB_ASSET_1), true},
+	{"portal.js", "application/javascript", "221d4bcd", WEB_ASSET_2, sizeof(WEB_ASSET_2), true},
+};
@@ -0,0 +1,214 @@
+#pragma once
+
+#include "Web\WebPageWrapper.h"
+#include "HandyLog.h"
+#include "LogHistory.h"
+#include "WebRoutes.h"
+
+// Bytes of escaped log text gathered before each write
+#define LOG_PAGE_BUFFER 1024
+
+// Longest grep text used
+#define LOG_GREP_MAX 64
+
+// Longest line escaped (Every character may become &quot;)
+static_assert(LOG_LINE_MAX * 6 + 1 <= LOG_PAGE_BUFFER, "LOG_PAGE_BUFFER too small for one line");
+
+///////////////////////////////////////////////////////////////////////////////
+// Log page streamed straight from a LogHistory
+// .. Lines are escaped into a fixed buffer as they are visited, then the
+// .. buffer is written between visits. Nothing else is copied.
+// .. Query parameters
+//		since	Sequence number of the first line to show (Default oldest)
+//		count	Most lines to show (Default all)
+//		grep	Only lines containing this text (Any case)
+//		level	E for errors, W for warnings and errors (Codes like E500 - or W600 -)
+class WebPageLog : public WebPageWrapper
+{
+private:
+	char _buffer[LOG_PAGE_BUFFER];
+	size_t _length = 0;
+
+public:
+	WebPageLog(WiFiClient &c) : WebPageWrapper(c)
+	{
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief Show the log with the filters from the query
+	void ShowHtml(const char *title, const LogHistory &log)
+	{
+		WebServer &server = *_wifiManager.server;
+		uint32_t first = 0;
+		uint32_t next = 0;
+		log.GetRange(first, next);
+		uint32_t since = server.hasArg("since") ? (uint32_t)server.arg("since").toInt() : first;
+		int count = server.hasArg("count") ? server.arg("count").toInt() : MAX_LOG_LENGTH;
+		count = max(1, min(count, MAX_LOG_LENGTH));
+		String grep = server.arg("grep").substring(0, LOG_GREP_MAX);
+		char level = server.arg("level").length() > 0 ? toupper(server.arg("level")[0]) : 0;
+
+		AddPageHeader(server.uri().c_str());
+		_client.print("<h3>");
+		_client.print(title);
+		_client.println("</h3>");
+		AddFilterForm(grep.c_str(), level, count, first, next);
+
+		// Matching lines in batches that fit the buffer
+		_client.print("<pre>");
+		int shown = 0;
+		uint32_t seq = since;
+		bool full;
+		do
+		{
+			full = false;
+			seq = log.Visit(seq, [&](uint32_t, const char *line)
+							{
+								if (shown >= count)
+									return false;
+								if (!Matches(line, grep.c_str(), level))
+									return true;
+								if (_length + EscapedLength(line) + 1 > sizeof(_buffer))
+								{
+									full = true;
+									return false;
+								}
+								AppendEscaped(line);
+								_buffer[_length++] = '\n';
+								shown++;
+								return true; });
+			Flush();
+		} while (full);
+		_client.println("</pre>");
+
+		// Move on through the log (Sends the filter form)
+		if (shown >= count && seq < next)
+			_client.printf("<button class='btn btn-secondary' form='logFilter' name='since' value='%u'>Next</button>", seq);
+		AddPageFooter();
+	}
+
+private:
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief Filter boxes. The paging buttons send since
+	void AddFilterForm(const char *grep, char level, int count, uint32_t first, uint32_t next)
+	{
+		_client.print("<form id='logFilter' method='get' class='d-flex flex-wrap gap-2 mb-2'>"
+					  "<input class='form-control w-auto' name='grep' placeholder='Contains' value='");
+		_length = 0;
+		AppendEscaped(grep);
+		Flush();
+		_client.printf("'>"
+					   "<select class='form-select w-auto' name='level'>"
+					   "<option value=''>All</option>"
+					   "<option value='W'%s>Warnings</option>"
+					   "<option value='E'%s>Errors</option></select>"
+					   "<input class='form-control w-auto' type='number' name='count' value='%d' min='1' max='%d'>",
+					   level == 'W' ? " selected" : "", level == 'E' ? " selected" : "", count, MAX_LOG_LENGTH);
+		_client.printf("<button class='btn btn-primary' name='since' value='%u'>Oldest</button>"
+					   "<button class='btn btn-primary' name='since' value='%u'>Latest</button>"
+					   "</form>",
+					   first, next - min(next - first, (uint32_t)count));
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief Does the line pass the filters
+	static bool Matches(const char *line, const char *grep, char level)
+	{
+		if (level == 'E' || level == 'W')
+		{
+			char found = LineLevel(line);
+			if (found != 'E' && !(level == 'W' && found == 'W'))
+				return false;
+		}
+		return *grep == 0 || ContainsNoCase(line, grep);
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief Find the level from a code like "E500 - " or "W600 - "
+	/// @return 'E', 'W' or 0 when the line has no code
+	static char LineLevel(const char *line)
+	{
+		for (const char *p = line; *p; p++)
+			if ((*p == 'E' || *p == 'W') && isdigit(p[1]) && isdigit(p[2]) && isdigit(p[3]) &&
+				p[4] == ' ' && p[5] == '-')
+				return *p;
+		return 0;
+	}
+
+	static bool ContainsNoCase(const char *text, const char *find)
+	{
+		for (; *text; text++)
+		{
+			const char *t = text;
+			const char *f = find;
+			while (*f && tolower(*t) == tolower(*f))
+				t++, f++;
+			if (*f == 0)
+				return true;
+		}
+		return false;
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief Size of the text once escaped for HTML
+	static size_t EscapedLength(const char *text)
+	{
+		size_t length = 0;
+		for (; *text; text++)
+		{
+			const char *escaped = Escape(*text);
+			length += escaped ? strlen(escaped) : 1;
+		}
+		return length;
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief HTML for a character. nullptr if it needs no escaping
+	static const char *Escape(char c)
+	{
+		switch (c)
+		{
+		case '<':
+			return "&lt;";
+		case '>':
+			return "&gt;";
+		case '&':
+			return "&amp;";
+		case '\'':
+			return "&#39;";
+		case '"':
+			return "&quot;";
+		case '\n':
+			return "\n\t";
+		default:
+			return nullptr;
+		}
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief Escape into the buffer. The caller makes sure it fits
+	void AppendEscaped(const char *text)
+	{
+		for (; *text; text++)
+		{
+			const char *escaped = Escape(*text);
+			if (escaped == nullptr)
+			{
+				_buffer[_length++] = *text;
+				continue;
+			}
+			size_t length = strlen(escaped);
+			memcpy(_buffer + _length, escaped, length);
+			_length += length;
+		}
+	}
+
+	void Flush()
+	{
+		if (_length == 0)
+			return;
+		_client.write((const uint8_t *)_buffer, _length);
+		_webRoutes.AddBytes(_length);
+		_length = 0;
+	}
+};
@@ -6,6 +6,8 @@
 #include "HandyString.h"
 #include "GpsParser.h"
 #include "MyFiles.h"
+#include "LogLevel.h"
+#include "WebRoutes.h"
 
 extern NTRIPServer _ntripServer0;
 extern NTRIPServer _ntripServer1;
@@ -52,6 +54,12 @@ public:
 		// Add Timezone offset
 		AddTimezoneOffset();
 
+		// Log level of each module
+		AddLogLevelsForm();
+
+		// Time and size allowed for each kind of web reply
+		AddWebBudgetsForm();
+
 		// Reset section
 		_client.println(R"rawliteral(
 <div class="accordion accordion-flush card" id="acd2">
@@ -120,7 +128,7 @@ public:
 		if (_wifiManager.server->hasArg(BASE_LCN))
 		{
 			SaveBaseLocation(_wifiManager.server->arg(BASE_LCN).c_str());
-			_gpsParser.GetCommandQueue().IssueFReset();
+			_gpsParser.RequestFReset();
 			_client.println("<div class='alert alert-success' role='alert'>Base station location updated successfully!</div>");
 		}
 
@@ -291,6 +299,81 @@ public:
 					   TZ_ID, TZ_ID, TZ_ID, TZ_ID, _myFiles.LoadString(TIMEZONE_MINUTES).c_str());
 	}
 
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief Log level of each module. Applied straight away and saved
+	void AddLogLevelsForm()
+	{
+		_client.printf("<h3 class='mt-4'>Log levels %s</h3>",
+					   MakeHelpButton("Help",
+									  "Most detail logged by each part of the system. Verbose on a caster logs every RTCM message "
+									  "queued and sent. Levels above the build level are not available")
+						   .c_str());
+
+		// Save the new levels if we have them
+		WebServer &server = *_wifiManager.server;
+		bool changed = false;
+		for (int module = 0; module < LogModuleCount; module++)
+		{
+			char name[8];
+			snprintf(name, sizeof(name), "ll%d", module);
+			if (!server.hasArg(name))
+				continue;
+			_logLevels.Set((LogModule)module, server.arg(name).toInt());
+			changed = true;
+		}
+		if (changed)
+		{
+			_myFiles.WriteFile(LOG_LEVELS_FILENAME, _logLevels.ToString().c_str());
+			_client.println("<div class='alert alert-success' role='alert'>Log levels updated</div>");
+		}
+
+		// A select for each module
+		_client.print("<form method='get' class='container py-4 m-0 p-0'><div class='d-flex flex-wrap gap-2 mb-3'>");
+		for (int module = 0; module < LogModuleCount; module++)
+		{
+			_client.printf("<div class='form-floating'><select class='form-select' id='ll%d' name='ll%d'>", module, module);
+			for (int level = LOG_LEVEL_NONE; level <= LOG_COMPILE_LEVEL; level++)
+				_client.printf("<option value='%d'%s>%s</option>", level,
+							   level == _logLevels.Get((LogModule)module) ? " selected" : "", LogLevels::LevelName(level));
+			_client.printf("</select><label for='ll%d'>%s</label></div>", module, LogLevels::ModuleName(module));
+		}
+		_client.println("<button class='btn btn-primary' type='submit'>Apply</button></div></form>");
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief Time and size budget of each kind of route. Applied straight away and saved
+	void AddWebBudgetsForm()
+	{
+		static const char *kinds[WebBudgetKinds] = {"Pages", "API", "Assets"};
+		_client.printf("<h3 class='mt-4'>Web budgets %s</h3>",
+					   MakeHelpButton("Help",
+									  "Longest time and most data for each kind of web reply. A streamed reply that goes over "
+									  "is stopped and the transfer fails. Raise the API budget if scrapes over a slow link fail")
+						   .c_str());
+
+		// Save the new budgets if we have them
+		WebServer &server = *_wifiManager.server;
+		if (server.hasArg("wbm0"))
+		{
+			for (int kind = 0; kind < WebBudgetKinds; kind++)
+				_webRoutes.SetBudget((WebBudgetKind)kind,
+									 server.arg(StringPrintf("wbm%d", kind).c_str()).toInt(),
+									 server.arg(StringPrintf("wbk%d", kind).c_str()).toInt() * 1024);
+			_myFiles.WriteFile(WEB_BUDGETS_FILENAME, _webRoutes.BudgetsToString().c_str());
+			_client.println("<div class='alert alert-success' role='alert'>Web budgets updated</div>");
+		}
+
+		_client.print("<form method='get' class='container py-4 m-0 p-0'><div class='d-flex flex-wrap gap-2 mb-3'>");
+		for (int kind = 0; kind < WebBudgetKinds; kind++)
+		{
+			AddInput("number", StringPrintf("wbm%d", kind), StringPrintf("%s (ms)", kinds[kind]).c_str(),
+					 std::to_string(_webRoutes.GetBudgetMs((WebBudgetKind)kind)).c_str());
+			AddInput("number", StringPrintf("wbk%d", kind), StringPrintf("%s (KB)", kinds[kind]).c_str(),
+					 std::to_string(_webRoutes.GetBudgetBytes((WebBudgetKind)kind) / 1024).c_str());
+		}
+		_client.println("<button class='btn btn-primary' type='submit'>Apply</button></div></form>");
+	}
+
 	///////////////////////////////////////////////////////////////////////////////
 	/// @brief Form to setup a single caster
 	void AddCasterForm(NTRIPServer &server)
@@ -300,6 +383,24 @@ public:
 		std::string pr = "pr" + num; // Port parameter name
 		std::string cr = "cr" + num; // Credential parameter name
 		std::string pw = "pw" + num; // Password parameter name
+		std::string pv = "pv" + num; // Protocol version parameter name
+		std::string us = "us" + num; // NTRIP 2.0 user parameter name
+		std::string nd = "nd" + num; // No delay (Nagle off) parameter name
+		std::string sb = "sb" + num; // Send buffer parameter name
+		std::string ki = "ki" + num; // Keep-alive idle parameter name
+		std::string kv = "kv" + num; // Keep-alive interval parameter name
+		std::string kc = "kc" + num; // Keep-alive count parameter name
+		std::string wt = "wt" + num; // Write timeout parameter name
+		std::string bg = "bg" + num; // Send budget parameter name
+		std::string sh = "sh" + num; // Standby host parameter name
+		std::string tl = "tl" + num; // Transport (TCP or TLS) parameter name
+		std::string tp = "tp" + num; // TLS certificate pin parameter name
+		std::string ds = "ds" + num; // Station deadline parameter name
+		std::string dm = "dm" + num; // MSM deadline parameter name
+		std::string dx = "dx" + num; // Other deadline parameter name
+		std::string qd = "qd" + num; // Daily quota parameter name
+		std::string qm = "qm" + num; // Monthly quota parameter name
+		std::string qa = "qa" + num; // Quota action parameter name
 
 		// Add wrapper for the card
 		_client.println("<div class='card flex-item'>");
@@ -335,11 +436,41 @@ public:
 				}
 			}
 
+			// Socket options are saved as one line
+			std::string tuning = StringPrintf("%s,%s,%s,%s,%s,%s,%s",
+											  _wifiManager.server->arg(nd.c_str()).c_str(),
+											  _wifiManager.server->arg(sb.c_str()).c_str(),
+											  _wifiManager.server->arg(ki.c_str()).c_str(),
+											  _wifiManager.server->arg(kv.c_str()).c_str(),
+											  _wifiManager.server->arg(kc.c_str()).c_str(),
+											  _wifiManager.server->arg(wt.c_str()).c_str(),
+											  _wifiManager.server->arg(bg.c_str()).c_str());
+
+			// Deadlines are saved as one line
+			std::string deadlines = StringPrintf("%s,%s,%s",
+												 _wifiManager.server->arg(ds.c_str()).c_str(),
+												 _wifiManager.server->arg(dm.c_str()).c_str(),
+												 _wifiManager.server->arg(dx.c_str()).c_str());
+
+			// Quota is saved as one line
+			std::string quota = StringPrintf("%s,%s,%s",
+											 _wifiManager.server->arg(qd.c_str()).c_str(),
+											 _wifiManager.server->arg(qm.c_str()).c_str(),
+											 _wifiManager.server->arg(qa.c_str()).c_str());
+
 			// Save
 			server.Save(newAddress.c_str(),
 						_wifiManager.server->arg(pr.c_str()).c_str(),
 						_wifiManager.server->arg(cr.c_str()).c_str(),
-						_wifiManager.server->arg(pw.c_str()).c_str());
+						_wifiManager.server->arg(pw.c_str()).c_str(),
+						_wifiManager.server->arg(pv.c_str()).c_str(),
+						_wifiManager.server->arg(us.c_str()).c_str(),
+						tuning.c_str(),
+						Trim(ToLower(_wifiManager.server->arg(sh.c_str()).c_str())).c_str(),
+						_wifiManager.server->arg(tl.c_str()).c_str(),
+						Trim(_wifiManager.server->arg(tp.c_str()).c_str()).c_str(),
+						deadlines.c_str(),
+						quota.c_str());
 
 			saved = true;
 		}
@@ -352,6 +483,18 @@ public:
 			AddInput("number", pr, "Port (0 to disable)", std::to_string(server.GetPort()).c_str());
 			AddInput("text", cr, "Credential", server.GetCredential().c_str());
 			AddInput("password", pw, "Password", server.GetPassword().c_str());
+			AddProtocolSelect(pv, server.GetNtripVersion());
+			AddTransportSelect(tl, server.IsTls());
+			AddInput("text", tp, "TLS certificate SHA-256 (Optional. Blank accepts any certificate)", server.GetTlsPin().c_str());
+			AddInput("text", us, "User (NTRIP 2.0 only. Blank for mount point)", server.GetUser().c_str());
+			AddInput("text", sh, "Standby host (Optional. Kept connected for failover)", server.GetStandbyAddress().c_str());
+			AddSocketTuning(server.GetTuning(), nd, sb, ki, kv, kc, wt, bg);
+			_client.println("<details class='mb-3'><summary>Freshness deadlines</summary>");
+			AddInput("number", dm, "MSM deadline (ms)", std::to_string(server.GetDeadline(RtcmClassMsm)).c_str());
+			AddInput("number", ds, "Station 1005/1006/1033/1230 deadline (ms)", std::to_string(server.GetDeadline(RtcmClassStation)).c_str());
+			AddInput("number", dx, "Other messages deadline (ms)", std::to_string(server.GetDeadline(RtcmClassOther)).c_str());
+			_client.println("</details>");
+			AddQuota(server.GetQuota(), qd, qm, qa);
 
 			if (saved)
 				_client.printf("<div class='alert alert-success' role='alert'>Caster %s settings saved successfully!</div>", num.c_str());
@@ -390,6 +533,91 @@ public:
 		}
 	}
 
+	////////////////////////////////////////////////////////////////////////////////
+	/// @brief Add the NTRIP protocol version drop down
+	void AddProtocolSelect(std::string name, int version)
+	{
+		_client.printf(R"rawliteral(
+			<div class="form-floating mb-3">
+				<select class="form-control" name="%s" id="%s">
+					<option value="1" %s>NTRIP 1.0 (SOURCE)</option>
+					<option value="2" %s>NTRIP 2.0 (HTTP POST)</option>
+				</select>
+				<label for="%s" class="form-label">Protocol</label>
+			</div>)rawliteral",
+					   name.c_str(), name.c_str(),
+					   version == 2 ? "" : "selected",
+					   version == 2 ? "selected" : "",
+					   name.c_str());
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// @brief Add the plain TCP or TLS drop down
+	void AddTransportSelect(std::string name, bool tls)
+	{
+		_client.printf(R"rawliteral(
+			<div class="form-floating mb-3">
+				<select class="form-control" name="%s" id="%s">
+					<option value="0" %s>TCP</option>
+					<option value="1" %s>TLS (Use the caster's TLS port)</option>
+				</select>
+				<label for="%s" class="form-label">Transport</label>
+			</div>)rawliteral",
+					   name.c_str(), name.c_str(),
+					   tls ? "" : "selected",
+					   tls ? "selected" : "",
+					   name.c_str());
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// @brief Add the collapsed upload quota fields. Zero means no limit
+	void AddQuota(const BandwidthQuota &quota, std::string qd, std::string qm, std::string qa)
+	{
+		_client.println("<details class='mb-3'><summary>Upload quota</summary>");
+		AddInput("number", qd, "Daily quota (MB. 0 for none)", std::to_string(quota.DailyMB).c_str());
+		AddInput("number", qm, "Monthly quota (MB. 0 for none)", std::to_string(quota.MonthlyMB).c_str());
+		_client.printf(R"rawliteral(
+			<div class="form-floating mb-3">
+				<select class="form-control" name="%s" id="%s">
+					<option value="0" %s>Send a reduced message set</option>
+					<option value="1" %s>Pause uploads</option>
+				</select>
+				<label for="%s" class="form-label">When the quota is used</label>
+			</div>)rawliteral",
+					   qa.c_str(), qa.c_str(),
+					   quota.Pause ? "" : "selected",
+					   quota.Pause ? "selected" : "",
+					   qa.c_str());
+		_client.println("</details>");
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// @brief Add the collapsed socket option fields. Zero leaves the lwIP default
+	void AddSocketTuning(const SocketTuning &tuning, std::string nd, std::string sb,
+						 std::string ki, std::string kv, std::string kc, std::string wt, std::string bg)
+	{
+		_client.println("<details class='mb-3'><summary>Socket tuning</summary>");
+		_client.printf(R"rawliteral(
+			<div class="form-floating mb-3">
+				<select class="form-control" name="%s" id="%s">
+					<option value="1" %s>Send immediately (Nagle off)</option>
+					<option value="0" %s>Combine small writes (Nagle on)</option>
+				</select>
+				<label for="%s" class="form-label">Nagle</label>
+			</div>)rawliteral",
+					   nd.c_str(), nd.c_str(),
+					   tuning.NoDelay ? "selected" : "",
+					   tuning.NoDelay ? "" : "selected",
+					   nd.c_str());
+		AddInput("number", sb, "Send buffer (bytes, 0 for default)", std::to_string(tuning.SendBuffer).c_str());
+		AddInput("number", ki, "Keep-alive idle (s, 0 for off)", std::to_string(tuning.KeepIdle).c_str());
+		AddInput("number", kv, "Keep-alive interval (s)", std::to_string(tuning.KeepInterval).c_str());
+		AddInput("number", kc, "Keep-alive probes", std::to_string(tuning.KeepCount).c_str());
+		AddInput("number", wt, "Write timeout (ms, 0 for default)", std::to_string(tuning.WriteTimeoutMs).c_str());
+		AddInput("number", bg, "Most bytes per write (0 for one TCP segment)", std::to_string(tuning.SendBudget).c_str());
+		_client.println("</details>");
+	}
+
 	/*
 	<div class="input-group form-floating mb-3 password-wrapper">
 	  <input type="password" aria-required="true" class="form-control modified valid">
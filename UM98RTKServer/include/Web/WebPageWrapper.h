@@ -3,6 +3,7 @@
 #include <WiFiManager.h>
 #include <NTRIPServer.h>
 #include <MyFiles.h>
+#include "AssetServer.h"
 
 extern WiFiManager _wifiManager;
 extern NTRIPServer _ntripServer0;
@@ -31,39 +32,15 @@ public:
 
 	///////////////////////////////////////////////////////////////////////////////
 	/// @brief Display a list of possible pages
-	//<script src="https://ajax.googleapis.com/ajax/libs/jquery/3.6.0/jquery.min.js"></script>
-	// <script src="https://code.jquery.com/jquery-3.6.0.min.js"></script>
 	void AddPageHeader(const char *currentUrl)
 	{
-		_client.println(R"rawliteral(
-			<!DOCTYPE html><html><head>
-			<link href="https://cdn.jsdelivr.net/npm/bootstrap@5.3.7/dist/css/bootstrap.min.css" rel="stylesheet" integrity="sha384-LN+7fdVzj6u52u30Kp6M/trliBMCMKTyK833zpbD+pXdCLuTusPj697FH4R/5mcr" crossorigin="anonymous">
-			<script src="https://cdn.jsdelivr.net/npm/bootstrap@5.3.7/dist/js/bootstrap.bundle.min.js" integrity="sha384-ndDqU0Gzau9qJ1lfW4pNLlhNTkCfHzAVBReH9diLvGRem5+R9g2FzA8ZGN954O5Q" crossorigin="anonymous"></script>
-			<link rel="stylesheet" href="https://cdn.jsdelivr.net/npm/bootstrap-icons@1.13.1/font/bootstrap-icons.css">
-
-			<script src="https://code.jquery.com/jquery-3.7.1.slim.min.js" integrity="sha256-kmHvs0B+OpCW5GVHUNjv9rOmY0IvSIRcf7zGUDTDQM8=" crossorigin="anonymous"></script>
-
-
-			<script>
-			document.addEventListener("DOMContentLoaded", function () {
-				const popoverTriggerList = document.querySelectorAll('[data-bs-toggle="popover"]');
-				popoverTriggerList.forEach(el => new bootstrap.Popover(el));
-			});
-
-			$(document).ready(function () {
-				$('.toggle-password').on('click', function () {
-					const $wrapper = $(this).closest('.password-wrapper');
-					const $input = $wrapper.find('input[type="password"], input[type="text"]');
-					const $icon = $(this).find('i');
-
-					const isPassword = $input.attr('type') === 'password';
-					$input.attr('type', isPassword ? 'text' : 'password');
-					$icon.toggleClass('bi-eye bi-eye-slash');
-				});
-			});
+		_client.println("<!DOCTYPE html><html><head>");
 
+		// Styles and script come from flash so the pages need no Internet
+		AddAsset("portal.css");
+		AddAsset("portal.js");
 
-			</script>
+		_client.println(R"rawliteral(
 			</head>
 			<body><main>
 			<div style='position: fixed; top: 0;left: 0;right: 0;height: 60px;background-color: #000A;display: flex;align-items: center;justify-content: center;z-index: 1000;'>
@@ -84,6 +61,7 @@ public:
 		if (_ntripServer2.IsEnabled())
 			AddMenuBarItem(currentUrl, "Caster 3", "/caster3log");
 		AddMenuBarItem(currentUrl, "Caster Graph", "/castergraph");
+		AddMenuBarItem(currentUrl, "<i class='bi bi-activity'></i>", "/live");
 		AddMenuBarItem(currentUrl, "<i class='bi bi-thermometer-sun'></i>", "/tempGraph");
 		AddMenuBarItem(currentUrl, "<i class='bi bi-folder'></i>", "/files");
 		AddMenuBarItem(currentUrl, "<i class='bi bi-gear'></i>", "/settings");
@@ -93,6 +71,20 @@ public:
 		_client.println("<div style='margin-top: 60px; padding: 20px;'>");
 	}
 
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief Link a stylesheet or script from flash
+	/// .. The ETag in the URL lets the browser cache it for good
+	void AddAsset(const char *path)
+	{
+		const WebAsset *pAsset = FindWebAsset(path);
+		if (pAsset == nullptr)
+			LogError(LogWeb, "E602 - Web asset %s was not built in. Run Tools/MakeWebAssets.py", path);
+		else if (strcmp(pAsset->ContentType, "text/css") == 0)
+			_client.printf("<link rel='stylesheet' href='/a/%s?v=%s'>\n", path, pAsset->ETag);
+		else
+			_client.printf("<script src='/a/%s?v=%s'></script>\n", path, pAsset->ETag);
+	}
+
 	void AddPageFooter()
 	{
 		_client.println("</div></main></body></html>");
@@ -200,7 +192,7 @@ public:
 	<script>
 		let seconds = 10;
 		function updateCountdown() {
-			$('#countdown').text(seconds);
+			document.getElementById('countdown').textContent = seconds;
 			if (seconds > 1) {
 				seconds--;
 				setTimeout(updateCountdown, 1000);
@@ -5,11 +5,19 @@
 #include "HandyString.h"
 #include "History.h"
 #include "NTRIPServer.h"
+#include "Metrics.h"
 #include "WebPageWrapper.h"
 #include "WebPageSettings.h"
 #include "WebPageFileManager.h"
+#include "WebPageLog.h"
+#include "MetricsExporter.h"
+#include "WebApi.h"
+#include "HistoryApi.h"
+#include "TelemetryHub.h"
+#include "WebRoutes.h"
 #include <WiFiManager.h>
 #include "WifiBusyTask.h"
+#include <uri/UriBraces.h>
 #include "WiFiEvents.h"
 
 extern WiFiManager _wifiManager;
@@ -23,25 +31,47 @@ extern History _history;
 
 extern String MakeHostName();
 
+// Web task. Runs on the protocol core so pages never hold up the GPS in loop()
+#define WEB_TASK_STACK 8192
+#define WEB_TASK_PRIORITY 1
+#define WEB_TASK_DELAY_MS 2
+
 /// @brief Class manages the web pages displayed in the device.
 class WebPortal
 {
 private:
-	int _connectCount = 0; // Number of time we have connected
-	int _loops = 0;		   // Use to prevent the PortalProcessing to take up too much processing time
+	int _connectCount = 0;			   // Number of time we have connected
+	TelemetryHub _telemetry;		   // Live event streams
+	TaskHandle_t _task = NULL;		   // Web serving task
+	volatile bool _restartRequested = false; // Main loop wants the portal restarted
 
 public:
 	void Loop();
+	void StartTask();
 	int GetConnectCount() const { return _connectCount; } // Get the number of times we have connected
 
+	/// @brief Restart the portal from the web task (Safe to call from any task)
+	inline void RequestRestart() { _restartRequested = true; }
+
 private:
 	void OnBindServerCallback();
 	void ShowStatusHtml();
 	void GraphHtml() const;
-	void GraphDetail(WiFiClient &client, std::string divId, const NTRIPServer &server) const;
+	void LatencyTable(WiFiClient &client) const;
 	void GraphTemperature() const;
-	void GraphArray(WiFiClient &client, std::string divId, std::string title, const char *pBytes, int length) const;
-	void HtmlLog(const char *title, const std::vector<std::string> &log) const;
+	void LiveHtml() const;
+	void GraphFetch(WiFiClient &client, const char *divId, const std::string &title, const char *url, const char *type) const;
+	void HtmlLog(const char *title, const LogHistory &log) const;
+
+	/// @brief Bind an HTML page or an API route with the default budgets
+	inline void Page(const char *uri, WebServer::THandlerFunction handler, HTTPMethod method = HTTP_GET)
+	{
+		_webRoutes.On(*_wifiManager.server, uri, uri, method, WebBudgetPage, handler);
+	}
+	inline void Api(const char *uri, WebServer::THandlerFunction handler)
+	{
+		_webRoutes.On(*_wifiManager.server, uri, uri, HTTP_GET, WebBudgetApi, handler);
+	}
 
 	//	int _loops = 0;
 	//	bool _busyConnecting = false; // Used to prevent multiple connections at the same time
@@ -145,62 +175,73 @@ void WebPortal::OnBindServerCallback()
 {
 	Logln("Binding server callback");
 
+	// Needed to answer repeat asset requests with 304
+	const char *headers[] = {"If-None-Match"};
+	_wifiManager.server->collectHeaders(headers, 1);
+
 	// Our main pages
-	_wifiManager.server->on(
-		"/i", HTTP_GET, std::bind(&WebPortal::ShowStatusHtml, this));
-	_wifiManager.server->on(
-		"/log", HTTP_GET, [this]()
-		{ HtmlLog("System log", CopyMainLog()); });
-	_wifiManager.server->on("/gpslog", HTTP_GET,
-							[this]()
-							{ HtmlLog("GPS log", _gpsParser.GetLogHistory()); });
-	_wifiManager.server->on("/caster1log", HTTP_GET,
-							[this]()
-							{ HtmlLog("Caster 1 log", _ntripServer0.GetLogHistory()); });
-	_wifiManager.server->on("/caster2log", HTTP_GET,
-							[this]()
-							{ HtmlLog("Caster 2 log", _ntripServer1.GetLogHistory()); });
-	_wifiManager.server->on("/caster3log", HTTP_GET,
-							[this]()
-							{ HtmlLog("Caster 3 log", _ntripServer2.GetLogHistory()); });
-
-	_wifiManager.server->on(
-		"/castergraph", std::bind(&WebPortal::GraphHtml, this));
-	_wifiManager.server->on(
-		"/tempGraph", std::bind(&WebPortal::GraphTemperature, this));
-
-	_wifiManager.server->on("/files", HTTP_GET, std::bind(&WebPortal::FileManagerHtml, this));
-	_wifiManager.server->on("/settings", HTTP_GET, std::bind(&WebPortal::SettingsHtml, this));
-
-	_wifiManager.server->on("/RESET_WIFI", HTTP_GET,
-							[this]()
-							{
-								Logln("Resetting WiFi settings");
-								WiFiClient client = _wifiManager.server->client();
-								auto p = WebPageWrapper(client);
-								p.AddPageHeader(_wifiManager.server->uri().c_str());
-								_wifiManager.erase();
-								WebPageWrapper::RestartDevice(client, "https://github.com/mctainsh/Esp32/tree/main/UM98RTKServer#connect-wifi");
-							});
-	_wifiManager.server->on("/RESTART_ESP32", HTTP_GET,
-							[this]()
-							{
-								Logln("Restarting");
-								WiFiClient client = _wifiManager.server->client();
-								auto p = WebPageWrapper(client);
-								p.AddPageHeader(_wifiManager.server->uri().c_str());
-								WebPageWrapper::RestartDevice(client, "/i");
-							});
-	_wifiManager.server->on("/FRESET_GPS_CONFIRMED", HTTP_GET,
-							[this]()
-							{
-								Logln("Restarting GPS");
-								_gpsParser.GetCommandQueue().IssueFReset();
-								WiFiClient client = _wifiManager.server->client();
-								auto p = WebPageWrapper(client);
-								p.AddPageHeader(_wifiManager.server->uri().c_str());
-								WebPageWrapper::RestartDevice(client, "/gpslog");
-							});
+	Page("/i", std::bind(&WebPortal::ShowStatusHtml, this));
+	Page("/log", [this]()
+		 { HtmlLog("System log", GetMainLog()); });
+	Page("/gpslog", [this]()
+		 { HtmlLog("GPS log", _gpsParser.GetLog()); });
+	Page("/caster1log", [this]()
+		 { HtmlLog("Caster 1 log", _ntripServer0.GetLog()); });
+	Page("/caster2log", [this]()
+		 { HtmlLog("Caster 2 log", _ntripServer1.GetLog()); });
+	Page("/caster3log", [this]()
+		 { HtmlLog("Caster 3 log", _ntripServer2.GetLog()); });
+	Page("/castergraph", std::bind(&WebPortal::GraphHtml, this), HTTP_ANY);
+	Page("/tempGraph", std::bind(&WebPortal::GraphTemperature, this), HTTP_ANY);
+	Page("/live", std::bind(&WebPortal::LiveHtml, this));
+	Page("/files", std::bind(&WebPortal::FileManagerHtml, this));
+	Page("/settings", std::bind(&WebPortal::SettingsHtml, this));
+
+	// Machine readable
+	Api("/api/latency", []()
+		{ WebApi(*_wifiManager.server).LatencyJson(); });
+	Api("/api/history/send", []()
+		{ ServeSendHistory(*_wifiManager.server); });
+	Api("/api/history/temp", []()
+		{ ServeTemperatureHistory(*_wifiManager.server); });
+	Api("/api/status", []()
+		{ WebApi(*_wifiManager.server).StatusJson(); });
+	Api("/api/casters", []()
+		{ WebApi(*_wifiManager.server).CastersJson(); });
+	Api("/api/gps", []()
+		{ WebApi(*_wifiManager.server).GpsJson(); });
+	Api("/api/routes", []()
+		{ WebApi(*_wifiManager.server).RoutesJson(); });
+	Api("/metrics", []()
+		{ MetricsExporter(*_wifiManager.server).Send(); });
+	Api("/events", [this]()
+		{ _telemetry.Subscribe(_wifiManager.server->client()); });
+	_webRoutes.On(*_wifiManager.server, UriBraces("/a/{}"), "/a/", HTTP_GET, WebBudgetAsset, []()
+				  { ServeWebAsset(*_wifiManager.server, _wifiManager.server->pathArg(0)); });
+
+	Page("/RESET_WIFI", [this]()
+		 {
+			 Logln("Resetting WiFi settings");
+			 WiFiClient client = _wifiManager.server->client();
+			 auto p = WebPageWrapper(client);
+			 p.AddPageHeader(_wifiManager.server->uri().c_str());
+			 _wifiManager.erase();
+			 WebPageWrapper::RestartDevice(client, "https://github.com/mctainsh/Esp32/tree/main/UM98RTKServer#connect-wifi"); });
+	Page("/RESTART_ESP32", [this]()
+		 {
+			 Logln("Restarting");
+			 WiFiClient client = _wifiManager.server->client();
+			 auto p = WebPageWrapper(client);
+			 p.AddPageHeader(_wifiManager.server->uri().c_str());
+			 WebPageWrapper::RestartDevice(client, "/i"); });
+	Page("/FRESET_GPS_CONFIRMED", [this]()
+		 {
+			 Logln("Restarting GPS");
+			 _gpsParser.RequestFReset();
+			 WiFiClient client = _wifiManager.server->client();
+			 auto p = WebPageWrapper(client);
+			 p.AddPageHeader(_wifiManager.server->uri().c_str());
+			 WebPageWrapper::RestartDevice(client, "/gpslog"); });
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -208,6 +249,12 @@ void WebPortal::OnBindServerCallback()
 /// connection is available
 void WebPortal::Loop()
 {
+	if (_restartRequested)
+	{
+		_restartRequested = false;
+		SetupWiFi();
+	}
+
 	if (!_wifiManager.getConfigPortalActive())
 	{
 		// Process the WiFi manager (Restart if necessary)
@@ -215,12 +262,102 @@ void WebPortal::Loop()
 	}
 	else
 	{
-		if (_loops++ > 10000)
+		_wifiManager.process();
+		_telemetry.Loop();
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// @brief Serve the web pages from their own task
+/// .. The task runs on the other core to the main loop so a slow page can
+/// .. never hold up reading the GPS
+void WebPortal::StartTask()
+{
+	xTaskCreatePinnedToCore(
+		[](void *pParam)
 		{
-			_loops = 0;
-			_wifiManager.process();
-		}
+			auto pPortal = static_cast<WebPortal *>(pParam);
+			while (true)
+			{
+				pPortal->Loop();
+				vTaskDelay(pdMS_TO_TICKS(WEB_TASK_DELAY_MS));
+			}
+		},
+		"WebTask",		   // Task name
+		WEB_TASK_STACK,	   // Stack size (bytes)
+		this,			   // Parameter
+		WEB_TASK_PRIORITY, // Task priority
+		&_task,			   // Task handle
+		PRO_CPU_NUM);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Live view. Fed once a second from /events
+void WebPortal::LiveHtml() const
+{
+	WiFiClient client = _wifiManager.server->client();
+	auto p = WebPageWrapper(client);
+	p.AddPageHeader(_wifiManager.server->uri().c_str());
+
+	client.print(R"rawliteral(
+<h3>Live</h3>
+<style>.r{text-align:right;}</style>
+<p id='state' class='text-muted'>Connecting...</p>
+<table class='table table-striped w-auto'>
+	<tr><td>WiFi signal (dBm)</td><td class='r' id='rssi'></td></tr>
+	<tr><td>Free heap</td><td class='r' id='heap'></td></tr>
+	<tr><td>Temperature (&deg;C)</td><td class='r' id='temp'></td></tr>
+	<tr><td>GPS packets / second</td><td class='r' id='gps'></td></tr>
+</table>
+<h5>Casters</h5>
+<table class='table table-striped w-auto'>
+	<thead><tr><th>Caster</th><th>Queued (bytes)</th><th>Packets / second</th><th>Mean send (&#181;s)</th></tr></thead>
+	<tbody id='casters'></tbody>
+</table>
+<h5>Message types</h5>
+<table class='table table-striped w-auto'>
+	<thead><tr><th>Type</th><th>Per second</th><th>Since opened</th></tr></thead>
+	<tbody id='types'></tbody>
+</table>
+<script>
+const totals = {};
+function cell(row, n, value) {
+	while (row.cells.length <= n) row.insertCell().className = 'r';
+	row.cells[n].textContent = value;
+}
+function row(body, id, title) {
+	let r = document.getElementById(id);
+	if (!r) {
+		r = body.insertRow();
+		r.id = id;
+		r.insertCell().textContent = title;
 	}
+	return r;
+}
+const events = new EventSource('/events');
+events.onopen = () => document.getElementById('state').textContent = 'Live';
+events.onerror = () => document.getElementById('state').textContent = 'Reconnecting...';
+events.onmessage = e => {
+	const d = JSON.parse(e.data);
+	for (const k of ['rssi', 'heap', 'temp', 'gps'])
+		if (k in d) document.getElementById(k).textContent = d[k].toLocaleString();
+	const casters = document.getElementById('casters');
+	d.c.forEach((c, i) => {
+		const r = row(casters, 'c' + i, 'Caster ' + (i + 1));
+		c.forEach((v, n) => cell(r, n + 1, v.toLocaleString()));
+	});
+	const types = document.getElementById('types');
+	for (const t in d.types) totals[t] = (totals[t] || 0) + d.types[t];
+	for (const t in totals) {
+		const r = row(types, 't' + t, t);
+		cell(r, 1, d.types[t] || 0);
+		cell(r, 2, totals[t].toLocaleString());
+	}
+};
+</script>
+)rawliteral");
+
+	p.AddPageFooter();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -232,53 +369,59 @@ void WebPortal::GraphHtml() const
 	auto p = WebPageWrapper(client);
 	p.AddPageHeader(_wifiManager.server->uri().c_str());
 
-	client.print(
-		"<script src='https://cdn.plot.ly/plotly-latest.min.js'></script>");
+	p.AddAsset("chart.js");
 	client.print(
 		"<h3>Average packet send time for the second (5 minutes total)</h3>");
-	GraphDetail(client, "1", _ntripServer0);
-	GraphDetail(client, "2", _ntripServer1);
-	GraphDetail(client, "3", _ntripServer2);
+	for (auto pServer : {&_ntripServer0, &_ntripServer1, &_ntripServer2})
+	{
+		char divId[4];
+		char url[32];
+		snprintf(divId, sizeof(divId), "%d", pServer->GetIndex() + 1);
+		snprintf(url, sizeof(url), "/api/history/send?caster=%d", pServer->GetIndex());
+		GraphFetch(client, divId, pServer->GetAddress() + " (&#181;s)", url, "i32");
+	}
+	LatencyTable(client);
 
 	p.AddPageFooter();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-/// @brief Plot a single graph
-/// @param html Where to append the graph
-/// @param divId Id of the div to plot the graph in
-/// @param server The server to plot. Source of title and data
-void WebPortal::GraphDetail(
-	WiFiClient &client, std::string divId, const NTRIPServer &server) const
+/// @brief Table of enqueue to wire latency percentiles for each caster
+/// .. Frames that expired or were dropped are included at their age
+/// @param client Where to write the table
+void WebPortal::LatencyTable(WiFiClient &client) const
 {
-	auto sendMicrosecondList = _history.GetNtripSendTime(server.GetIndex());
-	std::string html = "<div id='myPlot" + divId + "' style='width:100%;max-width:700px'></div>\n";
-	html += "<script>";
-	client.print(html.c_str());
-
-	html = "const xValues" + divId + " = [";
-	for (int n = 0; n < sendMicrosecondList.size(); n++)
+	client.print("<h3>Enqueue to wire latency (&#181;s)</h3>");
+	client.print("<table class='table table-striped w-auto'>");
+	client.print("<tr><th>Caster</th><th>Period</th><th>Frames</th><th>p50</th><th>p90</th><th>p99</th><th>Max</th><th>Expired</th><th>Dropped</th></tr>");
+	for (auto pServer : {&_ntripServer0, &_ntripServer1, &_ntripServer2})
 	{
-		if (n != 0)
-			html += ",";
-		html += StringPrintf("%d", n);
+		for (bool window : {true, false})
+		{
+			LatencySummary h;
+			pServer->GetQueueLatency().Summarise(h, window);
+			client.print(StringPrintf(
+							 "<tr><td>%s</td><td>%s</td><td class='r'>%u</td><td class='r'>%u</td><td class='r'>%u</td><td class='r'>%u</td><td class='r'>%u</td><td class='r'>%u</td><td class='r'>%u</td></tr>",
+							 pServer->GetAddress().c_str(), window ? "Last minute" : "Since start", h.Count,
+							 h.P50, h.P90, h.P99, h.Max, h.Expired, h.Dropped)
+							 .c_str());
+		}
 	}
-	html += "];";
-	client.print(html.c_str());
+	client.print("</table>");
+}
 
-	html = "const yValues" + divId + " = [";
-	for (int n = 0; n < sendMicrosecondList.size(); n++)
-	{
-		if (n != 0)
-			html += ",";
-		html += StringPrintf("%d", sendMicrosecondList[n]);
-	}
-	html += "];";
-	html += "Plotly.newPlot('myPlot" + divId + "', [{x:xValues" + divId +
-			", y:yValues" + divId + ", mode:'lines'}], {title: '" +
-			server.GetAddress() + " (&#181;s)'});";
-	html += "</script>";
-	client.print(html.c_str());
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Plot a single graph. The browser fetches the data from /api/history
+/// @param client Where to write the graph
+/// @param divId Id of the div to plot the graph in
+/// @param title Graph title
+/// @param url Binary series to plot
+/// @param type Type of each value ('i32' or 'i8')
+void WebPortal::GraphFetch(
+	WiFiClient &client, const char *divId, const std::string &title, const char *url, const char *type) const
+{
+	client.printf("<div id='myPlot%s' style='width:100%%;max-width:700px'></div>\n", divId);
+	client.printf("<script>FetchChart('myPlot%s', '%s', '%s', '%s');</script>\n", divId, title.c_str(), url, type);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -288,87 +431,103 @@ void WebPortal::GraphTemperature() const
 	WiFiClient client = _wifiManager.server->client();
 	auto p = WebPageWrapper(client);
 	p.AddPageHeader(_wifiManager.server->uri().c_str());
-	client.print("<script src='https://cdn.plot.ly/plotly-latest.min.js'></script>");
+	p.AddAsset("chart.js");
 	client.print("<h3>24 hour Temperature</h3>");
 
-	GraphArray(client, "T", "CPU Temperature (&deg;C)", _history.GetTemperatures(), TEMP_HISTORY_SIZE);
+	GraphFetch(client, "T", "CPU Temperature (&deg;C)", "/api/history/temp", "i8");
 
 	p.AddPageFooter();
 }
 
-void WebPortal::GraphArray(WiFiClient &client, std::string divId, std::string title, const char *pBytes, int length) const
-{
-	client.print(std::string("<div id='myPlot" + divId + "' style='width:100%;max-width:700px'></div><script>").c_str());
-	std::string html = "const xValues" + divId + " = [";
-	for (int n = 0; n < length; n++)
-	{
-		if (n != 0)
-			html += ",";
-		html += StringPrintf("%d", n);
-	}
-	html += "];";
-	client.print(html.c_str());
-
-	html = "const yValues" + divId + " = [";
-	for (int n = 0; n < length; n++)
-	{
-		if (n != 0)
-			html += ",";
-		html += StringPrintf("%d", pBytes[n]);
-	}
-	client.print(html.c_str());
-
-	html = "]; Plotly.newPlot('myPlot" + divId + "', [{x:xValues" + divId +
-		   ", y:yValues" + divId + ", mode:'lines'}], {title: '";
-	client.print(html.c_str());
-	client.print(title.c_str());
-	client.print("'});</script>\n");
-}
-
 ///////////////////////////////////////////////////////////////////////////////
 /// @brief Display a log in html format
 /// @param title Title of the log
 /// @param log The log to display
 /// TODO : Force to DOS Codepage 437
-void WebPortal::HtmlLog(const char *title, const std::vector<std::string> &log) const
+void WebPortal::HtmlLog(const char *title, const LogHistory &log) const
 {
 	Logf("Show '%s'", title);
-
 	WiFiClient client = _wifiManager.server->client();
-	auto p = WebPageWrapper(client);
-	p.AddPageHeader(_wifiManager.server->uri().c_str());
-
-	client.print("<h3>");
-	client.print(title);
-	client.println("</h3>");
-	client.print("<pre>");
-	for (const auto &entry : log)
-	{
-		client.print(Replace(ReplaceNewlineWithTab(entry), "<", "&lt;").c_str());
-		client.print("\n");
-	}
-	client.println("</pre>");
-
-	p.AddPageFooter();
+	WebPageLog(client).ShowHtml(title, log);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-void ServerStatsHtml(NTRIPServer &server, WebPageWrapper &p)
+void ServerStatsHtml(NTRIPServer &server, const MetricSnapshot &metrics, WebPageWrapper &p)
 {
+	int index = server.GetIndex();
+	CasterSnapshot caster;
+	server.GetSnapshot(caster);
+	unsigned long now = millis();
+
 	p.GetClient().print("<td><Table class='table table-striped w-auto'>");
 	p.TableRow(2, "Address", server.GetAddress());
 	p.TableRow(3, "Port", server.GetPort());
 	p.TableRow(3, "Credential", server.GetCredential());
-	p.TableRow(3, "Status", server.GetStatus());
-	p.TableRow(3, "Reconnects", server.GetReconnects());
-	p.TableRow(3, "Packets sent", server.GetPacketsSent());
-	p.TableRow(3, "Queue overflows", server.GetQueueOverflows());
-	p.TableRow(3, "Send timeouts", server.GetTotalTimeouts());
-	p.TableRow(3, "Expired packets", server.GetExpiredPackets());
+	p.TableRow(3, "Protocol", server.GetNtripVersion() == 2 ? "NTRIP 2.0" : "NTRIP 1.0");
+	p.TableRow(3, "Status", caster.Status);
+	if (caster.RejectedAt != 0)
+	{
+		p.TableRow(4, "Last refusal", caster.RejectReason);
+		p.TableRow(4, "Refused (s ago)", (int32_t)((now - caster.RejectedAt) / 1000));
+		if (caster.Rejected)
+			p.TableRow(4, "Uploads resume (s)", (int32_t)((NTRIP_REJECT_BACKOFF_MS - min((unsigned long)NTRIP_REJECT_BACKOFF_MS, now - caster.RejectedAt)) / 1000));
+	}
+	p.TableRow(3, "Reconnects", metrics.Get(Metric::CasterReconnects, index));
+	p.TableRow(3, "Health score", caster.HealthScore);
+	p.TableRow(4, "Circuit breaker", caster.Breaker);
+	p.TableRow(4, "Next retry (s)", (int32_t)(caster.NextRetryMs / 1000));
+	p.TableRow(3, "Packets sent", metrics.Get(Metric::CasterPacketsSent, index));
+	p.TableRow(3, "Queue overflows", metrics.Get(Metric::CasterQueueOverflows, index));
+	p.TableRow(4, "Queued (bytes)", metrics.GetGauge(Metric::CasterQueueBytes, index));
+	p.TableRow(4, "Station drops", caster.ClassDrops[RtcmClassStation]);
+	p.TableRow(4, "MSM drops", caster.ClassDrops[RtcmClassMsm]);
+	p.TableRow(4, "Other drops", caster.ClassDrops[RtcmClassOther]);
+	p.TableRow(3, "Send timeouts", caster.TotalTimeouts);
+	p.TableRow(3, "Expired packets", metrics.Get(Metric::CasterExpiredPackets, index));
+	p.TableRow(4, StringPrintf("Station (%lums)", server.GetDeadline(RtcmClassStation)), caster.Expired[RtcmClassStation]);
+	p.TableRow(4, StringPrintf("MSM (%lums)", server.GetDeadline(RtcmClassMsm)), caster.Expired[RtcmClassMsm]);
+	p.TableRow(4, StringPrintf("Other (%lums)", server.GetDeadline(RtcmClassOther)), caster.Expired[RtcmClassOther]);
 	p.TableRow(
-		3, "Median Send (&micro;s)", _history.MedianSendTime(server.GetIndex()));
-	p.TableRow(3, "Max send (&#181;s)", server.GetMaxSendTime());
-	p.TableRow(3, "Max Stack Height", server.GetMaxStackHeight());
+		3, "Median Send (&micro;s)", _history.MedianSendTime(index));
+	p.TableRow(3, "Max send (&#181;s)", caster.MaxSendTime);
+	p.TableRow(3, "Writes", caster.TotalWrites);
+	p.TableRow(3, "Writes / second", caster.WritesPerSecond);
+	p.TableRow(3, "Bytes / write", caster.BytesPerWrite);
+	p.TableRow(3, "Catch-up (ms)", caster.LastCatchUpTime);
+	p.TableRow(3, "Max catch-up (ms)", caster.MaxCatchUpTime);
+	if (!server.GetStandbyAddress().empty())
+	{
+		p.TableRow(3, "Active host", caster.ActiveHost);
+		p.TableRow(3, "Standby", caster.StandbyReady ? "Ready" : "Not connected");
+		p.TableRow(4, "Failovers", caster.Failovers);
+		p.TableRow(4, "Last failover (ms)", caster.LastFailoverTime);
+	}
+	if (server.IsTls())
+	{
+		p.TableRow(3, "TLS handshake (ms)", caster.HandshakeTime);
+		p.TableRow(4, "Resumed", StringPrintf("%d of %d", caster.ResumedHandshakes, caster.ResumedHandshakes + caster.FullHandshakes));
+		p.TableRow(4, "Heap (bytes)", caster.TlsHeapUsed);
+		p.TableRow(4, "Encrypt (&#181;s/KB)", caster.EncryptMicrosPerKb);
+		p.TableRow(4, "Certificate SHA-256", caster.TlsFingerprint);
+	}
+	p.TableRow(3, "Sent (KB)", ToThousands((int)(caster.TotalSent / 1024)));
+	p.TableRow(4, "Today (KB)", ToThousands((int)(caster.DaySent / 1024)));
+	p.TableRow(4, "This month (KB)", ToThousands((int)(caster.MonthSent / 1024)));
+	p.TableRow(4, "Rate 1s / 1m / 1h (B/s)", StringPrintf("%u / %u / %u", caster.Rate1s, caster.Rate1m, caster.Rate1h));
+	p.TableRow(3, "Received (bytes)", ToThousands((int)caster.TotalReceived));
+	p.TableRow(3, "Quota", caster.QuotaStatus);
+	if (server.GetQuota().IsSet())
+	{
+		p.TableRow(4, "Limit day / month (MB)", StringPrintf("%d / %d", server.GetQuota().DailyMB, server.GetQuota().MonthlyMB));
+		p.TableRow(4, "MSM skipped", caster.QuotaDrops);
+	}
+	p.TableRow(3, "Socket options", server.GetTuning().ToString());
+	p.TableRow(4, "Send buffer", caster.SendBufferSize);
+	p.TableRow(4, "Would block", caster.WouldBlocks);
+	p.TableRow(4, "Blocked (ms)", caster.BlockedTime);
+	p.TableRow(3, "Max Stack Height", caster.MaxStackHeight);
+	if (!server.GetStandbyAddress().empty())
+		p.TableRow(4, "Standby task", caster.StandbyStackHeight);
 	p.GetClient().print("</td></Table>");
 }
 
@@ -378,6 +537,10 @@ void WebPortal::ShowStatusHtml()
 {
 	Logln("ShowStatusHtml");
 
+	// Every counter on the page comes from the same moment (Also used by /api/status)
+	MetricSnapshot metrics;
+	_metrics.Snapshot(metrics);
+
 	WiFiClient client = _wifiManager.server->client();
 	auto p = WebPageWrapper(client);
 	p.AddPageHeader(_wifiManager.server->uri().c_str());
@@ -432,42 +595,39 @@ void WebPortal::ShowStatusHtml()
 														   : "Unknown")));
 
 	// p.TableRow( 1, "Free Heap", ESP.getFreeHeap());
+	GpsSnapshot gps;
+	_gpsParser.GetSnapshot(gps);
 	p.TableRow(0, "GPS", "");
-	p.TableRow(1, "Device type", _gpsParser.GetCommandQueue().GetDeviceType());
-	p.TableRow(
-		1, "Device firmware", _gpsParser.GetCommandQueue().GetDeviceFirmware());
-	p.TableRow(
-		1, "Device serial #", _gpsParser.GetCommandQueue().GetDeviceSerial());
+	p.TableRow(1, "Device type", gps.DeviceType);
+	p.TableRow(1, "Device firmware", gps.DeviceFirmware);
+	p.TableRow(1, "Device serial #", gps.DeviceSerial);
 
 	// Counters and stats
-	int32_t resetCount, reinitialize, messageCount;
-	_display.GetGpsStats(resetCount, reinitialize, messageCount);
-	p.TableRow(1, "Reset count", resetCount);
-	p.TableRow(1, "Reinitialize count", reinitialize);
-
-	p.TableRow(1, "Bytes received", _gpsParser.GetGpsBytesRec());
-	p.TableRow(1, "Reset count", _gpsParser.GetGpsResetCount());
-	p.TableRow(1, "Reinitialize count", _gpsParser.GetGpsReinitialize());
-
-	p.TableRow(1, "Read errors", _gpsParser.GetReadErrorCount());
-	p.TableRow(1, "Max buffer size", _gpsParser.GetMaxBufferSize());
+	p.TableRow(1, "Data timeouts", metrics.Get(Metric::GpsTimeouts));
+	p.TableRow(1, "Reset count", metrics.Get(Metric::GpsResets));
+	p.TableRow(1, "Reinitialize count", metrics.Get(Metric::GpsReinitialise));
+	p.TableRow(1, "Bytes received", metrics.Get(Metric::GpsBytes));
+	p.TableRow(1, "RTCM packets", metrics.Get(Metric::GpsPackets));
+	p.TableRow(1, "Read errors", metrics.Get(Metric::GpsReadErrors));
+	p.TableRow(1, "Max buffer size", gps.MaxBufferSize);
 
 	p.TableRow(0, "Message counts", "");
-	p.TableRow(1, "ASCII", _gpsParser.GetAsciiMsgCount());
+	p.TableRow(1, "ASCII", metrics.Get(Metric::GpsAsciiPackets));
 	int totalRtkMessages = 0;
-	for (const auto &pair : _gpsParser.GetMsgTypeTotals())
+	for (int n = 0; n < gps.TypeCount; n++)
 	{
-		p.TableRow(1, std::to_string(pair.first), pair.second);
-		totalRtkMessages += pair.second;
+		p.TableRow(1, std::to_string(gps.Types[n]), gps.Counts[n]);
+		totalRtkMessages += gps.Counts[n];
 	}
 	p.TableRow(1, "Total messages", totalRtkMessages);
 	client.println("</table>");
 
 	client.println("<Table><tr>");
-	ServerStatsHtml(_ntripServer0, p);
-	ServerStatsHtml(_ntripServer1, p);
-	ServerStatsHtml(_ntripServer2, p);
+	ServerStatsHtml(_ntripServer0, metrics, p);
+	ServerStatsHtml(_ntripServer1, metrics, p);
+	ServerStatsHtml(_ntripServer2, metrics, p);
 	client.println("</tr></Table>");
+	_webRoutes.Sample();
 
 	// Drive details
 	client.println("<table class='table table-striped w-auto'>");
@@ -521,6 +681,25 @@ void WebPortal::ShowStatusHtml()
 	// p.TableRow( 1, "himem phys", esp_himem_get_phys_size());
 	// p.TableRow( 1, "himem reserved", esp_himem_reserved_area_size());
 
+	// Cost of the web replies
+	p.TableRow(0, "Web", "");
+	p.TableRow(1, "Replies sent", metrics.GetHistogram(Metric::WebRenderTime)[METRIC_BUCKETS]);
+	p.TableRow(1, "Last reply heap", metrics.GetGauge(Metric::WebHeapUsed));
+	p.TableRow(1, "Last scrape (&#181;s)", metrics.GetGauge(Metric::MetricsScrapeTime));
+	client.println("</table>");
+
+	// Time taken by each route
+	client.println("<table class='table table-striped w-auto'>");
+	client.println("<tr><th>Route</th><th class='r'>Count</th><th class='r'>Over</th>"
+				   "<th class='r'>Last (ms)</th><th class='r'>Max (ms)</th><th class='r'>Max bytes</th><th class='r'>Max heap</th></tr>");
+	for (int n = 0; n < _webRoutes.GetCount(); n++)
+	{
+		const WebRoute &route = _webRoutes.Get(n);
+		client.printf("<tr><td>%s</td><td class='r'>%u</td><td class='r%s'>%u</td>"
+					  "<td class='r'>%.1f</td><td class='r'>%.1f</td><td class='r'>%u</td><td class='r'>%u</td></tr>\n",
+					  route.Name, route.Count, route.OverBudget ? " i1" : "", route.OverBudget,
+					  route.LastUs / 1000.0, route.MaxUs / 1000.0, route.MaxBytes, route.MaxHeapUsed);
+	}
 	client.println("</table>");
 	p.AddPageFooter();
 }
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <WebServer.h>
+
+#include "HandyString.h"
+#include "Metrics.h"
+#include "LogLevel.h"
+
+// Most routes tracked
+#define WEB_MAX_ROUTES 32
+
+// Default budgets (Changed on the settings page). Pages are rendered in the web
+// .. task so going over only slows the web. Streaming replies stop at the budget
+// .. and end as a failed transfer, others are logged
+#define WEB_BUDGET_PAGE_MS 500
+#define WEB_BUDGET_PAGE_BYTES (64 * 1024)
+#define WEB_BUDGET_API_MS 100
+#define WEB_BUDGET_API_BYTES (16 * 1024)
+#define WEB_BUDGET_ASSET_MS 1000
+#define WEB_BUDGET_ASSET_BYTES (256 * 1024)
+
+// Kinds of route. Each kind shares one budget
+enum WebBudgetKind : uint8_t
+{
+	WebBudgetPage,
+	WebBudgetApi,
+	WebBudgetAsset,
+	WebBudgetKinds
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Budget and latency statistics for one route
+struct WebRoute
+{
+	const char *Name;		   // URI (or pattern) shown in the statistics
+	WebBudgetKind Kind;		   // Budget the route uses
+	unsigned long BudgetMs;	   // Longest a reply should take
+	size_t BudgetBytes;		   // Most bytes a streamed reply may send
+	uint32_t Count;			   // Requests served
+	uint32_t OverBudget;	   // Requests that went over either budget
+	uint32_t LastUs;		   // Time taken by the last request
+	uint32_t MaxUs;			   // Longest request
+	uint64_t TotalUs;		   // Time taken by all requests (For the mean)
+	uint32_t MaxBytes;		   // Most bytes streamed by one request
+	uint32_t MaxHeapUsed;	   // Most heap used by one request
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Binds routes with a time and byte budget and measures each request
+/// .. Only used from the web task so the statistics need no locking
+class WebRoutes
+{
+private:
+	WebRoute _routes[WEB_MAX_ROUTES];
+	int _count = 0;
+	WebRoute *_pCurrent = nullptr; // Route being served
+	unsigned long _start = 0;	   // Start time of the current request (us)
+	uint32_t _startHeap = 0;	   // Free heap at the start of the current request
+	uint32_t _minHeap = 0;		   // Lowest free heap seen in the current request
+	size_t _bytes = 0;			   // Bytes streamed by the current request
+	unsigned long _budgetMs[WebBudgetKinds] = {WEB_BUDGET_PAGE_MS, WEB_BUDGET_API_MS, WEB_BUDGET_ASSET_MS};
+	size_t _budgetBytes[WebBudgetKinds] = {WEB_BUDGET_PAGE_BYTES, WEB_BUDGET_API_BYTES, WEB_BUDGET_ASSET_BYTES};
+
+public:
+	inline int GetCount() const { return _count; }
+	inline const WebRoute &Get(int n) const { return _routes[n]; }
+	inline unsigned long GetBudgetMs(WebBudgetKind kind) const { return _budgetMs[kind]; }
+	inline size_t GetBudgetBytes(WebBudgetKind kind) const { return _budgetBytes[kind]; }
+
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief Change the budget for a kind of route. Zero keeps the current value
+	void SetBudget(WebBudgetKind kind, unsigned long ms, size_t bytes)
+	{
+		if (ms > 0)
+			_budgetMs[kind] = ms;
+		if (bytes > 0)
+			_budgetBytes[kind] = bytes;
+		for (int n = 0; n < _count; n++)
+		{
+			if (_routes[n].Kind != kind)
+				continue;
+			_routes[n].BudgetMs = _budgetMs[kind];
+			_routes[n].BudgetBytes = _budgetBytes[kind];
+		}
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief Budgets saved as "ms,bytes" for each kind (Page, API then asset)
+	std::string BudgetsToString() const
+	{
+		std::string text;
+		for (int kind = 0; kind < WebBudgetKinds; kind++)
+			text += StringPrintf("%s%lu,%u", kind == 0 ? "" : ",", _budgetMs[kind], (unsigned)_budgetBytes[kind]);
+		return text;
+	}
+	void BudgetsFromString(const std::string &text)
+	{
+		auto parts = Split(text, ",");
+		for (int kind = 0; kind < WebBudgetKinds && kind * 2 + 1 < (int)parts.size(); kind++)
+			SetBudget((WebBudgetKind)kind, atol(parts[kind * 2].c_str()), atol(parts[kind * 2 + 1].c_str()));
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief Bind a handler. Routes past WEB_MAX_ROUTES are bound without statistics
+	template <typename TUri>
+	void On(WebServer &server, const TUri &uri, const char *name, HTTPMethod method,
+			WebBudgetKind kind, WebServer::THandlerFunction handler)
+	{
+		// The portal binds again each time it restarts. Keep the statistics
+		WebRoute *pRoute = Find(name);
+		if (pRoute == nullptr)
+		{
+			if (_count >= WEB_MAX_ROUTES)
+			{
+				server.on(uri, method, handler);
+				return;
+			}
+			pRoute = &_routes[_count++];
+			*pRoute = WebRoute();
+			pRoute->Name = name;
+		}
+		pRoute->Kind = kind;
+		pRoute->BudgetMs = _budgetMs[kind];
+		pRoute->BudgetBytes = _budgetBytes[kind];
+		server.on(uri, method, [this, pRoute, handler]()
+				  { Run(pRoute, handler); });
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief Sample the heap for the high water mark. Call at checkpoints
+	inline void Sample()
+	{
+		uint32_t free = ESP.getFreeHeap();
+		if (free < _minHeap)
+			_minHeap = free;
+	}
+
+	inline unsigned long Elapsed() const { return micros() - _start; }
+
+	///////////////////////////////////////////////////////////////////////////////
+	/// @brief Count bytes streamed. Returns false once the reply is over budget
+	/// .. and should stop
+	bool AddBytes(size_t bytes)
+	{
+		_bytes += bytes;
+		Sample();
+		if (_pCurrent == nullptr)
+			return true;
+		return _bytes <= _pCurrent->BudgetBytes && Elapsed() <= _pCurrent->BudgetMs * 1000;
+	}
+
+private:
+	WebRoute *Find(const char *name)
+	{
+		for (int n = 0; n < _count; n++)
+			if (strcmp(_routes[n].Name, name) == 0)
+				return &_routes[n];
+		return nullptr;
+	}
+
+	void Run(WebRoute *pRoute, const WebServer::THandlerFunction &handler)
+	{
+		_pCurrent = pRoute;
+		_bytes = 0;
+		_startHeap = ESP.getFreeHeap();
+		_minHeap = _startHeap;
+		_start = micros();
+
+		handler();
+
+		Sample();
+		uint32_t time = Elapsed();
+		pRoute->Count++;
+		pRoute->LastUs = time;
+		pRoute->MaxUs = max(pRoute->MaxUs, time);
+		pRoute->TotalUs += time;
+		pRoute->MaxBytes = max(pRoute->MaxBytes, (uint32_t)_bytes);
+		_metrics.Record(Metric::WebRenderTime, 0, time);
+		pRoute->MaxHeapUsed = max(pRoute->MaxHeapUsed, _startHeap - _minHeap);
+		_metrics.Set(Metric::WebHeapUsed, (int32_t)(_startHeap - _minHeap));
+
+		if (time > pRoute->BudgetMs * 1000 || _bytes > pRoute->BudgetBytes)
+		{
+			pRoute->OverBudget++;
+			LogWarn(LogWeb, "W601 - %s over budget. %lums of %lums, %d of %d bytes", pRoute->Name,
+					(unsigned long)(time / 1000), pRoute->BudgetMs, (int)_bytes, (int)pRoute->BudgetBytes);
+		}
+		_pCurrent = nullptr;
+	}
+};
+
+extern WebRoutes _webRoutes;
@@ -2,6 +2,7 @@
 
 #include <WiFi.h>
 #include "HandyLog.h"
+#include "LogLevel.h"
 
 String MakeHostName();
 
@@ -14,11 +15,11 @@ void LogDuplicateEvents()
 		return;
 	if (_duplicateEventCount == 1)
 	{
-		Logf("%s (earlier)",_lastEvent);
+		LogInfo(LogWifi, "%s (earlier)", _lastEvent);
 	}
 	else
 	{
-		Logf(" >>> %s (%d times)", _lastEvent, _duplicateEventCount);
+		LogInfo(LogWifi, " >>> %s (%d times)", _lastEvent, _duplicateEventCount);
 	}
 	_lastEvent = nullptr;	  // Reset the last event after logging
 	_duplicateEventCount = 0; // Reset the duplicate count
@@ -165,7 +166,7 @@ void OnWifiEvent(WiFiEvent_t event, WiFiEventInfo_t info)
 		break;
 	default:
 		LogDuplicateEvents();
-		Logf("WIFI - %d", event);
+		LogInfo(LogWifi, "WIFI - %d", (int)event);
 		return;
 	}
 
@@ -179,7 +180,7 @@ void OnWifiEvent(WiFiEvent_t event, WiFiEventInfo_t info)
 	else
 	{
 		LogDuplicateEvents();
-		Logln(eventMessage);
+		LogInfo(LogWifi, "%s", eventMessage);
 		_lastEvent = eventMessage; // Store the last event message
 		_duplicateEventCount = 0;  // Reset the duplicate count
 	}
@@ -1,44 +1,46 @@
 #include "HandyLog.h"
 #include <HandyString.h>
 #include <Global.h>
-#include <MyFiles.h>
-// #include "freertos/semphr.h"
+#include "LogHistory.h"
+#include "Metrics.h"
 
 std::string AddToLog(const char *msg, bool timePrefix = true);
 
-std::vector<std::string> _mainLog;
-
-bool _processedFirstGoodTime = false; // Indicate if we have got a good time from NTP
-
-static SemaphoreHandle_t _serialMutex;
-extern MyFiles _myFiles;
+// Text lines start with _handyTime.LongString() so records use the clock time too
+static LogHistory _mainLog(LogClockWall);
 
 //////////////////////////////////////////////////////////////////////////
 // Setup the logging stuff
 void SetupLog()
 {
-	_serialMutex = xSemaphoreCreateMutex();
-	if (_serialMutex == NULL)
-		perror("Failed to create serial mutex\n");
-	else
-		Logln("Serial Mutex Created");
+	if (!_mainLog.Allocate(LogArenaSize(LOG_ARENA_MAIN)))
+		perror("E111 - No memory for the main log\n");
+	Logln("Log started");
+	Logf("Main log %d bytes. Free heap %d", _mainLog.GetArenaSize(), ESP.getFreeHeap());
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Arena size for a log. Halves wanted till it fits in a share of the heap
+uint32_t LogArenaSize(uint32_t wanted)
+{
+	uint32_t limit = min(ESP.getFreeHeap() / LOG_ARENA_HEAP_SHARE, ESP.getMaxAllocHeap());
+	while (wanted > LOG_ARENA_MIN && wanted > limit)
+		wanted /= 2;
+	return wanted;
 }
 
 ////////////////////////////////////////////////////////////////////////////
 // Get a copy of the main log safely
 const std::vector<std::string> CopyMainLog()
 {
-	std::vector<std::string> copyVector;
-	if (xSemaphoreTake(_serialMutex, portMAX_DELAY))
-	{
-		copyVector.insert(copyVector.end(), _mainLog.begin(), _mainLog.end());
-		xSemaphoreGive(_serialMutex);
-	}
-	else
-	{
-		perror("CopyMainLog:Failed to take serial mutex\n");
-	}
-	return copyVector;
+	return _mainLog.Copy();
+}
+
+////////////////////////////////////////////////////////////////////////////
+// The main log for pages that read it in place
+const LogHistory &GetMainLog()
+{
+	return _mainLog;
 }
 
 const std::string Uptime(unsigned long millis)
@@ -54,81 +56,42 @@ const std::string Uptime(unsigned long millis)
 	return uptime;
 }
 
+////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Add a line to the main log. The flash log is written from the main
+/// .. log by its own task (See MyFiles::StartLogWriter) so this never waits on flash
 std::string Logln(const char *msg, bool timePrefix)
 {
+	unsigned long start = micros();
 	std::string s = AddToLog(msg, timePrefix);
 #ifdef SERIAL_LOG
 	// perror(s.c_str());
 	Serial.print(s.c_str());
 	Serial.print("\r\n");
 #endif
-
-#ifdef LOG_TO_FLASH
-	if (!_handyTime.GotGoodTime())
-		return s;
-
-	// Start the log if we have a good time
-	if (!_processedFirstGoodTime)
-	{
-		_processedFirstGoodTime = true;
-		auto logCopy = CopyMainLog();
-		_myFiles.StartLogFile(&logCopy);
-	}
-
-	// Write to the log file
-	_myFiles.AppendLog(s.c_str());
-#endif
-
+	_metrics.Record(Metric::LogLineTime, 0, micros() - start);
 	return s;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////
-/// @brief Trim the log to the size limit
-const void TruncateLog(std::vector<std::string> &log)
+/// @brief Add a deferred record. Only formatted here if it goes to serial
+void Logln(const LogEncoder &record)
 {
-	// Truncate based on total log size
-	while (log.size() > MAX_LOG_LENGTH)
-		log.erase(log.begin());
+	unsigned long start = micros();
+	_mainLog.Add(record);
 
-	// Truncate based on total size
-	while (true)
-	{
-		int total = 0;
-		for (std::string line : log)
-			total += line.length();
-		if (total < MAX_LOG_SIZE)
-			break;
-		log.erase(log.begin());
-	}
+#ifdef SERIAL_LOG
+	char text[LOG_LINE_MAX + 1];
+	LogFormat(record.Data(), record.Length(), text, sizeof(text), LogClockWall);
+	Serial.print(text);
+	Serial.print("\r\n");
+#endif
+	_metrics.Record(Metric::LogLineTime, 0, micros() - start);
 }
 
 std::string AddToLog(const char *msg, bool timePrefix)
 {
-	std::string s;
 	std::string time = timePrefix ? _handyTime.LongString() : "\t\t";
-	if (xSemaphoreTake(_serialMutex, portMAX_DELAY))
-	{
-		// s = StringPrintf("%s %s", Uptime(millis()).c_str(), msg);
-		s = StringPrintf("%s %s", time.c_str(), msg);
-
-		if (_mainLog.capacity() < MAX_LOG_LENGTH)
-			_mainLog.reserve(MAX_LOG_LENGTH);
-
-		// Remove the oldest while too long
-		while (_mainLog.size() > MAX_LOG_LENGTH)
-			_mainLog.erase(_mainLog.begin());
-
-		// Add the first 127 characters of the message
-		if (s.length() > MAX_LOG_ROW_LENGTH)
-			_mainLog.push_back(s.substr(0, MAX_LOG_ROW_LENGTH) + "...");
-		else
-			_mainLog.push_back(s);
-
-		xSemaphoreGive(_serialMutex);
-	}
-	else
-	{
-		perror("AddToLog:Failed to take serial mutex\n");
-	}
+	std::string s = StringPrintf("%s %s", time.c_str(), msg);
+	_mainLog.Add(s);
 	return s;
 }
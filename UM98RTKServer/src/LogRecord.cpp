@@ -0,0 +1,193 @@
+#include "LogRecord.h"
+
+#include <stdarg.h>
+
+///////////////////////////////////////////////////////////////////////////////
+// Reads the parts of a record in order. Fails once past the end
+struct RecordReader
+{
+	const uint8_t *p;
+	const uint8_t *pEnd;
+
+	bool Get(void *pOut, size_t length)
+	{
+		if ((size_t)(pEnd - p) < length)
+			return false;
+		memcpy(pOut, p, length);
+		p += length;
+		return true;
+	}
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Text built in a fixed buffer. Always null terminated, cut when full
+struct TextOut
+{
+	char *p;
+	size_t size;
+	size_t used;
+
+	inline bool Full() const { return used + 1 >= size; }
+
+	void Put(char c)
+	{
+		if (Full())
+			return;
+		p[used++] = c;
+		p[used] = 0;
+	}
+
+	void Printf(const char *format, ...)
+	{
+		if (Full())
+			return;
+		va_list args;
+		va_start(args, format);
+		int length = vsnprintf(p + used, size - used, format, args);
+		va_end(args);
+		if (length > 0)
+			used = min(used + length, size - 1);
+	}
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Format one argument with the spec from the format string (Length
+// .. modifiers are dropped, the stored type decides)
+static void FormatArgument(TextOut &text, RecordReader &reader, char *spec, size_t specLength, char conversion)
+{
+	char tag;
+	if (!reader.Get(&tag, 1))
+	{
+		text.Put('?');
+		return;
+	}
+	switch (tag)
+	{
+	case 'i':
+	case 'u':
+	{
+		int32_t value = 0;
+		reader.Get(&value, sizeof(value));
+		spec[specLength++] = strchr("diouxXc", conversion) ? conversion : (tag == 'i' ? 'd' : 'u');
+		spec[specLength] = 0;
+		text.Printf(spec, value);
+		return;
+	}
+	case 'q':
+	case 'Q':
+	{
+		int64_t value = 0;
+		reader.Get(&value, sizeof(value));
+		spec[specLength++] = 'l';
+		spec[specLength++] = 'l';
+		spec[specLength++] = strchr("diouxX", conversion) ? conversion : (tag == 'q' ? 'd' : 'u');
+		spec[specLength] = 0;
+		text.Printf(spec, (long long)value);
+		return;
+	}
+	case 'f':
+	{
+		double value = 0;
+		reader.Get(&value, sizeof(value));
+		spec[specLength++] = strchr("fFeEgGaA", conversion) ? conversion : 'f';
+		spec[specLength] = 0;
+		text.Printf(spec, value);
+		return;
+	}
+	case 's':
+	{
+		uint8_t length = 0;
+		char value[LOG_STRING_MAX + 1];
+		reader.Get(&length, 1);
+		length = min(length, (uint8_t)LOG_STRING_MAX);
+		if (!reader.Get(value, length))
+			length = 0;
+		value[length] = 0;
+		spec[specLength++] = 's';
+		spec[specLength] = 0;
+		text.Printf(spec, value);
+		return;
+	}
+	case 'b':
+	{
+		uint8_t length = 0;
+		reader.Get(&length, 1);
+		for (int n = 0; n < length; n++)
+		{
+			uint8_t value;
+			if (!reader.Get(&value, 1))
+				break;
+			text.Printf("%02x ", value);
+		}
+		return;
+	}
+	default:
+		text.Put('?');
+		reader.p = reader.pEnd;
+		return;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Turn a record back into a log line
+size_t LogFormat(const uint8_t *pRecord, size_t length, char *pText, size_t size, LogClock clock)
+{
+	if (size == 0)
+		return 0;
+	pText[0] = 0;
+	TextOut text = {pText, size, 0};
+	RecordReader reader = {pRecord, pRecord + length};
+
+	uint32_t uptime;
+	uint32_t epoch;
+	const char *format;
+	int8_t source;
+	if (!reader.Get(&uptime, sizeof(uptime)) || !reader.Get(&epoch, sizeof(epoch)) ||
+		!reader.Get(&format, sizeof(format)) || !reader.Get(&source, sizeof(source)))
+		return 0;
+
+	// Same layout as HandyTime::LongString() once the clock is set
+	struct tm info;
+	time_t when = epoch;
+	if (clock == LogClockWall && epoch >= LOG_EPOCH_VALID && localtime_r(&when, &info) != nullptr)
+	{
+		text.Printf("%04d-%02d-%02d %02d:%02d:%02d ", info.tm_year + 1900, info.tm_mon + 1, info.tm_mday,
+					info.tm_hour, info.tm_min, info.tm_sec);
+	}
+	else
+	{
+		// Same layout as Uptime()
+		uint32_t t = uptime / 1000;
+		text.Printf("%u %02u:%02u:%02u.%03u ", t / 86400, t / 3600 % 24, t / 60 % 60, t % 60, uptime % 1000);
+	}
+	if (source != LOG_SOURCE_NONE)
+		text.Printf("NTRIP %d:", source);
+
+	for (const char *f = format; *f && !text.Full(); f++)
+	{
+		if (*f != '%')
+		{
+			text.Put(*f);
+			continue;
+		}
+		if (f[1] == '%')
+		{
+			text.Put('%');
+			f++;
+			continue;
+		}
+
+		// Flags, width and precision are kept. Room left for "ll" and the conversion
+		char spec[16] = "%";
+		size_t specLength = 1;
+		for (f++; *f && strchr("-+ #0123456789.", *f); f++)
+			if (specLength < sizeof(spec) - 4)
+				spec[specLength++] = *f;
+		while (*f && strchr("hlLqjzt", *f))
+			f++;
+		if (*f == 0)
+			break;
+		FormatArgument(text, reader, spec, specLength, *f);
+	}
+	return text.used;
+}
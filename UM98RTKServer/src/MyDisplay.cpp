@@ -11,6 +11,7 @@
 
 #include "HandyLog.h"
 #include "History.h"
+#include "Metrics.h"
 
 #include <iostream>
 #include <sstream>
@@ -111,19 +112,23 @@ void MyDisplay::SetPerformance(std::string performance)
 	return;
 }
 
-void MyDisplay::UpdateGpsStarts(bool restart, bool reinitialize)
+///////////////////////////////////////////////////////////////////////////
+// Show the GPS resets (Timeouts and reported resets) and reinitialisations
+void MyDisplay::RefreshGpsStarts()
 {
-	if (restart)
-		_gpsResetCount++;
-	if (reinitialize)
-		_gpsReinitialize++;
 	if (_currentPage == 2)
-		DrawML(StringPrintf("R : %d  I : %d", _gpsResetCount, _gpsReinitialize).c_str(), COL2_P0, R2F4, COL2_P0_W, 4);
+		DrawML(StringPrintf("R : %u  I : %u", _metrics.Get(Metric::GpsTimeouts) + _metrics.Get(Metric::GpsResets),
+							_metrics.Get(Metric::GpsReinitialise))
+				   .c_str(),
+			   COL2_P0, R2F4, COL2_P0_W, 4);
 }
-void MyDisplay::IncrementGpsPackets()
+
+///////////////////////////////////////////////////////////////////////////
+// Show the GPS packet count. Skipped in the busy half of the slow loop
+void MyDisplay::RefreshGpsPackets()
 {
 	if (!_slowLoopFirstHalf)
-		SetValue(0, (_gpsMsgCount + 1), &_gpsMsgCount, COL2_P0, R5F4, COL2_P0_W, 4);
+		SetValue(0, (int32_t)_metrics.Get(Metric::GpsPackets), &_gpsMsgCount, COL2_P0, R5F4, COL2_P0_W, 4);
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -203,9 +208,20 @@ void MyDisplay::RefreshRtk(int index)
 	int col = index == 0 ? COL2_P4 : COL3_P4;
 
 	DrawML(pServer->GetStatus(), col, R1F4, COL_W_P4, 4);
-	DrawMR(ToThousands(pServer->GetReconnects()).c_str(), col, R2F4, COL_W_P4, 4);
-	DrawMR(ToThousands(pServer->GetPacketsSent()).c_str(), col, R3F4, COL_W_P4, 4);
+	MetricSnapshot metrics;
+	_metrics.Snapshot(metrics);
+	DrawMR(ToThousands(metrics.Get(Metric::CasterReconnects, index)).c_str(), col, R2F4, COL_W_P4, 4);
+	DrawMR(ToThousands(metrics.Get(Metric::CasterPacketsSent, index)).c_str(), col, R3F4, COL_W_P4, 4);
 	DrawMR(ToThousands(_history.MedianSendTime(pServer->GetIndex())).c_str(), col, R4F4, COL_W_P4, 4);
+
+	// Health score with the breaker state when it is not closed
+	const CasterHealth &health = pServer->GetHealth();
+	std::string text = std::to_string(health.Score(millis()));
+	if (health.GetBreaker() == CasterHealth::Breaker::Open)
+		text = "Open";
+	else if (health.GetBreaker() == CasterHealth::Breaker::HalfOpen)
+		text = "Probe " + text;
+	DrawMR(text.c_str(), col, R5F4, COL_W_P4, 4);
 }
 
 void MyDisplay::RefreshRtkLog()
@@ -295,6 +311,7 @@ void MyDisplay::RefreshScreen()
 		DrawLabel("Reconnects", COL1, R2F4, 2);
 		DrawLabel("Sends", COL1, R3F4, 2);
 		DrawLabel("us", COL1, R4F4, 2);
+		DrawLabel("Health", COL1, R5F4, 2);
 		break;
 	case 2:
 		_bg = TFT_RED;
@@ -357,9 +374,9 @@ void MyDisplay::RefreshScreen()
 	// Redraw
 	_graphics.SetGpsConnected(_gpsConnected);
 
-	UpdateGpsStarts(false, false);
-	_gpsMsgCount--;
-	IncrementGpsPackets();
+	RefreshGpsStarts();
+	_gpsMsgCount = -1;
+	RefreshGpsPackets();
 
 	RefreshWiFiState();
 
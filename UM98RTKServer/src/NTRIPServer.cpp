@@ -1,37 +1,44 @@
 #include "NTRIPServer.h"
 
 #include <WiFi.h>
+#include <algorithm>
+#include <lwip/sockets.h>
 
 #include "HandyLog.h"
 #include <GpsParser.h>
 #include <MyFiles.h>
 #include "History.h"
+#include "DnsCache.h"
+#include "HandyTime.h"
+#include "Metrics.h"
+#include "NtripRequest.h"
 
 extern MyFiles _myFiles;
 extern History _history;
-
-// Progressive time out for reconnecting
-static const unsigned long WIFI_TIMEOUTS[] = {15000, 30000, 60000, 120000, 300000};
-static const int WIFI_TIMEOUT_SIZE = sizeof(WIFI_TIMEOUTS) / sizeof(WIFI_TIMEOUTS[0]);
+extern DnsCache _dnsCache;
 
 ///////////////////////////////////////////////////////////////////////////////
 // Constructor
 NTRIPServer::NTRIPServer(int index)
 	: _index(index),
-	  _logMutex(xSemaphoreCreateMutex()),
-	  _queMutex(xSemaphoreCreateMutex())
+	  _queMutex(xSemaphoreCreateMutex()),
+	  _snapshotMutex(xSemaphoreCreateMutex())
 {
-	_wifiConnectTime = 10000 - WIFI_TIMEOUTS[_timeOutIndex]; // Start the connection process after 10 seconds
+	_sendBatch.reserve(NTRIP_SEND_MAX_FRAMES);
 
 	// Check mutexs
-	if (_logMutex == nullptr)
-		perror("Failed to create log mutex\n");
-	else
-		Serial.printf("Log %d Mutex Created\r\n", index);
 	if (_queMutex == nullptr)
 		perror("Failed to create queue mutex\n");
 	else
 		Serial.printf("Queue %d Mutex Created\r\n", index);
+	if (_snapshotMutex == nullptr)
+		perror("Failed to create snapshot mutex\n");
+
+	// Shown until the caster task publishes (A disabled caster never does)
+	_snapshot.Status = "Unknown";
+	_snapshot.Breaker = _health.BreakerText();
+	_snapshot.QuotaStatus = "No quota";
+	_snapshot.SendBufferSize = -1;
 }
 
 static void TaskWrapper(void *param)
@@ -41,17 +48,26 @@ static void TaskWrapper(void *param)
 	instance->TaskFunction();
 }
 
+static void StandbyTaskWrapper(void *param)
+{
+	static_cast<NTRIPServer *>(param)->StandbyTaskFunction();
+}
+
 //////////////////////////////////////////////////////////////////////////////
 // Load the configurations if they exist
 void NTRIPServer::LoadSettings()
 {
+	// The first call is from setup() before the caster task starts
+	if (_logHistory.GetArenaSize() == 0 && !_logHistory.Allocate(LogArenaSize(LOG_ARENA_CASTER)))
+		LogError(LogNtripModule(_index), "E111 - No memory for the caster log");
+
 	std::string fileName = StringPrintf("/Caster%d.txt", _index);
 
 	// Read the server settings from the config file
 	std::string llText;
 	if (_myFiles.ReadFile(fileName.c_str(), llText))
 	{
-		LogX(StringPrintf(" - Read config [%d] '%s'", llText.length(), llText.c_str()));
+		LogDebug(LogNtripModule(_index), " - Read config [%d] '%s'", (int)llText.length(), llText);
 		auto parts = Split(llText, "\n");
 		if (parts.size() > 3)
 		{
@@ -59,30 +75,56 @@ void NTRIPServer::LoadSettings()
 			_port = atoi(parts[1].c_str());
 			_sCredential = parts[2];
 			_sPassword = parts[3];
-			LogX(StringPrintf(" - Recovered\r\n\t Address  : '%s'\r\n\t Port     : %d\r\n\t Mpt/Cred : '%s'\r\n\t Pass     : '%s'", _sAddress.c_str(), _port, _sCredential.c_str(), _sPassword.c_str()));
+			_ntripVersion = (parts.size() > 4 && atoi(parts[4].c_str()) == 2) ? 2 : 1;
+			_sUser = parts.size() > 5 ? parts[5] : "";
+			_tuning.FromString(parts.size() > 6 ? parts[6] : "");
+			_sendBudget = _tuning.SendBudget > 0 ? min(_tuning.SendBudget, NTRIP_SEND_BUDGET_MAX) : NTRIP_SEND_BUDGET;
+			_sStandby = parts.size() > 7 ? parts[7] : "";
+			_tls = parts.size() > 8 && atoi(parts[8].c_str()) == 1;
+			LoadDeadlines(parts.size() > 9 ? parts[9] : "");
+			_quota.FromString(parts.size() > 10 ? parts[10] : "");
+			_sTlsPin = parts.size() > 11 ? parts[11] : "";
+			// Two records as each holds LOG_RECORD_MAX bytes of arguments
+			LogInfo(LogNtripModule(_index), " - Recovered\r\n\t Address  : '%s'\r\n\t Port     : %d\r\n\t Mpt/Cred : '%s'\r\n\t Pass     : '%s'\r\n\t Protocol : NTRIP %d.0\r\n\t User     : '%s'",
+					_sAddress, _port, _sCredential, _sPassword, _ntripVersion, _sUser);
+			LogInfo(LogNtripModule(_index), " - Recovered\r\n\t Socket   : %s\r\n\t Standby  : '%s'\r\n\t TLS      : %s %s\r\n\t Deadline : %s\r\n\t Quota    : %s",
+					_tuning.ToString(), _sStandby, _tls ? "Yes" : "No", _sTlsPin.empty() ? "" : "(Pinned)", GetDeadlines(), _quota.ToString());
 		}
 		else
 		{
-			LogX(StringPrintf(" - E341 - Cannot read saved Server settings %s", llText.c_str()));
+			LogError(LogNtripModule(_index), " - E341 - Cannot read saved Server settings %s", llText);
 		}
 	}
 	else
 	{
-		LogX(StringPrintf(" - E342 - Cannot read saved Server setting %s", fileName.c_str()));
+		LogError(LogNtripModule(_index), " - E342 - Cannot read saved Server setting %s", fileName);
+	}
+
+	// Byte counters survive reboots. Only read once as settings are reloaded on save
+	if (!_usageLoaded)
+	{
+		std::string usage;
+		if (_myFiles.ReadFile(StringPrintf("/Usage%d.txt", _index).c_str(), usage))
+			_bandwidth.FromString(usage);
+		_usageLoaded = true;
 	}
 
 	// Don't start thread if disabled
 	if (_port < 1 || _sAddress.length() < 1)
 	{
-		LogX(StringPrintf(" - E343 - Server %d is disabled", _index));
+		LogWarn(LogNtripModule(_index), " - E343 - Server %d is disabled", _index);
 		_status = ConnectionState::Disabled;
+
+		// No caster task to publish the state for the web pages
+		if (_connectingTask == NULL)
+			PublishSnapshot();
 		return;
 	}
 
 	// Check the index is valid
 	if (_index > RTK_SERVERS)
 	{
-		LogX(StringPrintf("E501 - RTK Server index %d too high", index));
+		LogError(LogMain, "E501 - RTK Server index %d too high", _index);
 		return;
 	}
 
@@ -90,21 +132,188 @@ void NTRIPServer::LoadSettings()
 	xTaskCreatePinnedToCore(
 		TaskWrapper,
 		StringPrintf("NtripSvrTask%d", index).c_str(), // Task name
-		5000,										   // Stack size (bytes)
+		_tls ? NTRIP_TLS_TASK_STACK : NTRIP_TASK_STACK, // Stack size (bytes)
 		this,										   // Parameter
 		1,											   // Task priority
 		&_connectingTask,							   // Task handle
 		APP_CPU_NUM);
 }
 
+//////////////////////////////////////////////////////////////////////////////
+// Read the freshness deadlines from "station,msm,other" in ms
+// .. Missing or zero values use the defaults
+void NTRIPServer::LoadDeadlines(const std::string &text)
+{
+	static const unsigned long DEFAULTS[RtcmClassCount] = {NTRIP_DEADLINE_STATION_MS, NTRIP_DEADLINE_MSM_MS, NTRIP_DEADLINE_OTHER_MS};
+	auto parts = Split(text, ",");
+	for (int n = 0; n < RtcmClassCount; n++)
+	{
+		int value = n < parts.size() ? atoi(parts[n].c_str()) : 0;
+		_deadlines[n] = value > 0 ? value : DEFAULTS[n];
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Deadlines in the config file format
+const std::string NTRIPServer::GetDeadlines() const
+{
+	return StringPrintf("%lu,%lu,%lu", _deadlines[RtcmClassStation], _deadlines[RtcmClassMsm], _deadlines[RtcmClassOther]);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Roll the rolling byte rates, follow the calendar and apply the quota
+// .. The counters are saved rarely as the flash wears with every write
+void NTRIPServer::ServiceBandwidth()
+{
+	// Bytes the standby task counted (Only this task writes the meter)
+	_bandwidth.AddSent(_standbySent.exchange(0, std::memory_order_relaxed));
+	_bandwidth.AddReceived(_standbyReceived.exchange(0, std::memory_order_relaxed));
+
+	unsigned long now = millis();
+	if (!_bandwidth.Tick(now))
+		return;
+
+	struct tm info;
+	if (_handyTime.GotGoodTime() && _handyTime.ReadTime(&info))
+		_bandwidth.SetDate(info);
+
+	QuotaState state = QuotaState::Normal;
+	if (_bandwidth.IsOverQuota(_quota))
+		state = _quota.Pause ? QuotaState::Paused : QuotaState::Reduced;
+	if (state != _quotaState)
+	{
+		_quotaState = state;
+		if (state == QuotaState::Normal)
+		{
+			LogInfo(LogNtripModule(_index), "RTK %s Quota clear. Full uploads resumed", _sAddress);
+		}
+		else
+		{
+			LogError(LogNtripModule(_index), "E509 - RTK %s Quota used (Day %lluKB, month %lluKB). %s", _sAddress,
+					 _bandwidth.GetDaySent() / 1024, _bandwidth.GetMonthSent() / 1024, GetQuotaStatus());
+
+			// Paused uploads don't need the connections
+			if (state == QuotaState::Paused)
+			{
+				_client.stop();
+				StopStandby();
+				_wasConnected = false;
+				if (_status == ConnectionState::Connected)
+					_status = ConnectionState::Disconnected;
+			}
+		}
+		SaveUsage();
+	}
+
+	if (_bandwidth.IsDirty() && (now - _lastUsageSave) > NTRIP_USAGE_SAVE_MS)
+		SaveUsage();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Write the byte counters to flash
+void NTRIPServer::SaveUsage()
+{
+	_lastUsageSave = millis();
+	_myFiles.WriteFile(StringPrintf("/Usage%d.txt", _index).c_str(), _bandwidth.ToString().c_str());
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// What the quota is doing to uploads
+const char *NTRIPServer::GetQuotaStatus() const
+{
+	switch (_quotaState)
+	{
+	case QuotaState::Reduced:
+		return "Over quota. Reduced messages";
+	case QuotaState::Paused:
+		return "Over quota. Paused";
+	default:
+		return _quota.IsSet() ? "Under quota" : "No quota";
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Copy the state shown on the web pages. Only called from the caster task
+void NTRIPServer::PublishSnapshot()
+{
+	unsigned long now = millis();
+
+	// The overflow drops are counted by the GPS task as it queues
+	unsigned long classDrops[RtcmClassCount];
+	if (!xSemaphoreTake(_queMutex, portMAX_DELAY))
+		return;
+	memcpy(classDrops, _classDrops, sizeof(classDrops));
+	xSemaphoreGive(_queMutex);
+
+	if (!xSemaphoreTake(_snapshotMutex, portMAX_DELAY))
+		return;
+	_snapshot.Status = GetStatus();
+	strlcpy(_snapshot.RejectReason, _rejectReason, sizeof(_snapshot.RejectReason));
+	_snapshot.RejectedAt = _rejectedAt;
+	_snapshot.Rejected = _status == ConnectionState::Rejected;
+	_snapshot.HealthScore = _health.Score(now);
+	_snapshot.Breaker = _health.BreakerText();
+	_snapshot.NextRetryMs = _health.WaitTime(now);
+	memcpy(_snapshot.ClassDrops, classDrops, sizeof(classDrops));
+	memcpy(_snapshot.Expired, _expiredByClass, sizeof(_expiredByClass));
+	_snapshot.TotalTimeouts = _totalTimeouts;
+	_snapshot.MaxSendTime = _maxSendTime;
+	_snapshot.TotalWrites = _totalWrites;
+	_snapshot.WritesPerSecond = (now - _writeSecondStart) > 2000 ? 0 : _writesPerSecond;
+	_snapshot.BytesPerWrite = _totalBytesSent / max(_totalWrites, 1UL);
+	_snapshot.LastCatchUpTime = _lastCatchUpTime;
+	_snapshot.MaxCatchUpTime = _maxCatchUpTime;
+	_snapshot.WouldBlocks = _wouldBlocks;
+	_snapshot.BlockedTime = _blockedTime;
+	_snapshot.SendBufferSize = _sendBufferSize;
+	strlcpy(_snapshot.ActiveHost, _activeHost.c_str(), sizeof(_snapshot.ActiveHost));
+	_snapshot.StandbyReady = _standbyState.load() == StandbyState::Ready;
+	_snapshot.Failovers = _failovers;
+	_snapshot.LastFailoverTime = _lastFailoverTime;
+	_snapshot.HandshakeTime = _client.GetHandshakeTime();
+	_snapshot.ResumedHandshakes = _client.GetResumedHandshakes();
+	_snapshot.FullHandshakes = _client.GetFullHandshakes();
+	_snapshot.TlsHeapUsed = _client.GetHeapUsed();
+	_snapshot.EncryptMicrosPerKb = _client.GetEncryptMicrosPerKb();
+	_snapshot.TotalSent = _bandwidth.GetTotalSent();
+	_snapshot.TotalReceived = _bandwidth.GetTotalReceived();
+	_snapshot.DaySent = _bandwidth.GetDaySent();
+	_snapshot.MonthSent = _bandwidth.GetMonthSent();
+	_snapshot.Rate1s = _bandwidth.GetRate1s();
+	_snapshot.Rate1m = _bandwidth.GetRate1m();
+	_snapshot.Rate1h = _bandwidth.GetRate1h();
+	_snapshot.QuotaStatus = GetQuotaStatus();
+	_snapshot.QuotaDrops = _quotaDrops;
+	_snapshot.MaxStackHeight = _maxStackHeight;
+	_snapshot.StandbyStackHeight = _standbyStackHeight.load();
+	strlcpy(_snapshot.TlsFingerprint, _client.GetFingerprint().c_str(), sizeof(_snapshot.TlsFingerprint));
+	_snapshot.Time = max(now, 1UL);
+	xSemaphoreGive(_snapshotMutex);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Copy of the last published state. Safe from any task
+void NTRIPServer::GetSnapshot(CasterSnapshot &snapshot) const
+{
+	if (xSemaphoreTake(_snapshotMutex, portMAX_DELAY))
+	{
+		snapshot = _snapshot;
+		xSemaphoreGive(_snapshotMutex);
+	}
+}
+
 //////////////////////////////////////////////////////////////////////////////
 // Save the setting to the file
-void NTRIPServer::Save(const char *address, const char *port, const char *credential, const char *password)
+void NTRIPServer::Save(const char *address, const char *port, const char *credential, const char *password, const char *protocol, const char *user, const char *tuning, const char *standby, const char *transport, const char *tlsPin, const char *deadlines, const char *quota)
 {
-	std::string llText = StringPrintf("%s\n%s\n%s\n%s", address, port, credential, password);
+	std::string llText = StringPrintf("%s\n%s\n%s\n%s\n%s\n%s\n%s\n%s\n%s\n%s\n%s\n%s", address, port, credential, password, protocol, user, tuning, standby, transport, deadlines, quota, tlsPin);
 	std::string fileName = StringPrintf("/Caster%d.txt", _index);
 	_myFiles.WriteFile(fileName.c_str(), llText.c_str());
 
+	// New settings may fix a rejected login
+	if (_status == ConnectionState::Rejected)
+		_status = ConnectionState::Disconnected;
+
 	LoadSettings(); // Reload the settings after saving
 
 	_forceReconnect = true; // Force a reconnect to use the new settings
@@ -118,9 +327,15 @@ void NTRIPServer::TaskFunction()
 	Serial.printf("+++++ NTRIP Server %d Starting\r\n", _index);
 	while (true)
 	{
-		// Get the next item from the queue
-		QueueData *pItem = DequeueData();
-		if (pItem == nullptr)
+		// Roll the byte rates and check the quota
+		ServiceBandwidth();
+		_queueLatency.Rotate(millis());
+		if (millis() - _snapshot.Time >= NTRIP_SNAPSHOT_MS)
+			PublishSnapshot();
+
+		// Gather the next items from the queue
+		int remaining = DequeueBatch(_sendBatch);
+		if (_sendBatch.empty())
 		{
 			// No data to send so wait 2ms before trying again
 			vTaskDelay(2 / portTICK_PERIOD_MS);
@@ -135,85 +350,146 @@ void NTRIPServer::TaskFunction()
 			//Serial.printf("%d) Stack %d\r\n", _index, _maxStackHeight);
 		}
 
+		// Hand over to the standby if the connection dropped between writes
+		// .. Read any parting words first as a refusal should not fail over
+		if (!_client.connected())
+		{
+			ConnectedProcessingReceive();
+			if (_status != ConnectionState::Rejected)
+				Failover("Connection lost", millis());
+		}
+
 		// Wifi check interval
 		if (_client.connected())
 		{
-			ConnectedProcessing(pItem->getData(), pItem->getLength());
+			ConnectedProcessing(_sendBatch, remaining);
 		}
 		else
 		{
 			vTaskDelay(200 / portTICK_PERIOD_MS);
+
+			// Let the health tracker decide how soon to retry
+			if (_wasConnected)
+				_health.OnDisconnect(millis());
 			_wasConnected = false;
-			_status = ConnectionState::Disconnected;
-			Reconnect();
+
+			// Try a refused caster again after a long wait in case it was fixed at their end
+			if (_status == ConnectionState::Rejected && (millis() - _rejectedAt) > NTRIP_REJECT_BACKOFF_MS)
+			{
+				LogInfo(LogNtripModule(_index), "RTK %s Retrying after rejection '%s'", _sAddress, _rejectReason);
+				_status = ConnectionState::Disconnected;
+				_health.RetryNow(millis());
+			}
+
+			// Don't retry a caster that refused us till the wait is over or the settings change
+			if (_status != ConnectionState::Rejected)
+			{
+				_status = ConnectionState::Disconnected;
+				Reconnect();
+			}
 		}
 
-		// Delete the item
-		delete pItem;
+		// Delete the items
+		for (auto pItem : _sendBatch)
+			delete pItem;
+		_sendBatch.clear();
 	}
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 // Process the data when connected
-void NTRIPServer::ConnectedProcessing(const byte *pBytes, int length)
+void NTRIPServer::ConnectedProcessing(const std::vector<QueueData *> &batch, int remaining)
 {
 	if (!_wasConnected)
 	{
-		_reconnects++;
+		_metrics.Add(Metric::CasterReconnects, _index, 1);
 		_status = ConnectionState::Connected;
 		_wasConnected = true;
+		_afterReconnect = true;
 	}
 
 	// Send what we have received
-	ConnectedProcessingSend(pBytes, length);
+	ConnectedProcessingSend(batch, remaining);
 
 	// Check for new data (Not expecting much)
 	ConnectedProcessingReceive();
+
+	// Have the standby ready for when this connection fails
+	MaintainStandby();
 }
 
 //////////////////////////////////////////////////////////////////////////////
-// Send the data to the RTK Caster
-void NTRIPServer::ConnectedProcessingSend(const byte *pBytes, int length)
+// Send the gathered items to the RTK Caster in a single write
+// .. remaining is the number of items still waiting in the queue
+void NTRIPServer::ConnectedProcessingSend(const std::vector<QueueData *> &batch, int remaining)
 {
+	// Build the gather list. NTRIP 2.0 sends the whole write as one HTTP chunk
+	SendGather gather;
+	gather.Build(batch, _ntripVersion == 2);
+
 	// Skip if we have no data
-	if (length < 1)
+	if (gather.Length < 1)
 		return;
 
 	// Check for a forced reconnect
 	if (_forceReconnect)
 	{
 		_forceReconnect = false;
-		LogX(StringPrintf("RTK %s Reconnecting due to forced reconnect", _sAddress.c_str()));
+		LogInfo(LogNtripModule(_index), "RTK %s Reconnecting due to forced reconnect", _activeHost);
 		_client.stop();
+		StopStandby();
+		_activeHost.clear();
+		_health.RetryNow(millis());
+		_wasConnected = false;
 		_status = ConnectionState::Disconnected;
 		return;
 	}
 
+	// Start timing a backlog only after a stall. Frames left over from a
+	// .. normal epoch burst are not a backlog
+	if (_catchUpStart == 0 && remaining > 0 && (_queue.IsBackedUp() || _afterReconnect))
+		_catchUpStart = max(millis(), 1UL);
+	_afterReconnect = false;
+
 	// Send and record time
+	unsigned long startMs = millis();
 	unsigned long startT = micros();
-	int sent = _client.write(pBytes, length);
+	size_t sent = WriteGather(gather);
+	int errorCode = errno;
 
 	// Record the time delay and max write time
 	unsigned long time = micros() - startT;
+	_bandwidth.AddSent(sent);
+	_metrics.Add(Metric::CasterBytesSent, _index, sent);
 
-	if (sent != length)
+	if (sent != gather.WireLength)
 	{
 		// Send failed so record the failure and start the reconnect process
-		LogX(StringPrintf("E500 - %s Only sent %d of %d (%dms)",
-						  _sAddress.c_str(),
-						  sent,
-						  length,
-						  time / 1000));
+		LogError(LogNtripModule(_index), "E500 - %s Only sent %d of %d in %d frames (%dms)",
+				 _activeHost.c_str(),
+				 (int)sent,
+				 (int)gather.WireLength,
+				 gather.Frames,
+				 time / 1000);
+
+		const char *errorMsg = strerror(errorCode);
 
-		int errorCode = errno;
-		const char *errorMsg = strerror(errno);
-		// LogX(StringPrintf(" --- Error: %d - %s", errorCode, errorMsg));
+		_health.OnWrite(false, time, millis());
+
+		// Promote the standby and resend rather than waiting on this host
+		if (Failover(errorMsg, startMs))
+		{
+			ConnectedProcessingSend(batch, remaining);
+			return;
+		}
 
-		if (errorCode == EWOULDBLOCK)
+		// Only retry if nothing was sent. A part frame on the wire can only be fixed by reconnecting
+		if (errorCode == EWOULDBLOCK && sent == 0)
 		{
-			LogX(StringPrintf(" --- Socket would block - buffer full. Try %d", _consecutiveTimeouts));
+			LogWarn(LogNtripModule(_index), " --- Socket would block - buffer full. Try %d", _consecutiveTimeouts);
 			_totalTimeouts++;
 			vTaskDelay(100 / portTICK_PERIOD_MS);
+			_blockedTime += 100;
 			_consecutiveTimeouts++;
 			if (_consecutiveTimeouts < 3)
 				return;
@@ -221,33 +497,71 @@ void NTRIPServer::ConnectedProcessingSend(const byte *pBytes, int length)
 		_consecutiveTimeouts = 0;
 
 		// Check specific error conditions
-		if (errorCode == ENOTCONN)
-			LogX(" --- Socket not connected");
+		if (sent > 0)
+			LogWarn(LogNtripModule(_index), " --- Partial frame written");
+		else if (errorCode == ENOTCONN)
+			LogWarn(LogNtripModule(_index), " --- Socket not connected");
 		else if (errorCode == EWOULDBLOCK)
-			LogX(" --- Socket would block - buffer full");
+			LogWarn(LogNtripModule(_index), " --- Socket would block - buffer full");
 		else if (errorCode == ECONNRESET)
-			LogX(" --- Connection reset by peer");
+			LogWarn(LogNtripModule(_index), " --- Connection reset by peer");
 		else if (errorCode == ETIMEDOUT)
-			LogX(" --- Connection timed out");
-		else if (errorCode == ENOTCONN)
-			LogX(" --- Socket not connected");
+			LogWarn(LogNtripModule(_index), " --- Connection timed out");
 		else if (errorCode == EPIPE)
-			LogX(" --- Broken pipe - connection closed by peer");
+			LogWarn(LogNtripModule(_index), " --- Broken pipe - connection closed by peer");
 		else if (errorCode == EINVAL)
-			LogX(" --- Invalid argument - check socket options");
+			LogWarn(LogNtripModule(_index), " --- Invalid argument - check socket options");
 		else
-			LogX(StringPrintf(" --- Error: %d - %s", errorCode, errorMsg));
+			LogWarn(LogNtripModule(_index), " --- Error: %d - %s", errorCode, errorMsg);
 
 		_client.stop();
 		_status = ConnectionState::Disconnected;
+		_catchUpStart = 0;
 	}
 	else
 	{
 		// Good send so clear the timeout count and record the time
 		_consecutiveTimeouts = 0;
-		_wifiConnectTime = millis();
-		_packetsSent++;
-		_timeOutIndex = 0;
+		_metrics.Add(Metric::CasterPacketsSent, _index, gather.Frames);
+		_health.OnWrite(true, time, millis());
+		LogVerbose(LogNtripModule(_index), "Sent %d frames %d bytes in %luus", gather.Frames, (int)gather.WireLength, time);
+
+		// Report how long the mount point was dark after a failover
+		if (_failoverStart != 0)
+		{
+			_lastFailoverTime = millis() - _failoverStart;
+			_failoverStart = 0;
+			LogInfo(LogNtripModule(_index), "Failover to %s complete in %lums", _activeHost, _lastFailoverTime);
+		}
+
+		// Record how long each frame waited from enqueue till on the wire
+		unsigned long now = micros();
+		for (auto pItem : batch)
+		{
+			_queueLatency.Record(now - pItem->getQueuedMicros());
+			_metrics.Record(Metric::CasterQueueLatency, _index, now - pItem->getQueuedMicros());
+		}
+
+		// Record write counts and size
+		_totalWrites++;
+		_totalBytesSent += gather.WireLength;
+		if ((millis() - _writeSecondStart) >= 1000)
+		{
+			_writesPerSecond = _writesThisSecond;
+			_writesThisSecond = 0;
+			_writeSecondStart = millis();
+		}
+		_writesThisSecond++;
+
+		// Record how long it took to drain the backlog
+		if (remaining == 0 && _catchUpStart != 0)
+		{
+			_lastCatchUpTime = millis() - _catchUpStart;
+			_maxCatchUpTime = max(_maxCatchUpTime, _lastCatchUpTime);
+			_catchUpStart = 0;
+			if (_lastCatchUpTime > 1000)
+				LogBLocal("Caught up after %lums", _lastCatchUpTime);
+		}
 
 		// Record max send time
 		if (_maxSendTime == 0)
@@ -255,128 +569,448 @@ void NTRIPServer::ConnectedProcessingSend(const byte *pBytes, int length)
 		else
 			_maxSendTime = max(_maxSendTime, time);
 
-		// Logf("RTK %s Sent %d OK", _sAddress.c_str(), sent);
 		//_sendMicroSeconds.push_back(sent * 8 * 1000 / max(1UL, time));
 		_history.AddNtripSendTime(_index, (int)time);
+		_metrics.Record(Metric::CasterSendTime, _index, time);
+
+		// Smooth the write time used to drop frames that cannot make their deadline
+		_sendEstimateUs = (_sendEstimateUs * 7 + time) / 8;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Write the gather list in one call, resuming after any partial writes
+// .. Returns the number of bytes written. errno holds the reason when short
+size_t NTRIPServer::WriteGather(SendGather &gather)
+{
+	size_t total = 0;
+	int stalls = 0; // Would block count once the stream has started
+	while (total < gather.WireLength && gather.Left() > 0)
+	{
+		unsigned long writeStart = millis();
+		ssize_t written = _client.Writev(gather.Next(), gather.Left());
+		if (written < 0 && errno == EWOULDBLOCK)
+		{
+			_wouldBlocks++;
+			_blockedTime += millis() - writeStart;
+		}
+		if (written <= 0)
+		{
+			// Give a started write a few chances to finish so we don't split a frame
+			if (written < 0 && errno == EWOULDBLOCK && total > 0 && stalls++ < 3)
+			{
+				vTaskDelay(10 / portTICK_PERIOD_MS);
+				_blockedTime += 10;
+				continue;
+			}
+			break;
+		}
+		total += written;
+		gather.Consume(written);
 	}
+	return total;
 }
 
 //////////////////////////////////////////////////////////////////////////////
 // This is usually welcome messages and errors
+// .. A refusal stops the uploads rather than streaming to a caster that discards them
 void NTRIPServer::ConnectedProcessingReceive()
 {
-	// Read the data
-	int buffSize = _client.available();
-	if (buffSize < 1)
-		return;
-
-	buffSize = min(buffSize, SOCKET_IN_BUFFER_MAX);
-
-	std::unique_ptr<byte[]> buffer(new byte[buffSize + 1]);
-	auto _pSocketBuffer = buffer.get();
-	_client.read(_pSocketBuffer, buffSize);
-
-	_pSocketBuffer[buffSize] = 0;
-
-	// Log the data
-	LogX("RECV. " + _sAddress + "\r\n" + HexAsciDump(_pSocketBuffer, buffSize));
+	auto result = ReceiveReply(_client, _reply, _activeHost);
+	if (result == CasterReply::Result::Rejected)
+	{
+		Reject(_activeHost, _reply.GetReason());
+	}
+	else if (result == CasterReply::Result::Failed)
+	{
+		LogError(LogNtripModule(_index), "E503 - %s Upload refused '%s'", _activeHost, _reply.GetReason());
+		_client.stop();
+		_status = ConnectionState::Disconnected;
+	}
 }
 
-///////////////////////////////////////////////////////////////////////////////
-// Write to the debug log and keep the last few messages for display
-void NTRIPServer::LogX(std::string text, bool dualLog)
+//////////////////////////////////////////////////////////////////////////////
+// Read what the caster has sent into the receive buffer and parse the lines
+// .. Stops at the first refusal. Returns the last line that decided anything
+CasterReply::Result NTRIPServer::ReceiveReply(CasterLink &client, CasterReply &reply, const std::string &host)
 {
-	if (dualLog)
-		Logln(StringPrintf("NTRIP %d:%s", _index, text.c_str()).c_str());
+	CasterReply::Result result = CasterReply::Result::None;
+	int length = client.available();
+	if (length < 1)
+		return result;
 
-	auto s = Uptime(millis()) + " " + text;
-	if (xSemaphoreTake(_logMutex, portMAX_DELAY))
+	// The standby task has its own buffer and leaves the meter to the caster task
+	bool standby = &client == &_standby;
+	byte *pBuffer = standby ? _standbyBuffer : _receiveBuffer;
+	length = client.read(pBuffer, min(length, SOCKET_IN_BUFFER_MAX));
+	if (length > 0)
 	{
-		_logHistory.push_back(s);
-		TruncateLog(_logHistory);
-		xSemaphoreGive(_logMutex);
+		if (standby)
+			_standbyReceived.fetch_add(length, std::memory_order_relaxed);
+		else
+			_bandwidth.AddReceived(length);
+		_metrics.Add(Metric::CasterBytesReceived, _index, length);
 	}
-	else
+
+	for (int n = 0; n < length; n++)
 	{
-		perror("LogX:Failed to take log mutex\n");
+		if (!reply.Add(pBuffer[n]))
+			continue;
+		LogInfo(LogNtripModule(_index), "RECV. %s <- '%s'", host, reply.GetLine());
+		if (reply.GetResult() == CasterReply::Result::None)
+			continue;
+		result = reply.GetResult();
+		if (result != CasterReply::Result::Accepted)
+			break;
 	}
+	return result;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// The caster refused the upload. Drop both connections and suspend uploads
+void NTRIPServer::Reject(const std::string &host, const char *reason)
+{
+	LogError(LogNtripModule(_index), "E502 - %s Rejected '%s'. Uploads suspended for %d minutes", host, reason, NTRIP_REJECT_BACKOFF_MS / 60000);
+	strncpy(_rejectReason, reason, CASTER_REPLY_LINE_MAX);
+	_rejectedAt = max(millis(), 1UL);
+	_status = ConnectionState::Rejected;
+	_client.stop();
+	StopStandby();
+	_activeHost.clear();
+	_failoverStart = 0;
+	_wasConnected = false;
 }
 
 ////////////////////////////////////////////////////////////////////////////
 // Get a copy of the log safely
 std::vector<std::string> NTRIPServer::GetLogHistory()
 {
-	std::vector<std::string> copyVector;
-	if (xSemaphoreTake(_logMutex, portMAX_DELAY))
-	{
-		copyVector.insert(copyVector.end(), _logHistory.begin(), _logHistory.end());
-		xSemaphoreGive(_logMutex);
-	}
-	else
-	{
-		perror("CopyMainLog:Failed to take log mutex\n");
-	}
-	return copyVector;
+	return _logHistory.Copy();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 bool NTRIPServer::Reconnect()
 {
+	// Don't use up retries while there is no WiFi
+	if (WiFi.status() != WL_CONNECTED)
+		return false;
+
 	// Limit how soon the connection is retried
-	if ((millis() - _wifiConnectTime) < WIFI_TIMEOUTS[_timeOutIndex])
+	if (!_health.CanAttempt(millis()))
 		return false;
 
-	// Get next timeout period
-	_timeOutIndex++;
-	if (_timeOutIndex >= WIFI_TIMEOUT_SIZE)
-		_timeOutIndex = WIFI_TIMEOUT_SIZE - 1;
+	// Start with the configured host after everything has dropped
+	if (_activeHost.empty())
+		_activeHost = _sAddress;
+	bool ok = OpenConnection(_client, _reply, MakeLogin(_activeHost), NTRIP_RESOLVE_TIMEOUT_MS);
 
-	_wifiConnectTime = millis();
+	// A refusal suspends uploads rather than counting against the health
+	if (!ok && _reply.GetResult() == CasterReply::Result::Rejected)
+	{
+		Reject(_activeHost, _reply.GetReason());
+		return false;
+	}
 
-	// Start the connection process
-	LogX(StringPrintf("RTK Connecting to %s : %d", _sAddress.c_str(), _port));
+	auto breaker = _health.GetBreaker();
+	_health.OnConnectResult(ok, millis());
+	if (!ok)
+	{
+		if (breaker != CasterHealth::Breaker::Open && _health.GetBreaker() == CasterHealth::Breaker::Open)
+			LogError(LogNtripModule(_index), "E507 - %s Circuit breaker open after %d failures", _sAddress, _health.GetFailures());
+		LogInfo(LogNtripModule(_index), "RTK %s Next try in %lus", _sAddress, _health.WaitTime(millis()) / 1000);
+	}
+	return ok;
+}
 
-	int status = _client.connect(_sAddress.c_str(), _port);
-	LogX(StringPrintf("RTK %s Connect status %d", _sAddress.c_str(), status));
+////////////////////////////////////////////////////////////////////////////////
+// Copy the settings for a connection to host. Call from the caster task
+CasterLogin NTRIPServer::MakeLogin(const std::string &host) const
+{
+	CasterLogin login;
+	login.Host = host;
+	login.Port = _port;
+	login.Credential = _sCredential;
+	login.Password = _sPassword;
+	login.User = _sUser;
+	login.NtripVersion = _ntripVersion;
+	login.Tls = _tls;
+	login.TlsPin = _sTlsPin;
+	login.Tuning = _tuning;
+	return login;
+}
 
-	// [ 30824][E][WiFiClient.cpp:320] setSocketOption(): fail on -1, errno: 9, "Bad file number"
-	_client.setNoDelay(true); // This results in 0.5s latency when RTK2GO.com is skipped?
-	if (!_client.connected())
+////////////////////////////////////////////////////////////////////////////////
+// Resolve, connect and authenticate a connection to the caster host
+bool NTRIPServer::OpenConnection(CasterLink &client, CasterReply &reply, const CasterLogin &login, unsigned long resolveTimeoutMs)
+{
+	const std::string &host = login.Host;
+	reply.Reset();
+
+	// Start the connection process
+	LogInfo(LogNtripModule(_index), "RTK Connecting to %s : %d", host, login.Port);
+
+	// Get the address from the cache. Only waits if it was never resolved
+	unsigned long phaseStart = millis();
+	IPAddress address;
+	if (!_dnsCache.Lookup(host, address, resolveTimeoutMs))
 	{
-		LogX(StringPrintf("E500 - RTK %s Not connected %d. (%dms)", _sAddress.c_str(), status, millis() - _wifiConnectTime));
+		LogError(LogNtripModule(_index), "E504 - RTK %s Cannot resolve address. (%lums)", host, millis() - phaseStart);
 		return false;
 	}
-	auto s = StringPrintf("Connected %s OK. (%dms)", _sAddress.c_str(), millis() - _wifiConnectTime);
-	LogX(s);
-	Logln(s.c_str());
+	unsigned long resolveTime = millis() - phaseStart;
 
-	if (!WriteText(StringPrintf("SOURCE %s %s\r\n", _sPassword.c_str(), _sCredential.c_str()).c_str()))
-		return false;
-	if (!WriteText("Source-Agent: NTRIP UM98/ESP32_T_Display_S3\r\n"))
-		return false;
-	if (!WriteText("STR: \r\n"))
+	// Connect with a bounded time out
+	phaseStart = millis();
+	int status = client.connect(address, login.Port, NTRIP_CONNECT_TIMEOUT_MS);
+	unsigned long connectTime = millis() - phaseStart;
+	LogInfo(LogNtripModule(_index), "RTK %s (%s) Connect status %d", host, address.toString().c_str(), status);
+
+	if (!client.connected())
+	{
+		LogError(LogNtripModule(_index), "E500 - RTK %s Not connected %d. Resolve %lums, connect %lums", host, status, resolveTime, connectTime);
+
+		// The address may have moved so look it up again
+		_dnsCache.Invalidate(host);
 		return false;
-	if (!WriteText("\r\n"))
+	}
+
+	// Apply the caster's socket options and see what buffer lwIP gave us
+	std::string failed = login.Tuning.Apply(client.fd());
+	if (!failed.empty())
+		LogError(LogNtripModule(_index), "E505 - RTK %s Socket options refused :%s", host, failed);
+	if (&client == &_client)
+	{
+		int sendBuffer = 0;
+		socklen_t optionLength = sizeof(sendBuffer);
+		_sendBufferSize = lwip_getsockopt(client.fd(), SOL_SOCKET, SO_SNDBUF, &sendBuffer, &optionLength) == 0 ? sendBuffer : -1;
+	}
+
+	// Encrypt before any credentials are sent
+	if (login.Tls)
+	{
+		std::string error = client.StartTls(host, NTRIP_TLS_TIMEOUT_MS, login.TlsPin);
+		if (!error.empty())
+		{
+			LogError(LogNtripModule(_index), "E506 - RTK %s TLS failed. %s", host, error);
+			client.stop();
+			return false;
+		}
+		LogInfo(LogNtripModule(_index), "TLS %s %s in %lums using %d bytes. Certificate %s", host,
+				client.GetResumed() ? "resumed" : "full handshake", client.GetHandshakeTime(), client.GetHeapUsed(),
+				client.GetFingerprint());
+	}
+
+	phaseStart = millis();
+	bool ok = (login.NtripVersion == 2) ? HandshakeNtrip2(client, reply, login) : HandshakeNtrip1(client, login);
+	unsigned long handshakeTime = millis() - phaseStart;
+
+	LogInfo(LogNtripModule(_index), "Connected %s %s. Resolve %lums, connect %lums, handshake %lums",
+			host, ok ? "OK" : "FAILED", resolveTime, connectTime, handshakeTime);
+	return ok;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Keep the standby connection up and drain anything the caster sends on it
+// .. The connection is made by the standby task so a slow or dead standby
+// .. never holds up sending. Call from the caster task
+void NTRIPServer::MaintainStandby()
+{
+	if (_sStandby.empty() || WiFi.status() != WL_CONNECTED || _status == ConnectionState::Rejected)
+	{
+		StopStandby();
+		return;
+	}
+
+	switch (_standbyState.load())
+	{
+	case StandbyState::Idle:
+		// The standby slot holds whichever host is not active
+		_standbyHost = (_activeHost == _sStandby) ? _sAddress : _sStandby;
+		_standbyLogin = MakeLogin(_standbyHost);
+		if (_standbyTask == NULL)
+			xTaskCreatePinnedToCore(
+				StandbyTaskWrapper,
+				StringPrintf("NtripStbyTask%d", _index).c_str(), // Task name
+				_tls ? NTRIP_TLS_TASK_STACK : NTRIP_TASK_STACK,	 // Stack size (bytes)
+				this,											 // Parameter
+				1,												 // Task priority
+				&_standbyTask,									 // Task handle
+				APP_CPU_NUM);
+		_standbyState.store(StandbyState::Wanted);
+		break;
+
+	case StandbyState::Ready:
+	{
+		// The caster may refuse an NTRIP 1.0 standby after the handshake (Mount point taken)
+		auto result = ReceiveReply(_standby, _standbyReply, _standbyHost);
+		if (result == CasterReply::Result::Rejected || result == CasterReply::Result::Failed)
+			LogError(LogNtripModule(_index), "E508 - Standby %s refused '%s'", _standbyHost, _standbyReply.GetReason());
+		else if (_standby.connected())
+			break;
+		_standby.stop();
+		_standbyState.store(StandbyState::Wanted);
+		break;
+	}
+
+	default:
+		// The standby task has it
+		break;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Connect the standby when the caster task asks for it
+// .. Runs beside the caster task. Only uses cached addresses
+void NTRIPServer::StandbyTaskFunction()
+{
+	while (true)
+	{
+		vTaskDelay(NTRIP_STANDBY_POLL_MS / portTICK_PERIOD_MS);
+
+		// Don't hammer a standby that is down
+		unsigned long attempt = _standbyAttempt.load();
+		if (attempt != 0 && (millis() - attempt) < NTRIP_STANDBY_RETRY_MS)
+			continue;
+		auto wanted = StandbyState::Wanted;
+		if (!_standbyState.compare_exchange_strong(wanted, StandbyState::Connecting))
+			continue;
+		_standbyAttempt = max(millis(), 1UL);
+
+		_standby.stop();
+		bool ok = OpenConnection(_standby, _standbyReply, _standbyLogin, 0);
+		if (!ok)
+		{
+			// A refused standby must not stop the working connection
+			if (_standbyReply.GetResult() == CasterReply::Result::Rejected)
+				LogError(LogNtripModule(_index), "E508 - Standby %s refused '%s'", _standbyLogin.Host, _standbyReply.GetReason());
+			_standby.stop();
+		}
+		_standbyStackHeight = uxTaskGetStackHighWaterMark(NULL);
+
+		// Hand over to the caster task unless it no longer wants the connection
+		auto connecting = StandbyState::Connecting;
+		if (!_standbyState.compare_exchange_strong(connecting, ok ? StandbyState::Ready : StandbyState::Wanted))
+		{
+			_standby.stop();
+			_standbyState.store(StandbyState::Idle);
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Drop the standby connection. Call from the caster task
+// .. One being connected is dropped by the standby task when it finishes
+void NTRIPServer::StopStandby()
+{
+	_standbyAttempt = 0;
+	while (true)
+	{
+		auto state = _standbyState.load();
+		auto next = StandbyState::Idle;
+		switch (state)
+		{
+		case StandbyState::Idle:
+		case StandbyState::Cancel:
+			return;
+		case StandbyState::Ready:
+			// Only this task leaves Ready
+			_standby.stop();
+			_standbyState.store(StandbyState::Idle);
+			return;
+		case StandbyState::Wanted:
+			next = StandbyState::Idle;
+			break;
+		case StandbyState::Connecting:
+			next = StandbyState::Cancel;
+			break;
+		}
+		if (_standbyState.compare_exchange_strong(state, next))
+			return;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Promote the standby connection after the active one failed
+// .. Returns false if there is no standby ready to take over
+bool NTRIPServer::Failover(const char *reason, unsigned long startMs)
+{
+	if (_standbyState.load() != StandbyState::Ready || !_standby.connected())
 		return false;
+
+	LogWarn(LogNtripModule(_index), "Failover from %s to %s (%s)", _activeHost, _standbyHost, reason);
+	_client.stop();
+	std::swap(_client, _standby);
+	std::swap(_activeHost, _standbyHost);
+	std::swap(_reply, _standbyReply);
+	_failovers++;
+	_health.RecordDisconnect(millis());
+	_health.OnConnectResult(true, millis());
+	_failoverStart = max(startMs, 1UL);
+	_afterReconnect = true;
+
+	// Bring the failed host back as the new standby
+	_standbyAttempt = 0;
+	_standbyState.store(StandbyState::Idle);
 	return true;
 }
 
-bool NTRIPServer::WriteText(const char *str)
+////////////////////////////////////////////////////////////////////////////////
+// NTRIP 1.0 upload. The caster reply is picked up by ConnectedProcessingReceive
+bool NTRIPServer::HandshakeNtrip1(CasterLink &client, const CasterLogin &login)
+{
+	return WriteText(client, NtripRequest::Source(login.Password, login.Credential).c_str());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// NTRIP 2.0 upload using HTTP POST with chunked transfer
+// .. Waits for the caster status. The caller handles a rejection
+bool NTRIPServer::HandshakeNtrip2(CasterLink &client, CasterReply &reply, const CasterLogin &login)
+{
+	const std::string &host = login.Host;
+	if (!WriteText(client, NtripRequest::Post(login.Credential, host, login.Port, login.User, login.Password).c_str()))
+		return false;
+
+	// Wait for the caster to accept the upload
+	unsigned long start = millis();
+	auto result = CasterReply::Result::None;
+	while (result == CasterReply::Result::None && (millis() - start) < NTRIP_REPLY_TIMEOUT_MS && client.connected())
+	{
+		result = ReceiveReply(client, reply, host);
+		if (result == CasterReply::Result::None)
+			vTaskDelay(10 / portTICK_PERIOD_MS);
+	}
+	if (result == CasterReply::Result::Accepted)
+		return true;
+
+	client.stop();
+	if (result == CasterReply::Result::None)
+		LogError(LogNtripModule(_index), "E503 - %s No reply to upload", host);
+	else if (result == CasterReply::Result::Failed)
+		LogError(LogNtripModule(_index), "E503 - %s Upload refused '%s'", host, reply.GetReason());
+	return false;
+}
+
+bool NTRIPServer::WriteText(CasterLink &client, const char *str)
 {
 	if (str == NULL)
 		return true;
 
-	std::string message = StringPrintf("    -> '%s'", str);
+	std::string message = str;
 	ReplaceCrLfEncode(message);
-	LogX(message);
+	LogInfo(LogNtripModule(_index), "    -> '%s'", message);
 
 	size_t len = strlen(str);
-	size_t written = _client.write((const uint8_t *)str, len);
+	size_t written = client.write((const uint8_t *)str, len);
+	if (&client == &_standby)
+		_standbySent.fetch_add(written, std::memory_order_relaxed);
+	else
+		_bandwidth.AddSent(written);
+	_metrics.Add(Metric::CasterBytesSent, _index, written);
 	if (len == written)
 		return true;
 
 	// Failed to write
-	LogX(StringPrintf("Write failed %s", _sAddress.c_str()));
+	LogError(LogNtripModule(_index), "Write failed");
 	return false;
 }
 
@@ -392,6 +1026,8 @@ const char *NTRIPServer::GetStatus() const
 		return "Disconnected";
 	case ConnectionState::Disabled:
 		return "Disabled";
+	case ConnectionState::Rejected:
+		return "Rejected";
 	default:
 		return "Unknown";
 	}
@@ -402,90 +1038,91 @@ const char *NTRIPServer::GetStatus() const
 // If memory allocation for QueueData fails, the method returns false.
 bool NTRIPServer::EnqueueData(const byte *pBytes, int length)
 {
-	// Don't queue if disabled
-	if (_status == ConnectionState::Disabled)
+	// Don't queue if disabled, the caster refused us or the quota is used up
+	if (_status == ConnectionState::Disabled || _status == ConnectionState::Rejected || _quotaState == QuotaState::Paused)
+		return false;
+
+	// Create queue item
+	QueueData *pItem = new (std::nothrow) QueueData(pBytes, length);
+	if (pItem == nullptr)
+	{
+		// Memory allocation failed
+		LogError(LogNtripModule(_index), "Failed to allocate memory for QueueData");
 		return false;
+	}
+	pItem->SetDeadline(_deadlines[pItem->getClass()]);
+
+	// Over quota the reduced message set only sends every few MSM epochs
+	// .. Decided on GPS time so each GNSS of an epoch is kept or dropped together
+	if (_quotaState == QuotaState::Reduced && pItem->getClass() == RtcmClassMsm && (pItem->getGpsSecond() % NTRIP_QUOTA_MSM_INTERVAL_S) != 0)
+	{
+		_quotaDrops++;
+		delete pItem;
+		return true;
+	}
+
+	LogVerbose(LogNtripModule(_index), "RTCM %d queued %d bytes", pItem->getType(), length);
 
 	// Lock the queue mutex
 	if (xSemaphoreTake(_queMutex, portMAX_DELAY))
 	{
-		bool overflowed = false;
-		while (_dataQueue.size() > 20)
-		{
-			overflowed = true;
-			_overflowSetSize++;
-			// Don't count dumps when not connected
-			// if (_status != ConnectionState::Connected)
-			_queueOverflows++;
-			QueueData *pOldItem = _dataQueue[0];
-			// LogX(StringPrintf("Queue %d overflow %d bytes", _index, pOldItem->getLength()));
-			_dataQueue.erase(_dataQueue.begin());
-			delete pOldItem;
-		}
+		// Drop the least useful items till we are back under the limits
+		int dropped = _queue.Push(pItem, [this](QueueData *pOldItem)
+								  {
+									  _metrics.Add(Metric::CasterQueueOverflows, _index, 1);
+									  _classDrops[pOldItem->getClass()]++;
+									  RecordLost(pOldItem, false); });
+		_overflowSetSize += dropped;
 
 		// Log the number of overflows
-		if (!overflowed && _overflowSetSize > 0)
+		if (dropped == 0 && _overflowSetSize > 0)
 		{
-			LogX(StringPrintf("Queue %d overflow %d", _index, _overflowSetSize), false);
+			LogBLocal("Queue %d overflow %d", _index, _overflowSetSize);
 			_overflowSetSize = 0;
 		}
 
-		// Create queue item
-		QueueData *pItem = new (std::nothrow) QueueData(pBytes, length);
-		if (pItem == nullptr)
-		{
-			// Memory allocation failed
-			LogX("Failed to allocate memory for QueueData");
-			xSemaphoreGive(_queMutex);
-			return false;
-		}
-		_dataQueue.push_back(pItem);
-
+		_metrics.Set(Metric::CasterQueueBytes, _index, (int32_t)_queue.GetBytes());
 		xSemaphoreGive(_queMutex);
 		return true;
 	}
 	else
 	{
-		LogX("Failed to take queue mutex");
+		LogError(LogNtripModule(_index), "Failed to take queue mutex");
+		delete pItem;
 		return false;
 	}
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-// Get the next item from the queue
-// Returns nullptr if the queue is empty.
-// WARNING : The caller is responsible for deleting the returned item.
-QueueData *NTRIPServer::DequeueData()
+// Record a frame that never reached the caster at its age in the latency
+// .. histograms so the tail is not hidden
+void NTRIPServer::RecordLost(const QueueData *pItem, bool expired)
 {
-	if (xSemaphoreTake(_queMutex, portMAX_DELAY))
-	{
-		while (_dataQueue.size() > 0)
-		{
-			QueueData *pItem = _dataQueue[0];
-			_dataQueue.erase(_dataQueue.begin());
-
-			// Check for null item (This should never happen)
-			if (pItem == nullptr)
-			{
-				LogX("DequeueData: Null item in queue");
-				continue;
-			}
+	uint32_t age = micros() - pItem->getQueuedMicros();
+	if (expired)
+		_queueLatency.RecordExpired(age);
+	else
+		_queueLatency.RecordDropped(age);
+	_metrics.Record(Metric::CasterQueueLatency, _index, age);
+}
 
-			// Check for expired items
-			if (pItem->IsExpired(500))
-			{
-				_expiredPackets++;
-				delete pItem;
-				continue;
-			}
+///////////////////////////////////////////////////////////////////////////////
+// Gather the next items from the queue into the batch, earliest deadline first
+// .. Frames that will miss their deadline by the time they are written are
+// .. dropped and counted (See SendQueue.h). Returns the number of items left
+int NTRIPServer::DequeueBatch(std::vector<QueueData *> &batch)
+{
+	batch.clear();
+	if (!xSemaphoreTake(_queMutex, portMAX_DELAY))
+		return 0;
 
-			// Return the item
-			xSemaphoreGive(_queMutex);
-			return pItem;
-		}
+	int remaining = _queue.DequeueBatch(batch, millis(), _sendEstimateUs / 1000, _sendBudget, [this](QueueData *pItem)
+										{
+											_metrics.Add(Metric::CasterExpiredPackets, _index, 1);
+											_expiredByClass[pItem->getClass()]++;
+											RecordLost(pItem, true); });
 
-		// Queue is empty
-		xSemaphoreGive(_queMutex);
-	}
-	return nullptr;
-}
\ No newline at end of file
+	_metrics.Set(Metric::CasterQueueBytes, _index, (int32_t)_queue.GetBytes());
+	xSemaphoreGive(_queMutex);
+	return remaining;
+}
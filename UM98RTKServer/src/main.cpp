@@ -42,6 +42,9 @@ void SaveBaseLocation(std::string newBaseLocation);
 #include <Web\WebPortal.h>
 #include "WiFiEvents.h"
 #include "History.h"
+#include "DnsCache.h"
+#include "Metrics.h"
+#include "LogLevel.h"
 
 WiFiManager _wifiManager;
 
@@ -52,6 +55,10 @@ unsigned long _lastLoopTime = 0;	  // Time of last loop
 int _loopPersSecondCount = 0;		  // Number of times the main loops runs in a second
 unsigned long _lastButtonPress = 0;	  // Time of last button press to turn off display on T-Display-S3
 History _history;					  // Temperature history
+DnsCache _dnsCache;					  // Cached caster addresses
+Metrics _metrics;					  // Counters, gauges and histograms
+WebRoutes _webRoutes;				  // Web route budgets and timing
+LogLevels _logLevels;				  // Log level of each module
 
 WebPortal _webPortal;
 
@@ -133,9 +140,12 @@ void setup(void)
 	else
 		Logln("E100 - File IO failed");
 	_myFiles.LoadString(_baseLocation, BASE_LOCATION_FILENAME);
+	_logLevels.FromString(_myFiles.LoadString(LOG_LEVELS_FILENAME));
+	_webRoutes.BudgetsFromString(_myFiles.LoadString(WEB_BUDGETS_FILENAME));
 
 	// Load the NTRIP server settings
 	tft.println("Setup NTRIP Connections");
+	_dnsCache.Setup();
 	_ntripServer0.LoadSettings();
 	_ntripServer1.LoadSettings();
 	_ntripServer2.LoadSettings();
@@ -189,10 +199,14 @@ void setup(void)
 
 	// Dump the file structure
 	_myFiles.StartupComplete();
+#ifdef LOG_TO_FLASH
+	_myFiles.StartLogWriter(GetMainLog());
+#endif
 
 	Logln("Setup complete");
 	Serial.println(" ========================== Setup done ========================== ");
 	_webPortal.SetupWiFi();
+	_webPortal.StartTask();
 
 	// Start the watch dog timer
 	esp_task_wdt_init(120, true); // 60 seconds timeout, panic on timeout
@@ -233,14 +247,18 @@ void loop()
 		// Check memory pressure
 		auto free = ESP.getFreeHeap();
 		auto total = ESP.getHeapSize();
+		_metrics.Set(Metric::HeapFree, (int32_t)free);
+		_metrics.Set(Metric::HeapMinFree, (int32_t)ESP.getMinFreeHeap());
+		_metrics.Set(Metric::WifiRssi, WiFi.status() == WL_CONNECTED ? WiFi.RSSI() : 0);
 
 		auto temperature = _history.CheckTemperatureLoop();
+		_metrics.Set(Metric::Temperature, (int32_t)temperature);
 
 		// Update the loop performance counter
 		Serial.printf("%s Loop %d G:%ld Heap:%d%% %.1f°C %s\n",
 					  _handyTime.LongString().c_str(),
 					  _loopPersSecondCount,
-					  _gpsParser.GetGpsBytesRec(),
+					  (long)_metrics.Get(Metric::GpsBytes),
 					  (int)(100.0 * free / total),
 					  temperature,
 					  WiFi.localIP().toString().c_str());
@@ -301,7 +319,6 @@ void loop()
 		_display.SetGpsConnected(_gpsParser.ReadDataFromSerial(Serial2));
 	else
 		_display.SetGpsConnected(false);
-	_webPortal.Loop();
 
 	// Update animations
 	_display.Animate();
@@ -375,7 +392,7 @@ bool IsWifiConnected()
 		Logln("E107 - WIFI connect timeout");
 		_display.RefreshWiFiState();
 		_lastWiFiConnected = millis();
-		_webPortal.SetupWiFi(); // Restart the web portal
+		_webPortal.RequestRestart(); // Restart the web portal (In the web task)
 	}
 
 	// Block here until we are connected again